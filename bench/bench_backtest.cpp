@@ -0,0 +1,78 @@
+#include "../include/backtest.h"
+#include "../include/SMA.h"
+#include "bench_data.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+
+// day-by-day loop: one signal lookup and a buy/sell branch per day
+static void BM_BacktestDayLoop(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    SMA sma(p, 5, 20);
+
+    for (auto _ : state) {
+        BacktestResult result {backtest_signal(p, 20, 1, sma.signal())};
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+// SIMD signal mask, then work proportional to the number of trades
+static void BM_BacktestTwoPhase(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    SMA sma(p, 5, 20);
+
+    for (auto _ : state) {
+        BacktestResult result {backtest_vectorized(p, 20, 1, sma.signal())};
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+// fees, slippage, percent sizing and next-bar fills: extra work per trade only
+static void BM_BacktestTwoPhaseWithCosts(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    SMA sma(p, 5, 20);
+    ExecutionModel execution;
+
+    execution.fee = 1;
+    execution.slippage_bps = 5;
+    execution.equity_percent = 50;
+    execution.delay = 1;
+
+    for (auto _ : state) {
+        BacktestResult result {backtest_vectorized(p, 20, 1, sma.signal(), execution)};
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+// long/short: one reversal per signal change, the side applied as a factor instead of a branch
+static void BM_BacktestTwoPhaseLongShort(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    SMA sma(p, 5, 20);
+    ExecutionModel execution;
+
+    execution.fee = 1;
+    execution.slippage_bps = 5;
+    execution.shorts = true;
+
+    for (auto _ : state) {
+        BacktestResult result {backtest_vectorized(p, 20, 1, sma.signal(), execution)};
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+BENCHMARK(BM_BacktestDayLoop)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BacktestTwoPhase)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BacktestTwoPhaseWithCosts)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BacktestTwoPhaseLongShort)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,44 @@
+#include "../include/compose.h"
+#include "../include/backtest.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include "bench_data.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+
+// SMA AND MACD backtest through the runtime Strategy interface: two virtual, bounds-checked calls per day
+static void BM_CombinedVirtual(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    SMA sma(p);
+    MACD macd(p);
+    const Strategy* strategies[] {&sma, &macd};
+
+    for (auto _ : state) {
+        BacktestResult result {backtest_signal(p, 200, 1, [&](int day) {
+            return strategies[0]->indicator(day) && strategies[1]->indicator(day);
+        })};
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+// the same backtest with the signals composed at compile time
+static void BM_CombinedComposed(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    SMA sma(p);
+    MACD macd(p);
+
+    for (auto _ : state) {
+        BacktestResult result {backtest_signal(p, 200, 1, all_of_signals(sma.signal(), macd.signal()))};
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+BENCHMARK(BM_CombinedVirtual)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_CombinedComposed)->RangeMultiplier(10)->Range(1000, 1000000);
@@ -0,0 +1,59 @@
+#ifndef BENCH_DATA_H
+#define BENCH_DATA_H
+
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// synthetic random-walk closing prices, the same series for the same (n, seed)
+inline std::vector<double> random_walk(int n, unsigned seed=42) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 1.0);
+    std::vector<double> p(n);
+    double price {100.0};
+
+    for (int i = 0; i < n; i++) {
+        price += step(rng);
+        if (price < 1.0) price = 1.0;
+        p[i] = price;
+    }
+
+    return p;
+}
+
+// write prices as a temp.csv-style file (one close per line), returning its size in bytes
+inline std::size_t write_price_csv(const std::string& path, const std::vector<double>& prices) {
+    std::ofstream out(path);
+
+    out.precision(17);
+
+    for (double price : prices) out << price << "\n";
+
+    return out.tellp();
+}
+
+inline std::string bench_path(int n) {
+    return "/tmp/trading_sim_bench_" + std::to_string(n) + ".csv";
+}
+
+// series sizes for the scaling benchmarks: 1e3, 1e4, ... up to $BENCH_MAX_POINTS (default 1e6)
+// 1e8 points needs roughly 5 GB of memory for the MACD buffers and 2 GB of disk for the CSV
+inline std::vector<int> bench_sizes() {
+    long long max_points {1000000};
+
+    if (const char* env = std::getenv("BENCH_MAX_POINTS")) max_points = std::atoll(env);
+
+    std::vector<int> sizes;
+
+    for (long long n = 1000; n <= max_points && n <= 100000000; n *= 10) sizes.push_back(n);
+
+    return sizes;
+}
+
+
+#endif
@@ -0,0 +1,62 @@
+#include "../include/ema.h"
+#include "../include/MACD.h"
+#include "bench_data.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+
+static std::vector<int> span_range(int count) {
+    std::vector<int> spans;
+
+    for (int t = 2; t < 2 + count; t++) spans.push_back(t);
+
+    return spans;
+}
+
+
+// one ema_series pass per span, keeping every series alive like a sweep does
+static void BM_EmaPerSpan(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    std::vector<int> spans {span_range(state.range(1))};
+
+    for (auto _ : state) {
+        std::vector<std::vector<double>> emas;
+
+        for (int t : spans) emas.push_back(ema_series(p, t));
+
+        benchmark::DoNotOptimize(emas.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size() * spans.size());
+}
+
+
+// all spans in one SIMD pass
+static void BM_BatchEma(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    std::vector<int> spans {span_range(state.range(1))};
+
+    for (auto _ : state) {
+        std::vector<double> ema {batch_ema(p, spans)};
+        benchmark::DoNotOptimize(ema.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size() * spans.size());
+}
+
+
+static void BM_MACDConstructor(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+
+    for (auto _ : state) {
+        MACD macd(p);
+        benchmark::DoNotOptimize(&macd);
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+BENCHMARK(BM_EmaPerSpan)->ArgsProduct({{10000, 1000000}, {1, 64}});
+BENCHMARK(BM_BatchEma)->ArgsProduct({{10000, 1000000}, {1, 64}});
+BENCHMARK(BM_MACDConstructor)->RangeMultiplier(10)->Range(1000, 1000000);
@@ -0,0 +1,59 @@
+#include "../include/series_cache.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include "../include/RSI.h"
+#include "../include/Bollinger.h"
+#include "../include/EMACross.h"
+#include "../include/ATR.h"
+#include "bench_data.h"
+#include <benchmark/benchmark.h>
+#include <deque>
+#include <vector>
+
+
+// a combined run whose strategies overlap: SMA 20/50 and Bollinger 20 both need the 20-day mean,
+// MACD 12/26 and the EMA crossover both need the 12 and 26 EMAs, RSI and ATR need their own
+template <typename NextCache>
+static void build_all(NextCache next) {
+    SMA sma(next(), 20, 50);
+    Bollinger bollinger(next(), 20);
+    MACD macd(next(), 12, 26);
+    EMACross cross(next(), 12, 26);
+    RSI rsi(next(), 14);
+    ATR atr(next(), 14);
+
+    benchmark::DoNotOptimize(sma.signal());
+    benchmark::DoNotOptimize(atr.signal());
+}
+
+
+// one cache for every strategy: each distinct window statistic is computed once
+static void BM_IndicatorsSharedCache(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+
+    for (auto _ : state) {
+        SeriesCache cache {close_only(p)};
+
+        build_all([&]() -> SeriesCache& { return cache; });
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+// a cache per strategy, as if each computed its own windows
+static void BM_IndicatorsSeparateCaches(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+
+    for (auto _ : state) {
+        std::deque<SeriesCache> caches;
+
+        build_all([&]() -> SeriesCache& { return caches.emplace_back(close_only(p)); });
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+BENCHMARK(BM_IndicatorsSharedCache)->Arg(1260)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_IndicatorsSeparateCaches)->Arg(1260)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
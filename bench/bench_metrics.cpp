@@ -0,0 +1,50 @@
+#include "../include/metrics.h"
+#include "../include/SMA.h"
+#include "bench_data.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+
+// a sweep-sized run: SMA 5/20 mask on a random walk
+static std::vector<std::uint8_t> sma_mask(const std::vector<double>& p) {
+    std::vector<std::uint8_t> mask(p.size());
+
+    fill_signals(SMA(p, 5, 20).signal(), 20, p.size(), mask.data());
+
+    return mask;
+}
+
+
+// new buffers for every run, as a sweep task would without an arena
+static void BM_MetricsFreshBuffers(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    std::vector<std::uint8_t> mask {sma_mask(p)};
+
+    for (auto _ : state) {
+        MetricsArena arena;
+        Metrics m {compute_metrics(p, 20, 1, mask.data(), {}, arena)};
+        benchmark::DoNotOptimize(m);
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+// one arena reused by every run: no allocation after the first
+static void BM_MetricsArena(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    std::vector<std::uint8_t> mask {sma_mask(p)};
+    MetricsArena arena;
+
+    for (auto _ : state) {
+        Metrics m {compute_metrics(p, 20, 1, mask.data(), {}, arena)};
+        benchmark::DoNotOptimize(m);
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+BENCHMARK(BM_MetricsFreshBuffers)->Arg(1260)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MetricsArena)->Arg(1260)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,103 @@
+#include "../include/precision.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include "bench_data.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+
+// 1e3 .. $BENCH_MAX_POINTS points (BENCH_MAX_POINTS=100000000 for tick-sized series)
+static void scaling(benchmark::internal::Benchmark* b) {
+    for (int n : bench_sizes()) b->Arg(n);
+
+    b->Unit(benchmark::kMillisecond);
+}
+
+// prices stored as T (double prices are used as they are)
+template <typename T>
+static std::vector<T> stored_prices(const std::vector<double>& p) {
+    if constexpr (std::is_same_v<T, double>) return p;
+    else return to_precision<T>(p);
+}
+
+
+// one compare pass over two stored series: memory-bound on long series, so its cost follows the bytes
+// per value (8 for double and cents, 4 for float)
+template <typename T>
+static void BM_PrecisionMask(benchmark::State& state) {
+    std::vector<T> a {stored_prices<T>(random_walk(state.range(0), 1))};
+    std::vector<T> b {stored_prices<T>(random_walk(state.range(0), 2))};
+    std::vector<std::uint8_t> mask(a.size());
+
+    for (auto _ : state) {
+        greater_mask(a.data(), b.data(), 0, a.size(), mask.data());
+        benchmark::DoNotOptimize(mask.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * 2 * a.size() * sizeof(T));
+}
+
+
+// SMA 50/200 decisions from stored prices: the double strategy against the precision kernels
+template <typename T>
+static void BM_PrecisionSMA(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    std::vector<T> q {stored_prices<T>(p)};
+    std::vector<std::uint8_t> mask(p.size());
+
+    for (auto _ : state) {
+        if constexpr (std::is_same_v<T, double>) {
+            SMA sma(p, 50, 200);
+
+            sma.fill(200, p.size(), mask.data());
+        } else {
+            std::vector<T> fast {precision_mean<T>(q, 50)};
+            std::vector<T> slow {precision_mean<T>(q, 200)};
+
+            greater_mask(fast.data(), slow.data(), 200, p.size(), mask.data());
+        }
+
+        benchmark::DoNotOptimize(mask.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+// MACD 12/26/9 signal-line decisions, the same way
+template <typename T>
+static void BM_PrecisionMACD(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    std::vector<T> q {stored_prices<T>(p)};
+    std::vector<std::uint8_t> mask(p.size());
+    MACD::Crossover mode {MACD::Crossover::signal_line};
+
+    for (auto _ : state) {
+        if constexpr (std::is_same_v<T, double>) {
+            MACD macd(p, 12, 26, 9, mode);
+
+            macd.fill(macd.first_signal_day(), p.size(), mask.data());
+        } else {
+            std::vector<T> line {precision_macd<T>(q, 12, 26, 9, mode)};
+
+            greater_mask(line.data(), nullptr, 34, p.size(), mask.data());
+        }
+
+        benchmark::DoNotOptimize(mask.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+BENCHMARK_TEMPLATE(BM_PrecisionMask, double)->Apply(scaling);
+BENCHMARK_TEMPLATE(BM_PrecisionMask, float)->Apply(scaling);
+BENCHMARK_TEMPLATE(BM_PrecisionMask, Cents)->Apply(scaling);
+BENCHMARK_TEMPLATE(BM_PrecisionSMA, double)->Apply(scaling);
+BENCHMARK_TEMPLATE(BM_PrecisionSMA, float)->Apply(scaling);
+BENCHMARK_TEMPLATE(BM_PrecisionSMA, Cents)->Apply(scaling);
+BENCHMARK_TEMPLATE(BM_PrecisionMACD, double)->Apply(scaling);
+BENCHMARK_TEMPLATE(BM_PrecisionMACD, float)->Apply(scaling);
+BENCHMARK_TEMPLATE(BM_PrecisionMACD, Cents)->Apply(scaling);
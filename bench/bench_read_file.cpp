@@ -0,0 +1,60 @@
+#include "../include/util.h"
+#include "bench_data.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+// reference: the previous ifstream + getline + std::stod loader
+static std::vector<double> read_file_getline(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::vector<double> prices;
+
+    while (std::getline(file, line)) {
+        try {
+            prices.push_back(std::stod(line));
+        }
+        catch (const std::exception&) {
+            throw std::runtime_error("Error: potentially corrupt data");
+        }
+    }
+
+    return prices;
+}
+
+
+static void BM_ReadFileGetline(benchmark::State& state) {
+    std::string path {bench_path(state.range(0))};
+    std::size_t bytes {write_price_csv(path, random_walk(state.range(0)))};
+
+    for (auto _ : state) {
+        std::vector<double> prices {read_file_getline(path)};
+        benchmark::DoNotOptimize(prices.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * bytes);
+    std::remove(path.c_str());
+}
+
+
+static void BM_ReadFileMapped(benchmark::State& state) {
+    std::string path {bench_path(state.range(0))};
+    std::size_t bytes {write_price_csv(path, random_walk(state.range(0)))};
+
+    for (auto _ : state) {
+        std::vector<double> prices {read_file(path)};
+        benchmark::DoNotOptimize(prices.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * bytes);
+    std::remove(path.c_str());
+}
+
+
+BENCHMARK(BM_ReadFileGetline)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReadFileMapped)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
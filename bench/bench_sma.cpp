@@ -0,0 +1,68 @@
+#include "../include/SMA.h"
+#include "../include/rolling.h"
+#include "bench_data.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+
+// reference: the previous SMA implementation, re-summing both windows on every call
+static bool naive_indicator(const std::vector<double>& p, int s, int l, int day) {
+    double short_sum {0};
+    double long_sum {0};
+
+    for (int i = day - s; i < day; i++) short_sum += p.at(i);
+    for (int i = day - l; i < day; i++) long_sum += p.at(i);
+
+    return (short_sum / s) > (long_sum / l);
+}
+
+
+static void BM_SMANaiveBacktest(benchmark::State& state) {
+    std::vector<double> p = random_walk(state.range(0));
+    int size = p.size();
+
+    for (auto _ : state) {
+        int buys {};
+
+        for (int i = 200; i < size; i++) buys += naive_indicator(p, 50, 200, i);
+
+        benchmark::DoNotOptimize(buys);
+    }
+
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+
+static void BM_SMARollingBacktest(benchmark::State& state) {
+    std::vector<double> p = random_walk(state.range(0));
+    int size = p.size();
+
+    for (auto _ : state) {
+        SMA sma(p);
+        int buys {};
+
+        for (int i = 200; i < size; i++) buys += sma.indicator(i);
+
+        benchmark::DoNotOptimize(buys);
+    }
+
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+
+static void BM_RollingMean(benchmark::State& state) {
+    std::vector<double> p = random_walk(state.range(0));
+    bool compensated = state.range(1);
+
+    for (auto _ : state) {
+        std::vector<double> avg = rolling_mean(p, 200, compensated);
+        benchmark::DoNotOptimize(avg.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+BENCHMARK(BM_SMANaiveBacktest)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_SMARollingBacktest)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_RollingMean)->ArgsProduct({{1000, 100000, 1000000}, {0, 1}});
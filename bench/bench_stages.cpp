@@ -0,0 +1,146 @@
+#include "../include/util.h"
+#include "../include/price_cache.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include "../include/simulator.h"
+#include "bench_data.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+
+// per-stage scaling suite: every stage of a single run, timed on its own for 1e3 .. $BENCH_MAX_POINTS
+// points so a regression shows up in the stage (and at the size) where it happened
+
+
+// swallow the simulator's report so only the backtest itself is timed
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+
+static void scaling(benchmark::internal::Benchmark* b) {
+    for (int n : bench_sizes()) b->Arg(n);
+
+    b->Unit(benchmark::kMillisecond);
+}
+
+
+// ingestion: parse the CSV (memory-mapped + from_chars)
+static void BM_StageReadFile(benchmark::State& state) {
+    std::string path {bench_path(state.range(0))};
+    std::size_t bytes {write_price_csv(path, random_walk(state.range(0)))};
+
+    for (auto _ : state) {
+        std::vector<double> prices {read_file(path)};
+        benchmark::DoNotOptimize(prices.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * bytes);
+    std::remove(path.c_str());
+}
+
+
+// ingestion: map an up-to-date binary cache
+static void BM_StageLoadCached(benchmark::State& state) {
+    std::string path {bench_path(state.range(0))};
+    write_price_csv(path, random_walk(state.range(0)));
+    load_prices(path);
+
+    for (auto _ : state) {
+        PriceSeries series {load_prices(path)};
+        benchmark::DoNotOptimize(series.prices().data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::remove(path.c_str());
+    std::remove(cache_path(path).c_str());
+}
+
+
+static void BM_StageSMAConstructor(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+
+    for (auto _ : state) {
+        SMA sma(p);
+        benchmark::DoNotOptimize(&sma);
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+// SMA::indicator for every day of an already constructed strategy
+static void BM_StageSMAIndicator(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    SMA sma(p);
+    int size = p.size();
+
+    for (auto _ : state) {
+        int buys {};
+
+        for (int i = sma.first_signal_day(); i < size; i++) buys += sma.indicator(i);
+
+        benchmark::DoNotOptimize(buys);
+    }
+
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+
+static void BM_StageMACDConstructor(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+
+    for (auto _ : state) {
+        MACD macd(p);
+        benchmark::DoNotOptimize(&macd);
+    }
+
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+static void BM_StageMACDIndicator(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    MACD macd(p);
+    int size = p.size();
+
+    for (auto _ : state) {
+        int buys {};
+
+        for (int i = macd.first_signal_day(); i < size; i++) buys += macd.indicator(i);
+
+        benchmark::DoNotOptimize(buys);
+    }
+
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+
+// Simulator::backtest with both strategies and buy-and-hold, as a default run does
+static void BM_StageSimulatorBacktest(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    SMA sma(p);
+    MACD macd(p);
+    Simulator sim(sma, macd, p);
+    NullBuffer null;
+    std::streambuf* saved {std::cout.rdbuf(&null)};
+
+    for (auto _ : state) sim.backtest(1);
+
+    std::cout.rdbuf(saved);
+    state.SetItemsProcessed(state.iterations() * p.size());
+}
+
+
+BENCHMARK(BM_StageReadFile)->Apply(scaling);
+BENCHMARK(BM_StageLoadCached)->Apply(scaling);
+BENCHMARK(BM_StageSMAConstructor)->Apply(scaling);
+BENCHMARK(BM_StageSMAIndicator)->Apply(scaling);
+BENCHMARK(BM_StageMACDConstructor)->Apply(scaling);
+BENCHMARK(BM_StageMACDIndicator)->Apply(scaling);
+BENCHMARK(BM_StageSimulatorBacktest)->Apply(scaling);
@@ -0,0 +1,27 @@
+#include "../include/stream.h"
+#include "bench_data.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+
+// per-tick cost of updating both live indicators
+static void BM_StreamingTick(benchmark::State& state) {
+    std::vector<double> p {random_walk(1 << 16)};
+    StreamingSMA sma;
+    StreamingMACD macd;
+    std::size_t i {0};
+
+    for (auto _ : state) {
+        sma.push(p[i]);
+        macd.push(p[i]);
+        benchmark::DoNotOptimize(sma.ready() && sma.signal());
+        benchmark::DoNotOptimize(macd.ready() && macd.signal());
+
+        if (++i == p.size()) i = 0;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+
+BENCHMARK(BM_StreamingTick);
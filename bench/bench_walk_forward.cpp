@@ -0,0 +1,44 @@
+#include "../include/walk_forward.h"
+#include "bench_data.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+
+static const WalkForwardOptions options {504, 126, 0, false};
+
+
+// one sweep per train window: every fold recomputes its averages, EMAs and signal masks
+static void BM_WalkForwardPerFoldSweep(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    std::vector<Fold> folds {walk_forward_folds(p.size(), options)};
+    ThreadPool pool(1);
+
+    for (auto _ : state) {
+        for (const Fold& fold : folds) {
+            PriceView train(p.data() + fold.train_begin, fold.train_end - fold.train_begin);
+            std::vector<SweepResult> results {sweep(train, {5, 50, 5}, {20, 200, 10}, 1, true, true, pool)};
+            benchmark::DoNotOptimize(results);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * folds.size());
+}
+
+
+// series and masks computed once for the whole history and shared by every fold
+static void BM_WalkForwardShared(benchmark::State& state) {
+    std::vector<double> p {random_walk(state.range(0))};
+    std::vector<Fold> folds {walk_forward_folds(p.size(), options)};
+    ThreadPool pool(1);
+
+    for (auto _ : state) {
+        std::vector<FoldResult> results {walk_forward(p, {5, 50, 5}, {20, 200, 10}, 1, true, true, options, pool)};
+        benchmark::DoNotOptimize(results);
+    }
+
+    state.SetItemsProcessed(state.iterations() * folds.size());
+}
+
+
+BENCHMARK(BM_WalkForwardPerFoldSweep)->Arg(1260)->Arg(5040)->Arg(20160)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_WalkForwardShared)->Arg(1260)->Arg(5040)->Arg(20160)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,40 @@
+#ifndef ATR_H
+#define ATR_H
+
+
+#include "strategy.h"
+#include "series_cache.h"
+#include <cstdint>
+#include <vector>
+
+
+// breakout entries with average-true-range stops: BUY once the close breaks above the highest close of
+// the previous `breakout` days, hold until it closes below the chandelier stop (highest high of the
+// last `period` days, the day's own included, minus `multiple` ATRs)
+// ATR is Wilder's smoothing of the true range (the cache's EMA of span 2 * period - 1); without
+// high/low columns the true range is the close-to-close change and the highs are closes
+class ATR : public Strategy {
+public:
+    using Signal = StateSignal;
+
+private:
+    double multiple;
+    int breakout;
+    std::vector<double> atr;            // ATR including the bar of `day`, 0 before it exists
+    std::vector<std::uint8_t> state;    // holding a position after the close of `day`
+
+public:
+    ATR(SeriesCache& cache, int period=14, double multiple=3, int breakout=20);
+
+    int first_signal_day() const;
+    bool indicator(int day=-1) const;
+    void fill(int begin, int end, std::uint8_t* out) const { signal().fill(begin, end, out); }
+
+    Signal signal() const { return {state.data()}; }
+    double value(int day=-1) const;
+    double get_multiple() const { return multiple; }
+    int get_breakout() const { return breakout; }
+};
+
+
+#endif
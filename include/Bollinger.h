@@ -0,0 +1,34 @@
+#ifndef BOLLINGER_H
+#define BOLLINGER_H
+
+
+#include "strategy.h"
+#include "series_cache.h"
+#include <cstdint>
+#include <vector>
+
+
+// Bollinger band mean reversion: BUY once the close falls below the lower band (mean - width * stdev
+// of the last `period` closes, the day's own included), hold until it closes above the mean
+class Bollinger : public Strategy {
+public:
+    using Signal = StateSignal;
+
+private:
+    double width;
+    std::vector<std::uint8_t> state;    // holding a position after the close of `day`
+
+public:
+    Bollinger(SeriesCache& cache, int period=20, double width=2);
+
+    // the first full window ends on this day
+    int first_signal_day() const { return long_term - 1; }
+    bool indicator(int day=-1) const;
+    void fill(int begin, int end, std::uint8_t* out) const { signal().fill(begin, end, out); }
+
+    Signal signal() const { return {state.data()}; }
+    double get_width() const { return width; }
+};
+
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef EMA_CROSS_H
+#define EMA_CROSS_H
+
+
+#include "strategy.h"
+#include "series_cache.h"
+#include <cstdint>
+#include <vector>
+
+
+// exponential moving average crossover: BUY while the short-term EMA is above the long-term one
+// (the sign of MACD's line, without a signal line; both share the cache's EMAs)
+class EMACross : public Strategy {
+public:
+    // unchecked, inlinable form of indicator(day) for compile-time composition (see compose.h)
+    struct Signal {
+        const double* spread;
+
+        bool operator()(int day) const { return spread[day] > 0; }
+
+        // out[day] = (*this)(day) for every day in [begin, end), SIMD (see backtest.h)
+        void fill(int begin, int end, std::uint8_t* out) const;
+    };
+
+private:
+    std::vector<double> spread;         // short EMA - long EMA, including the close of `day`
+
+public:
+    EMACross(SeriesCache& cache, int s=12, int l=26);
+
+    bool indicator(int day=-1) const;
+    void fill(int begin, int end, std::uint8_t* out) const { signal().fill(begin, end, out); }
+
+    Signal signal() const { return {spread.data()}; }
+};
+
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef HIGHER_TIMEFRAME_H
+#define HIGHER_TIMEFRAME_H
+
+
+#include "strategy.h"
+#include "series_cache.h"
+#include "resample.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+// a strategy on a coarser timeframe of the bars (i.e. a weekly SMA), asked about the original days:
+// each day follows the decision of the last coarse bar known by then, so a weekly close is acted on
+// from the last day of its week and never earlier
+// combined with strategies on the original bars (--combine, the vote) it gives multi-timeframe rules,
+// i.e. a weekly trend filter with daily MACD entries
+class HigherTimeframe : public Strategy {
+public:
+    using Signal = StateSignal;
+
+private:
+    std::shared_ptr<const Strategy> coarse;
+    Timeframe tf;
+    int first;
+    std::vector<std::uint8_t> state;    // decision applying to `day`
+
+public:
+    // `coarse` must be built on cache.timeframe(tf).cache; its periods count coarse bars
+    HigherTimeframe(SeriesCache& cache, const Timeframe& tf, std::shared_ptr<const Strategy> coarse);
+
+    int first_signal_day() const { return first; }
+    bool indicator(int day=-1) const;
+    void fill(int begin, int end, std::uint8_t* out) const { signal().fill(begin, end, out); }
+    bool needs_day_close() const { return coarse->needs_day_close(); }
+
+    Signal signal() const { return {state.data()}; }
+    const Strategy& get_coarse() const { return *coarse; }
+    const Timeframe& get_timeframe() const { return tf; }
+};
+
+
+#endif
@@ -3,20 +3,66 @@
 
 
 #include "strategy.h"
+#include "ema.h"
+#include "series_cache.h"
+#include <cstdint>
 #include <vector>
 
 
 class MACD : public Strategy {
+public:
+    // what the MACD line is compared against
+    enum class Crossover { zero_line, signal_line };
+
+    // unchecked, inlinable form of indicator(day) for compile-time composition (see compose.h)
+    // `line` is the histogram in signal-line mode and the MACD line otherwise, so both compare with 0
+    struct Signal {
+        const double* line;
+
+        bool operator()(int day) const { return line[day] > 0; }
+
+        // out[day] = (*this)(day) for every day in [begin, end), SIMD (see backtest.h)
+        void fill(int begin, int end, std::uint8_t* out) const;
+    };
+
 private:
+    int signal_term;
+    Crossover crossover_mode;
+    int signal_start;               // first day with a valid signal line (size if never)
+
+    // day-indexed buffers, allocated once in the constructor
     std::vector<double> short_ema;
     std::vector<double> long_ema;
+    std::vector<double> macd_line;
+    std::vector<double> signal_line;
+    std::vector<double> histogram;
+
+    void check_day(int day) const;
 
-    double seed(int t) const;
-    double ema(int t, int day=-1) const;
+    // MACD line, signal line and histogram from the two EMAs
+    void build_lines();
 
 public:
-    MACD(const std::vector<double>& p, int s=12, int l=26);
+    MACD(PriceView p, int s=12, int l=26, int sig=9, Crossover mode=Crossover::zero_line);
+    MACD(const BarsView& b, int s=12, int l=26, int sig=9, Crossover mode=Crossover::zero_line);
+    // EMAs shared with the other strategies of the cache (close EMAs)
+    MACD(SeriesCache& cache, int s=12, int l=26, int sig=9, Crossover mode=Crossover::zero_line);
     bool indicator(int day=-1) const;
+    void fill(int begin, int end, std::uint8_t* out) const { signal().fill(begin, end, out); }
+    int first_signal_day() const;
+
+    // +1 if the MACD line crossed above its reference on `day`, -1 if it crossed below, 0 otherwise
+    int crossover(int day=-1) const;
+
+    Signal signal() const {
+        return {(crossover_mode == Crossover::signal_line) ? histogram.data() : macd_line.data()};
+    }
+
+    int get_signal_term() const { return signal_term; }
+    Crossover get_crossover() const { return crossover_mode; }
+    PriceView get_macd_line() const { return macd_line; }
+    PriceView get_signal_line() const { return signal_line; }
+    PriceView get_histogram() const { return histogram; }
 };
 
 
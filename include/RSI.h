@@ -0,0 +1,41 @@
+#ifndef RSI_H
+#define RSI_H
+
+
+#include "strategy.h"
+#include "series_cache.h"
+#include <cstdint>
+#include <vector>
+
+
+// relative strength index mean reversion: BUY once RSI falls below `oversold`, hold until it rises
+// above `overbought`
+// average gains and losses use Wilder's smoothing (alpha = 1 / period), i.e. the cache's EMA of span
+// 2 * period - 1 over the close-to-close gains and losses
+class RSI : public Strategy {
+public:
+    using Signal = StateSignal;
+
+private:
+    double oversold;
+    double overbought;
+    std::vector<double> rsi;            // RSI including the close of `day`, 0 before first_signal_day()
+    std::vector<std::uint8_t> state;    // holding a position after the close of `day`
+
+    void check_day(int day) const;
+
+public:
+    RSI(SeriesCache& cache, int period=14, double oversold=30, double overbought=70);
+
+    int first_signal_day() const;
+    bool indicator(int day=-1) const;
+    void fill(int begin, int end, std::uint8_t* out) const { signal().fill(begin, end, out); }
+
+    Signal signal() const { return {state.data()}; }
+    double value(int day=-1) const;
+    double get_oversold() const { return oversold; }
+    double get_overbought() const { return overbought; }
+};
+
+
+#endif
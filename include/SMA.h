@@ -3,17 +3,40 @@
 
 
 #include "strategy.h"
+#include "series_cache.h"
+#include <cstdint>
 #include <vector>
 
 
 class SMA : public Strategy {
 private:
+    // rolling averages indexed by day (mean of the window ending before `day`)
+    std::vector<double> short_avg;
+    std::vector<double> long_avg;
+
     double short_term_avg(int day=-1) const;
     double long_term_avg(int day=-1) const;
 
 public:
-    SMA(const std::vector<double>& p, int s=50, int l=200);
+    // unchecked, inlinable form of indicator(day) for compile-time composition (see compose.h)
+    struct Signal {
+        const double* short_avg;
+        const double* long_avg;
+
+        bool operator()(int day) const { return short_avg[day] > long_avg[day]; }
+
+        // out[day] = (*this)(day) for every day in [begin, end), SIMD (see backtest.h)
+        void fill(int begin, int end, std::uint8_t* out) const;
+    };
+
+    SMA(PriceView p, int s=50, int l=200, bool compensated=true);
+    SMA(const BarsView& b, int s=50, int l=200, bool compensated=true);
+    // averages shared with the other strategies of the cache (close means)
+    SMA(SeriesCache& cache, int s=50, int l=200);
     bool indicator(int day=-1) const;
+    void fill(int begin, int end, std::uint8_t* out) const { signal().fill(begin, end, out); }
+    bool needs_day_close() const { return false; }
+    Signal signal() const { return {short_avg.data(), long_avg.data()}; }
 };
 
 #endif
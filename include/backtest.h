@@ -0,0 +1,172 @@
+#ifndef BACKTEST_H
+#define BACKTEST_H
+
+
+#include "price_view.h"
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+
+struct BacktestResult {
+    int transactions {};
+    double profit {};
+    double percent {};
+};
+
+
+// how trades are filled; the default is frictionless: every signal fills at that day's price for a
+// fixed number of shares, with no costs
+// a plain value read once per trade by the transition scan (never per day), so costs leave the
+// day-by-day part of a backtest untouched
+struct ExecutionModel {
+    double fee {0};                 // flat cost of every buy and every sell
+    double slippage_bps {0};        // buys fill this many basis points above the price, sells below
+    double equity_percent {0};      // > 0: each buy invests this percent of current equity in
+                                    // (fractional) shares instead of a fixed share count
+    double capital {100000};        // starting equity of equity_percent sizing
+    int delay {0};                  // days between a signal and its fill (1 = next bar)
+    bool shorts {false};            // SELL holds a short position instead of staying flat, so every
+                                    // signal change reverses the position (long <-> short)
+
+    // the default model: long only, no costs
+    bool frictionless() const { return fee == 0 && slippage_bps == 0 && equity_percent == 0 && delay == 0 && !shorts; }
+};
+
+// one round trip of a backtest: filled on entry_day, closed on exit_day
+struct Trade {
+    int entry_day {};
+    int exit_day {};
+    double entry_price {};          // fill prices, slippage included
+    double exit_price {};
+    double shares {};               // negative for a short: pnl is (exit - entry) * shares either way
+    double pnl {};                  // both fees included
+};
+
+
+// throws std::invalid_argument on negative costs or delay, slippage of 100% or more, or sizing outside (0, 100]%
+void check_execution_model(const ExecutionModel& execution);
+
+
+// simulate trading `stocks` shares on a buy/sell signal from start_day until the end of the data
+// signal(day) -> bool is inlined at the call site, so callers pick how the signal is produced
+// (virtual Strategy::indicator, a lambda over precomputed series, ...)
+template <typename Signal>
+BacktestResult backtest_signal(PriceView price, int start_day, int stocks, Signal signal) {
+    BacktestResult result;
+    int size = price.size();
+    bool bought {false};
+    double buy_price {};
+    double initial_buy {};
+    bool is_initial_buy {false};
+
+    for (int i = start_day; i < size; i++) {
+        bool decision = signal(i);
+
+        // detect buy move
+        if (decision && !bought) {
+            result.transactions++;
+            buy_price = price[i];
+            bought = true;
+
+            if (!is_initial_buy) {
+                is_initial_buy = true;
+                initial_buy = buy_price;
+            }
+        }
+
+        // detect sell move
+        if ((!decision && bought) || ((i == size - 1) && bought)) {
+            result.transactions++;
+            result.profit += (price[i] - buy_price) * stocks;
+            bought = false;
+        }
+    }
+
+    result.percent = ((result.profit / stocks) / initial_buy) * 100;
+
+    return result;
+}
+
+
+// ---- two-phase backtest ----
+// phase 1 turns a signal into a 0/1 byte per day in one pass (SSE2 compares for SMA / MACD signals);
+// phase 2 scans that mask 16 days at a time for BUY/SELL transitions and sums P&L over the trades
+// only, in the same order as backtest_signal, so both give bit-identical results
+
+// out[i] = a[i] > b[i] for i in [begin, end); b == nullptr compares with 0
+void greater_mask(const double* a, const double* b, int begin, int end, std::uint8_t* out);
+
+// the same for float series (8 days per two 4-lane compares) and fixed-point series (see precision.h)
+void greater_mask(const float* a, const float* b, int begin, int end, std::uint8_t* out);
+void greater_mask(const std::int64_t* a, const std::int64_t* b, int begin, int end, std::uint8_t* out);
+
+// days in [start_day, end) where the mask differs from the day before (flat before start_day)
+// these alternate BUY, SELL, BUY, ...; with shorts, start_day opens a position whatever the mask
+// appended to out, 16 days per step
+void find_transitions(const std::uint8_t* mask, int start_day, int end, std::vector<int>& out, bool shorts=false);
+
+// phase 2 over a 0/1 mask indexed by day (only [start_day, size) is read)
+BacktestResult backtest_mask(PriceView price, int start_day, int stocks, const std::uint8_t* mask);
+
+// phase 2 with fees, slippage, sizing and delayed fills applied to each trade
+// fills are shifted by execution.delay days (a buy that would fill after the last day is dropped) and
+// percent is the return on the first entry's cost, or on the starting capital with equity_percent sizing
+// with execution.shorts the position is long on mask days of 1 and short on days of 0 from start_day
+// on; each transition closes one trade and opens the opposite one at the same fill
+// a frictionless model gives exactly the 4-argument result
+BacktestResult backtest_mask(PriceView price, int start_day, int stocks, const std::uint8_t* mask,
+                             const ExecutionModel& execution);
+
+// the trades behind backtest_mask(price, start_day, stocks, mask, execution), in order
+// transitions is scratch space; both vectors are cleared first, so callers can reuse their capacity
+void trade_ledger(PriceView price, int start_day, int stocks, const std::uint8_t* mask,
+                  const ExecutionModel& execution, std::vector<int>& transitions, std::vector<Trade>& ledger);
+
+
+template <typename Signal, typename = void>
+struct has_fill : std::false_type {};
+
+template <typename Signal>
+struct has_fill<Signal, std::void_t<decltype(std::declval<const Signal&>().fill(0, 0, nullptr))>> : std::true_type {};
+
+// phase 1: signals with a fill() member (SMA::Signal, MACD::Signal) use their SIMD kernel,
+// anything else (combinators, lambdas) is evaluated inline day by day
+template <typename Signal>
+void fill_signals(const Signal& signal, int begin, int end, std::uint8_t* out) {
+    if constexpr (has_fill<Signal>::value) {
+        signal.fill(begin, end, out);
+    } else {
+        for (int i = begin; i < end; i++) out[i] = signal(i);
+    }
+}
+
+// same result as backtest_signal, computed in two phases
+template <typename Signal>
+BacktestResult backtest_vectorized(PriceView price, int start_day, int stocks, const Signal& signal,
+                                   const ExecutionModel& execution = {}) {
+    std::vector<std::uint8_t> mask(price.size());
+
+    fill_signals(signal, start_day, price.size(), mask.data());
+
+    return backtest_mask(price, start_day, stocks, mask.data(), execution);
+}
+
+
+// buy `stocks` shares on the first day and sell them on the last
+inline BacktestResult backtest_buy_and_hold(PriceView price, int stocks) {
+    BacktestResult result;
+    double buy_price {price.front()};
+
+    result.transactions = 2;
+    result.profit = (price.back() - buy_price) * stocks;
+    result.percent = ((result.profit / stocks) / buy_price) * 100;
+
+    return result;
+}
+
+// buy and hold under an execution model (bought on day execution.delay, sold on the last day; never short)
+BacktestResult backtest_buy_and_hold(PriceView price, int stocks, const ExecutionModel& execution);
+
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+
+#include "backtest.h"
+#include "thread_pool.h"
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+struct BatchReport {
+    std::string ticker;
+    std::string period;             // "start to end" taken from the file name, if present
+    std::string path;
+    std::string error;              // non-empty if the file could not be loaded or backtested
+    int days {};
+    bool sma_on {};
+    bool macd_on {};
+    BacktestResult sma;
+    BacktestResult macd;
+    BacktestResult bnh;
+};
+
+
+// resolve a batch spec into data files:
+//   directory        -> every TICKER_start_to_end.csv inside it
+//   glob pattern     -> matching files (i.e. data/MSFT_*.csv)
+//   comma list       -> the listed files
+std::vector<std::string> find_data_files(std::string_view spec);
+
+// split 'TICKER_start_to_end.csv' into ticker and period; other names use the file stem as ticker
+void parse_data_file_name(std::string_view path, std::string& ticker, std::string& period);
+
+// load (through the binary price cache if use_cache) and backtest every file concurrently
+// per-file failures are recorded in the report, not thrown
+std::vector<BatchReport> run_batch(const std::vector<std::string>& files, int stocks,
+                                   bool sma_on, bool macd_on, bool use_cache, ThreadPool& pool,
+                                   const ExecutionModel& execution = {});
+
+void print_batch(const std::vector<BatchReport>& reports, std::ostream& out);
+
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef COMPOSE_H
+#define COMPOSE_H
+
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+
+// compile-time strategy composition
+// a signal is any type with `bool operator()(int day) const` (i.e. SMA::Signal, MACD::Signal or a lambda);
+// the combinators below fold them with branch-free & / | / + so the backtest day loop is one
+// inlined expression with no virtual calls, optional checks or per-day strategy branches
+// callers must only ask about days every member signal is valid for (the max of their first days)
+
+
+template <typename... Signals>
+struct AllOf {
+    std::tuple<Signals...> signals;
+
+    bool operator()(int day) const {
+        return std::apply([day](const auto&... s) { return (static_cast<bool>(s(day)) & ...); }, signals);
+    }
+};
+
+
+template <typename... Signals>
+struct AnyOf {
+    std::tuple<Signals...> signals;
+
+    bool operator()(int day) const {
+        return std::apply([day](const auto&... s) { return (static_cast<bool>(s(day)) | ...); }, signals);
+    }
+};
+
+
+// BUY when more than half of the signals say BUY
+template <typename... Signals>
+struct Majority {
+    std::tuple<Signals...> signals;
+
+    bool operator()(int day) const {
+        int votes = std::apply([day](const auto&... s) { return (static_cast<int>(s(day)) + ...); }, signals);
+
+        return 2 * votes > static_cast<int>(sizeof...(Signals));
+    }
+};
+
+
+// signal(day - 1): a decision made on one bar's close, acted on at the next bar
+template <typename Signal>
+struct Lagged {
+    Signal signal;
+
+    bool operator()(int day) const { return signal(day - 1); }
+
+    // keeps the SIMD fill of the wrapped signal (out[day] = signal(day - 1))
+    template <typename S = Signal>
+    auto fill(int begin, int end, std::uint8_t* out) const -> decltype(std::declval<const S&>().fill(begin, end, out)) {
+        return signal.fill(begin - 1, end - 1, out + 1);
+    }
+};
+
+template <typename Signal>
+Lagged<Signal> lagged(Signal s) { return {s}; }
+
+
+template <typename... Signals>
+AllOf<Signals...> all_of_signals(Signals... s) { return {{s...}}; }
+
+template <typename... Signals>
+AnyOf<Signals...> any_of_signals(Signals... s) { return {{s...}}; }
+
+template <typename... Signals>
+Majority<Signals...> majority_of_signals(Signals... s) { return {{s...}}; }
+
+
+// runtime choice of combinator (i.e. from the command line), dispatched once to a compiled kernel
+enum class Combine { all, any, majority };
+
+inline Combine parse_combine(std::string_view name) {
+    if (name == "and") return Combine::all;
+    if (name == "or") return Combine::any;
+    if (name == "majority") return Combine::majority;
+
+    throw std::invalid_argument("Unknown combination '" + std::string(name) + "' (expected and, or or majority)");
+}
+
+inline const char* combine_name(Combine mode) {
+    switch (mode) {
+        case Combine::all: return "AND";
+        case Combine::any: return "OR";
+        default: return "MAJORITY";
+    }
+}
+
+// call fn with the combinator selected by mode; every branch is its own instantiation of fn
+template <typename Fn, typename... Signals>
+auto with_combination(Combine mode, Fn fn, Signals... s) {
+    switch (mode) {
+        case Combine::all: return fn(all_of_signals(s...));
+        case Combine::any: return fn(any_of_signals(s...));
+        default: return fn(majority_of_signals(s...));
+    }
+}
+
+
+#endif
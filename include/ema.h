@@ -0,0 +1,22 @@
+#ifndef EMA_H
+#define EMA_H
+
+
+#include "price_view.h"
+#include <vector>
+
+
+// exponential moving average of `p` seeded with the SMA of the first t values
+// result[day] is the EMA including p[day]; it is valid from day t - 1 (the seed), earlier entries are 0
+std::vector<double> ema_series(PriceView p, int t);
+
+// same as ema_series, written into a preallocated buffer of p.size() values
+void ema_into(PriceView p, int t, double* out);
+
+// EMAs of one series for many spans in a single pass over the prices
+// spans are evaluated in SIMD lanes (SSE2 when available), so sweeping many spans costs about one pass
+// returns a spans.size() x p.size() row-major matrix: row j is bit-for-bit ema_series(p, spans[j])
+std::vector<double> batch_ema(PriceView p, const std::vector<int>& spans);
+
+
+#endif
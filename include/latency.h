@@ -0,0 +1,39 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+
+#include <array>
+#include <cstdint>
+
+
+// fixed-size latency histogram (8 log-spaced buckets per power of two, ~9% resolution)
+// constant memory, so it can record every tick/request of a long-running process
+class LatencyStats {
+private:
+    static constexpr int SUB_BUCKETS {8};
+    static constexpr int BUCKETS {64 * SUB_BUCKETS};
+
+    std::array<std::uint64_t, BUCKETS> buckets {};
+    std::uint64_t samples {};
+    double total_ns {};
+    double max_ns {};
+    double min_ns {};
+
+    static int bucket_of(double ns);
+    static double bucket_upper(int bucket);
+
+public:
+    void record(double ns);
+    void merge(const LatencyStats& other);
+
+    std::uint64_t count() const { return samples; }
+    double mean_us() const { return (samples) ? total_ns / samples / 1000 : 0; }
+    double min_us() const { return min_ns / 1000; }
+    double max_us() const { return max_ns / 1000; }
+
+    // upper bound of the bucket holding the q-th quantile (0 < q <= 1), in microseconds
+    double percentile_us(double q) const;
+};
+
+
+#endif
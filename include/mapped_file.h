@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+
+#include <cstddef>
+#include <string_view>
+
+
+// read-only memory mapping of a whole file (RAII, move-only)
+class MappedFile {
+private:
+    const char* ptr {nullptr};
+    std::size_t length {};
+
+public:
+    explicit MappedFile(std::string_view file_name);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const char* data() const { return ptr; }
+    std::size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(ptr, length); }
+};
+
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+
+#include "backtest.h"
+#include <cstdint>
+#include <vector>
+
+
+// trading days per year, used to annualize Sharpe, Sortino and CAGR
+inline constexpr double TRADING_DAYS {252};
+
+
+// risk and return figures of one backtest, all from its daily mark-to-market equity curve
+// returns are relative to the starting equity: the starting capital with equity_percent sizing,
+// otherwise the first buy's cost (the base of BacktestResult::percent)
+struct Metrics {
+    int trades {};
+    double win_rate {};             // percent of trades with a profit
+    double exposure {};             // percent of days holding a position
+    double total_return {};         // percent
+    double cagr {};                 // compound annual growth rate, percent
+    double max_drawdown {};         // largest fall from an equity peak, percent of that peak
+    double sharpe {};               // annualized mean / stdev of the daily returns (risk-free rate 0)
+    double sortino {};              // annualized mean / downside deviation of the daily returns
+    double final_equity {};
+};
+
+
+// scratch buffers of metrics runs, reused from one run to the next
+// they are resized or cleared, never freed, so once they have grown to the longest series a thread
+// sees, a sweep over any number of configurations makes no allocations for its metrics
+struct MetricsArena {
+    std::vector<std::uint8_t> mask;
+    std::vector<int> transitions;
+    std::vector<Trade> ledger;          // trades of the last run
+    std::vector<double> equity;         // equity curve of the last run, one value per day from its start day
+};
+
+
+// trades of a 0/1 mask (as backtest_mask) into arena.ledger, then the equity curve into arena.equity
+// and every metric in one fused pass over the days
+Metrics compute_metrics(PriceView price, int start_day, int stocks, const std::uint8_t* mask,
+                        const ExecutionModel& execution, MetricsArena& arena);
+
+// compute_metrics of a signal, evaluated into arena.mask
+template <typename Signal>
+Metrics signal_metrics(PriceView price, int start_day, int stocks, const Signal& signal,
+                       const ExecutionModel& execution, MetricsArena& arena) {
+    arena.mask.resize(price.size());
+    fill_signals(signal, start_day, price.size(), arena.mask.data());
+
+    return compute_metrics(price, start_day, stocks, arena.mask.data(), execution, arena);
+}
+
+// metrics of buying on the first day and selling on the last (as backtest_buy_and_hold)
+Metrics buy_and_hold_metrics(PriceView price, int stocks, const ExecutionModel& execution, MetricsArena& arena);
+
+
+#endif
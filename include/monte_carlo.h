@@ -0,0 +1,153 @@
+#ifndef MONTE_CARLO_H
+#define MONTE_CARLO_H
+
+
+#include "backtest.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+enum class PathModel {bootstrap, gbm};
+
+// 'bootstrap' or 'gbm'; throws std::invalid_argument otherwise
+PathModel parse_model(std::string_view name);
+
+
+struct MonteCarloOptions {
+    int paths {1000};
+    PathModel model {PathModel::bootstrap};
+    int block {20};                 // bootstrap block length in days
+    std::uint64_t seed {42};
+    int batch {64};                 // paths generated and evaluated by one task
+};
+
+
+// synthetic price paths with the statistics of a real series, starting at its first price
+//   bootstrap: the day-over-day returns resampled in blocks of consecutive days (keeps short-range
+//              autocorrelation and volatility clustering)
+//   gbm:       geometric Brownian motion with the drift and volatility of the log returns
+class PathGenerator {
+private:
+    double first {};
+    std::vector<double> ratios;     // price[i] / price[i - 1]
+    double drift {};                // mean daily log return
+    double volatility {};           // standard deviation of the daily log returns
+    PathModel model;
+    int block;
+
+public:
+    PathGenerator(PriceView price, PathModel m, int b=20);
+
+    double get_drift() const { return drift; }
+    double get_volatility() const { return volatility; }
+
+    // write one path of ratios.size() + 1 prices to out
+    void generate(std::mt19937_64& rng, double* out) const;
+};
+
+
+// seed of task `index`: the same seed and batch size give the same paths on any number of threads
+std::uint64_t task_seed(std::uint64_t seed, std::uint64_t index);
+
+
+struct Distribution {
+    double mean {};
+    double stdev {};
+    double min {};
+    double p5 {};
+    double median {};
+    double p95 {};
+    double max {};
+};
+
+// summary of a sample (sorted in place); all zero for an empty sample
+Distribution summarize(std::vector<double>& values);
+
+
+// summary of a stream of values in fixed memory, for any number of paths: count, mean and variance
+// (merged pairwise), extremes, and a histogram of SUMMARY_BINS equal bins over [low, high) (plus one
+// below and one above it) keeping each bin's count and lowest and highest value for the percentiles
+// a percentile is off by at most the spread of the bin it falls in; repeated values come out exact
+class SampleSummary {
+private:
+    struct Bin {
+        std::uint64_t count {};
+        double low {};
+        double high {};
+    };
+
+    double lower;
+    double width;
+    std::vector<Bin> bins;                  // below the range, SUMMARY_BINS, above the range
+    std::uint64_t n {};
+    double mean {};
+    double m2 {};                           // sum of squared differences from the mean
+    double min {};
+    double max {};
+
+    // the value of rank i (0-based) of the sample, read from the histogram
+    double value_at(std::uint64_t i) const;
+
+public:
+    static constexpr int SUMMARY_BINS {512};
+
+    // throws std::invalid_argument unless low < high
+    SampleSummary(double low, double high);
+
+    void add(double x);
+
+    // fold in the values of `other`, which must have the same range
+    void merge(const SampleSummary& other);
+
+    std::uint64_t count() const { return n; }
+
+    // as summarize: sample standard deviation and interpolated 5% / median / 95%
+    Distribution distribution() const;
+};
+
+
+struct MonteCarloStrategy {
+    std::string strategy;           // "SMA", "MACD" or "Buy and hold"
+    BacktestResult actual;          // on the real series
+    Distribution profit;
+    Distribution transactions;
+    double win_rate {};             // share of paths with a profit
+    double beat_actual {};          // share of paths doing at least as well as the real series
+};
+
+
+struct MonteCarloReport {
+    std::string ticker;
+    std::string period;
+    std::string path;
+    std::string error;              // non-empty if the file could not be loaded or simulated
+    int days {};
+    std::vector<MonteCarloStrategy> strategies;
+};
+
+
+// backtest the enabled strategies (default periods) and buy and hold on options.paths synthetic
+// paths of one series
+// paths are generated and evaluated batch by batch on the pool, each task with its own seeded RNG and
+// one reused path and indicator buffer; each task's results go into SampleSummary totals (ranges set by
+// the first batch) folded in task order, a few waves of tasks at a time, so memory does not grow with
+// the number of paths and the report is the same on any number of threads
+MonteCarloReport monte_carlo(PriceView price, int stocks, bool sma_on, bool macd_on,
+                             const MonteCarloOptions& options, ThreadPool& pool,
+                             const ExecutionModel& execution = {});
+
+// load every file (through the binary price cache if use_cache) and run monte_carlo on it, one file at a time
+// per-file failures are recorded in the report, not thrown
+std::vector<MonteCarloReport> run_monte_carlo(const std::vector<std::string>& files, int stocks, bool sma_on,
+                                              bool macd_on, bool use_cache, const MonteCarloOptions& options,
+                                              ThreadPool& pool, const ExecutionModel& execution = {});
+
+void print_monte_carlo(const std::vector<MonteCarloReport>& reports, const MonteCarloOptions& options, std::ostream& out);
+
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+
+#include "price_view.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+struct PortfolioInput {
+    std::string ticker;
+    PriceView price;
+    TimestampView timestamps;               // optional; symbols are aligned by date when every input has them
+    std::vector<std::uint8_t> signal;       // 1 = hold / buy, 0 = flat / sell, indexed like price
+};
+
+
+struct PortfolioResult {
+    std::vector<std::string> tickers;
+    std::vector<double> equity;             // equity curve over the shared timeline
+    std::vector<double> pnl;                // per-symbol profit, realised plus open position
+    double initial_cash {};
+    double final_equity {};
+    double return_percent {};
+    double max_drawdown_percent {};
+    int trades {};
+    int days {};
+};
+
+
+// many symbols trading from one shared cash balance
+// market data is stored struct-of-arrays, day-major ([day * symbols + k]), so each day's update
+// is a tight loop over contiguous prices, signals and positions
+// sizing: when a symbol turns to BUY it gets an equal slot (equity / symbols), capped by free cash
+class Portfolio {
+private:
+    std::vector<std::string> tickers;
+    int symbols {};
+    int days {};
+    double initial_cash;
+
+    std::vector<double> prices;             // [day * symbols + k], 0 before a symbol's first day
+    std::vector<std::uint8_t> signals;      // [day * symbols + k]
+
+    void align_by_date(const std::vector<PortfolioInput>& inputs);
+    void align_by_end(const std::vector<PortfolioInput>& inputs);
+
+public:
+    Portfolio(const std::vector<PortfolioInput>& inputs, double cash);
+
+    PortfolioResult run() const;
+    int get_days() const { return days; }
+    int get_symbols() const { return symbols; }
+};
+
+
+void print_portfolio(const PortfolioResult& result, const std::string& strategy, std::ostream& out);
+
+// portfolio mode: load every file concurrently (keeping the longest series per ticker), build each
+// symbol's SMA / MACD signal and run one portfolio per enabled strategy
+// files that fail to load are listed and left out of the portfolio
+void run_portfolio_files(const std::vector<std::string>& files, double cash, bool sma_on, bool macd_on,
+                         bool use_cache, ThreadPool& pool, std::ostream& out);
+
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef PRECISION_H
+#define PRECISION_H
+
+
+#include "backtest.h"
+#include "MACD.h"
+#include "price_view.h"
+#include "report.h"
+#include "simulator.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// ---- reduced-precision price stores ----
+// strategies run on double prices; these kernels run the SMA and MACD signals on prices stored as
+// float (half the bytes per value) or as fixed-point int64 cents (exact sums, no rounding drift), so
+// the cheaper store can be checked against the double strategies and then used for a run
+// the kernels are instantiated for float and Cents only
+
+// fixed-point prices: whole cents
+using Cents = std::int64_t;
+
+constexpr double CENTS_PER_UNIT {100};
+
+// largest price (in units) a Cents store accepts, so a window sum of up to ~90,000 days fits in int64
+constexpr double MAX_CENTS_PRICE {1e12};
+
+// `p` converted to T: floats are rounded to the nearest float, Cents to the nearest cent
+// throws std::invalid_argument for non-finite prices, or ones beyond MAX_CENTS_PRICE as Cents
+template <typename T>
+std::vector<T> to_precision(PriceView p);
+
+template <typename T>
+double to_double(T value);
+
+// rolling mean on T prices, indexed like rolling_mean: result[day] is the mean of p[day - window, day)
+// the window sum is kept as double for float and exactly for Cents; Cents means are rounded to the cent
+template <typename T>
+std::vector<T> precision_mean(ColumnView<T> p, int window);
+
+// EMA on T prices, indexed like ema_series (seeded with the mean of the first t values)
+// Cents EMAs move by the rounded fixed-point step (p - ema) * 2 / (t + 1)
+template <typename T>
+std::vector<T> precision_ema(ColumnView<T> p, int t);
+
+// what MACD::Signal compares with 0: the histogram for signal-line crossovers, the MACD line otherwise
+// (indexed by day, valid from the MACD's first_signal_day)
+template <typename T>
+std::vector<T> precision_macd(ColumnView<T> p, int s, int l, int sig, MACD::Crossover mode);
+
+// backtest_mask on T prices: the same trades, with each trade's P&L taken in double for float and
+// exactly in cents for Cents
+template <typename T>
+BacktestResult precision_backtest(ColumnView<T> price, int start_day, int stocks, const std::uint8_t* mask);
+
+
+// ---- runs on a reduced-precision store ----
+
+// how a run stores its prices: doubles (every strategy), or floats / cents (SMA and MACD, see PrecisionRun)
+enum class StoreType {doubles, floats, cents};
+
+// 'double', 'float' or 'cents'; throws std::invalid_argument otherwise
+StoreType parse_store(std::string_view name);
+
+
+// Simulator's reports for SMA and MACD strategies with every series rerun on the prices stored as T:
+// the averages from precision_mean, the MACD line or histogram from precision_macd (with the
+// strategy's periods, signal and crossover), the decisions from greater_mask and the backtests from
+// precision_backtest, so no double strategy series is read
+// backtests are frictionless, from the first day every strategy is valid, next to buy and hold on T
+template <typename T>
+class PrecisionRun {
+private:
+    std::vector<StrategyEntry> entries;
+    std::vector<T> store;
+    int size;
+    int start_day {0};
+    double total_weight {0};
+    std::vector<std::vector<std::uint8_t>> decisions;   // per strategy, a 0/1 byte per day from start_day
+    std::vector<std::uint8_t> latest;                   // per strategy, its decision on the latest day
+    VoteRule vote;
+    bool vote_backtest {false};
+
+public:
+    // throws std::invalid_argument for a strategy that is not an SMA or MACD on `p`, or prices T cannot store
+    PrecisionRun(std::vector<StrategyEntry> strategies, PriceView p);
+
+    // as Simulator::set_vote
+    void set_vote(const VoteRule& rule);
+
+    IndicatorReport indicator_report() const;
+    BacktestReport backtest_report(int stocks=1) const;
+};
+
+
+// ---- validation against double ----
+
+// one strategy's decisions and backtest in one precision, next to the double strategy's
+struct PrecisionCheck {
+    std::string strategy;           // i.e. "SMA 50/200"
+    std::string precision;          // "float" or "cents"
+    int bytes {};                   // per stored price
+    int days {};                    // decisions compared, from the strategy's first signal day
+    int mismatches {};              // days deciding differently from double
+    int first_mismatch {-1};        // first such day, -1 if none
+    double max_error {};            // largest |difference| of the compared series from double
+    BacktestResult baseline;        // double
+    BacktestResult result;
+
+    double agreement() const { return (days > 0) ? 100.0 * (days - mismatches) / days : 100.0; }
+};
+
+// check each SMA and MACD of `strategies` (built on p, with any periods) in float and Cents against the
+// double strategy (frictionless backtests of `stocks` shares); results are strategy-major, float before cents
+// throws std::invalid_argument for another kind of strategy, or prices that cannot be stored as Cents
+std::vector<PrecisionCheck> validate_precision(PriceView p, int stocks, const std::vector<StrategyEntry>& strategies);
+
+void print_precision(const std::vector<PrecisionCheck>& checks, std::ostream& out);
+
+
+#endif
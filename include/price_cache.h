@@ -0,0 +1,74 @@
+#ifndef PRICE_CACHE_H
+#define PRICE_CACHE_H
+
+
+#include "price_view.h"
+#include "mapped_file.h"
+#include "util.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// binary price cache written next to each CSV ('<file>.tsc'), native byte order, one column after another:
+//   CacheHeader (64 bytes)
+//   double        close[count]
+//   std::int64_t  timestamp[count]      only if flags & CACHE_HAS_TIMESTAMPS
+//   double        open, high, low[count] each, only if flags & CACHE_HAS_OHLC
+//   double        volume[count]         only if flags & CACHE_HAS_VOLUME
+// the cache is rebuilt whenever the size or modification time of the source CSV changes
+constexpr char CACHE_MAGIC[8] {'T', 'S', 'I', 'M', 'C', 'A', 'C', 'H'};
+constexpr std::uint32_t CACHE_VERSION {2};
+constexpr std::uint32_t CACHE_HAS_TIMESTAMPS {1u << 0};
+constexpr std::uint32_t CACHE_HAS_OHLC {1u << 1};
+constexpr std::uint32_t CACHE_HAS_VOLUME {1u << 2};
+
+struct CacheHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t count;
+    std::uint64_t source_size;
+    std::int64_t source_mtime;
+    std::uint64_t reserved[3];
+};
+
+static_assert(sizeof(CacheHeader) == 64, "cache header layout must stay fixed");
+
+
+// loaded bars; owns either freshly parsed columns or the mapping of a cache file
+// move-only: the views returned by bars(), prices() and timestamps() stay valid as long as the series is alive
+class PriceSeries {
+private:
+    BarData owned;
+    std::optional<MappedFile> mapping;
+    BarsView view;
+
+public:
+    PriceSeries(std::vector<double> prices, std::vector<std::int64_t> timestamps={});
+    explicit PriceSeries(BarData bars);
+    PriceSeries(MappedFile cache, const BarsView& bars);
+
+    PriceSeries(PriceSeries&&) = default;
+    PriceSeries& operator=(PriceSeries&&) = default;
+    PriceSeries(const PriceSeries&) = delete;
+    PriceSeries& operator=(const PriceSeries&) = delete;
+
+    const BarsView& bars() const { return view; }
+    PriceView prices() const { return view.close; }
+    TimestampView timestamps() const { return view.timestamps; }
+    bool has_timestamps() const { return !view.timestamps.empty(); }
+    bool is_cached() const { return mapping.has_value(); }
+};
+
+
+std::string cache_path(std::string_view csv_file);
+
+// map the cache of csv_file if it is up to date, otherwise parse the CSV and (re)write its cache
+// cache write failures are ignored: the cache is only an accelerator
+PriceSeries load_prices(std::string_view csv_file, bool use_cache=true);
+
+
+#endif
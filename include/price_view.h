@@ -0,0 +1,69 @@
+#ifndef PRICE_VIEW_H
+#define PRICE_VIEW_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+// non-owning, read-only view of a contiguous column of values
+// lets strategies run on a std::vector or straight on a memory-mapped cache file without copying
+// the viewed storage must outlive the view
+template <typename T>
+class ColumnView {
+private:
+    const T* ptr {nullptr};
+    std::size_t length {};
+
+public:
+    ColumnView() = default;
+    ColumnView(const T* p, std::size_t n) : ptr(p), length(n) {}
+    ColumnView(const std::vector<T>& v) : ptr(v.data()), length(v.size()) {}
+
+    const T& operator[](std::size_t i) const { return ptr[i]; }
+
+    const T& at(std::size_t i) const {
+        if (i >= length) throw std::out_of_range("ColumnView index out of range");
+
+        return ptr[i];
+    }
+
+    const T* data() const { return ptr; }
+    std::size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + length; }
+    const T& front() const { return ptr[0]; }
+    const T& back() const { return ptr[length - 1]; }
+};
+
+
+using PriceView = ColumnView<double>;
+using TimestampView = ColumnView<std::int64_t>;
+
+
+// OHLCV bars as parallel columns (struct-of-arrays): an indicator reading only closes, or only
+// highs and lows, streams through just those arrays
+// close is always present; the other columns are empty when the source only had closing prices
+struct BarsView {
+    PriceView open;
+    PriceView high;
+    PriceView low;
+    PriceView close;
+    PriceView volume;
+    TimestampView timestamps;
+
+    std::size_t size() const { return close.size(); }
+    bool has_ohlc() const { return open.size() == size() && high.size() == size() && low.size() == size(); }
+    bool has_volume() const { return volume.size() == size(); }
+};
+
+// bars of a source that only has closing prices
+inline BarsView close_only(PriceView close) {
+    return {{}, {}, {}, close, {}, {}};
+}
+
+
+#endif
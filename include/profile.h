@@ -0,0 +1,150 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+// things a run counts while profiling, besides time
+enum class Counter {bytes_parsed, rows, indicator_calls, signal_days, trades};
+
+constexpr int COUNTERS {5};
+
+// "bytes parsed", "rows", ...
+const char* counter_name(Counter counter);
+
+
+// one finished scoped timer, in nanoseconds since profiling was enabled
+struct StageEvent {
+    const char* stage;
+    std::int64_t start_ns;
+    std::int64_t duration_ns;
+    int thread;                     // small per-process thread number, 0 for the first thread seen
+};
+
+// every event of one stage added up
+struct StageSummary {
+    std::string stage;
+    int calls {};
+    double total_ms {};
+    double max_ms {};
+};
+
+
+// process-wide collector of stage timings and counters
+// disabled until enable(); timers and counters then cost one relaxed atomic load each, and stages are
+// coarse (a file load, a constructor, a backtest), so the mutex around the event list is not contended
+class Profiler {
+private:
+    std::atomic<bool> on {false};
+    std::chrono::steady_clock::time_point origin {std::chrono::steady_clock::now()};
+    mutable std::mutex lock;
+    std::vector<StageEvent> events;
+    std::array<std::atomic<std::uint64_t>, COUNTERS> counters {};
+
+public:
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    // clear everything recorded so far and restart the clock
+    void enable();
+    void disable();
+    bool enabled() const { return on.load(std::memory_order_relaxed); }
+
+    std::int64_t now_ns() const;
+
+    void add(Counter counter, std::uint64_t n) { counters[static_cast<int>(counter)].fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t count(Counter counter) const { return counters[static_cast<int>(counter)].load(std::memory_order_relaxed); }
+
+    void record(const char* stage, std::int64_t start_ns, std::int64_t end_ns);
+
+    std::vector<StageEvent> get_events() const;
+
+    // one entry per stage, in the order stages first started
+    std::vector<StageSummary> summary() const;
+
+    // per-stage breakdown and counters as a text table
+    void write_report(std::ostream& out) const;
+
+    // Chrome trace-event JSON (chrome://tracing, Perfetto): one complete event per timer, counters at the end
+    void write_trace(std::ostream& out) const;
+};
+
+
+// times its scope as one event of `stage` (a string literal) if profiling is enabled when it starts
+class ScopedTimer {
+private:
+    const char* stage;
+    std::int64_t start {-1};
+
+public:
+    explicit ScopedTimer(const char* name) : stage(name) {
+        if (Profiler::instance().enabled()) start = Profiler::instance().now_ns();
+    }
+
+    ~ScopedTimer() { stop(); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    // end the event early
+    void stop() {
+        if (start < 0) return;
+
+        Profiler::instance().record(stage, start, Profiler::instance().now_ns());
+        start = -1;
+    }
+};
+
+
+// prints the breakdown to stderr (and writes the trace file, if any) when the run ends, on every return path
+class ProfileSession {
+private:
+    std::string trace_file;
+
+public:
+    explicit ProfileSession(std::string trace={});
+    ~ProfileSession();
+
+    ProfileSession(const ProfileSession&) = delete;
+    ProfileSession& operator=(const ProfileSession&) = delete;
+};
+
+
+// instrumentation macros: built with -DTRADING_SIM_PROFILE (make PROFILE=1, the default) they time and
+// count when --profile enables the profiler; without it they expand to nothing and their arguments are
+// never evaluated
+#if defined(TRADING_SIM_PROFILE)
+
+inline constexpr bool PROFILING_BUILT_IN {true};
+
+#define PROFILE_JOIN_(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN_(a, b)
+#define PROFILE_SCOPE(stage) ScopedTimer PROFILE_JOIN(profile_scope_, __LINE__) {stage}
+#define PROFILE_TIMER(name, stage) ScopedTimer name {stage}
+#define PROFILE_STOP(name) name.stop()
+#define PROFILE_COUNT(counter, n) \
+    do { if (Profiler::instance().enabled()) Profiler::instance().add(counter, n); } while (0)
+
+#else
+
+inline constexpr bool PROFILING_BUILT_IN {false};
+
+#define PROFILE_SCOPE(stage) ((void) 0)
+#define PROFILE_TIMER(name, stage) ((void) 0)
+#define PROFILE_STOP(name) ((void) 0)
+#define PROFILE_COUNT(counter, n) ((void) 0)
+
+#endif
+
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+
+#include "backtest.h"
+#include "batch.h"
+#include "metrics.h"
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+enum class OutputFormat {text, json, csv};
+
+// 'text', 'json' or 'csv'; throws std::invalid_argument otherwise
+OutputFormat parse_format(std::string_view name);
+
+
+struct SignalReport {
+    std::string strategy;               // "SMA", "MACD", "RSI", "Bollinger", "EMA cross" or "ATR"
+    int short_term {};
+    int long_term {};                   // equal to short_term for single-period strategies
+    int signal_term {};                 // MACD only
+    std::string crossover;              // MACD only: "zero" or "signal"
+    bool buy {};
+    double weight {1};                  // of its vote
+};
+
+
+struct IndicatorReport {
+    std::vector<SignalReport> signals;
+    double score {};                    // weighted vote from -1 (all SELL) to 1 (all BUY)
+    std::string recommendation;         // recommendation_label of the score
+};
+
+
+struct StrategyReport {
+    std::string strategy;
+    BacktestResult result;
+    std::optional<Metrics> metrics;     // only when the simulator computes metrics
+    std::vector<Trade> trades;          // its trade ledger, with metrics
+};
+
+
+struct BacktestReport {
+    int stocks {};
+    ExecutionModel execution;           // costs and sizing the results include
+    double first_price {};
+    double last_price {};
+    std::vector<StrategyReport> strategies;
+    BacktestResult buy_and_hold;
+    std::optional<Metrics> buy_and_hold_metrics;
+};
+
+
+// everything a single (non-batch) run produces
+struct RunReport {
+    std::string ticker;
+    double current_price {};
+    int days {};                    // bars analysed
+    std::string timeframe;          // "weekly", ... when the bars were resampled; empty for the bars as loaded
+    int stocks {};
+    std::optional<IndicatorReport> indicator;
+    std::optional<BacktestReport> backtest;
+};
+
+
+// i.e. "$1 fee, 5 bps slippage, 10% of equity (from $100000), next-bar fills"; "frictionless" without costs
+std::string describe_execution(const ExecutionModel& execution);
+
+// "STRONG BUY" / "STRONG SELL" when several strategies all agree, otherwise "BUY" above the `buy`
+// threshold, "SELL" below `sell` and "MIXED SIGNAL" in between (see VoteRule)
+std::string recommendation_label(double score, double buy, double sell, int strategies);
+
+// score and recommendation of the weighted vote of report.signals
+void tally_vote(IndicatorReport& report, double buy, double sell);
+
+// the coloured terminal sections printed by Simulator
+void write_indicator_text(const IndicatorReport& report, std::ostream& out);
+void write_backtest_text(const BacktestReport& report, std::ostream& out);
+
+// serialize a whole run / batch into one string, so it reaches the terminal or file in a single write
+std::string format_run(const RunReport& report, OutputFormat format);
+std::string format_batch(const std::vector<BatchReport>& reports, OutputFormat format);
+
+
+#endif
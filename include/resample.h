@@ -0,0 +1,46 @@
+#ifndef RESAMPLE_H
+#define RESAMPLE_H
+
+
+#include "price_view.h"
+#include "util.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// bar length of a resampled series: `count` minutes, or one day, week (Monday to Sunday) or calendar month
+// buckets are aligned to UTC: N-minute bars to the epoch (so 15min bars start on the quarter hour),
+// days at 00:00 UTC
+struct Timeframe {
+    enum class Unit {minute, day, week, month};
+
+    Unit unit {Unit::day};
+    int count {1};
+};
+
+// daily, weekly, monthly, <N>min or <N>h (i.e. 15min, 4h)
+Timeframe parse_timeframe(std::string_view name);
+
+// the name parse_timeframe reads back: "weekly", "15min", ...
+std::string timeframe_name(const Timeframe& tf);
+
+// number of the bucket holding a UTC epoch second; consecutive buckets have consecutive numbers
+std::int64_t timeframe_bucket(std::int64_t seconds, const Timeframe& tf);
+
+
+// coarser bars and where they came from: bar k covers source bars [ends[k - 1], ends[k]) (ends[-1] = 0)
+struct ResampledBars {
+    BarData bars;
+    std::vector<int> ends;
+};
+
+// one pass over the source bars: open of the first bar of each bucket, highest high, lowest low,
+// close of the last bar, summed volume and the timestamp of the first bar
+// close-only sources give close-only bars; throws std::invalid_argument without timestamps or
+// if they go back in time
+ResampledBars resample(const BarsView& bars, const Timeframe& tf);
+
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+
+#include "price_view.h"
+#include "report.h"
+#include "stream.h"
+#include "MACD.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+// content hash of the first `rows` rows of every column the bars have (all of them by default)
+// 64-bit, four independent multiply-rotate lanes over the raw values, so it runs at memory speed;
+// the hash of a prefix is the hash of the series before rows were appended to it
+std::uint64_t hash_bars(const BarsView& bars, std::size_t rows=SIZE_MAX);
+
+
+// a data file as the result cache last saw it: size and modification time, then rows and content hash
+struct SourceStamp {
+    std::uint64_t size {};
+    std::int64_t mtime {};
+    std::uint64_t rows {};
+    std::uint64_t hash {};
+
+    bool same_file(const SourceStamp& other) const { return size == other.size && mtime == other.mtime; }
+};
+
+// size and modification time of a file (rows and hash left 0); empty if it cannot be read
+std::optional<SourceStamp> stat_source(const std::string& path);
+
+
+// content-addressed results on disk: one file per (data hash, key), where the key names everything else
+// the result depends on (the run's options, a strategy and its periods) and the program build
+// together with per-file stamps, an unchanged data file is answered without being loaded at all
+// entries are written to a temporary file and renamed into place; every failure to read or write one
+// is a miss, since the cache is only an accelerator
+class ResultCache {
+private:
+    std::string dir;
+    std::string program;            // size and modification time of the running executable
+
+    std::string entry_path(std::uint64_t data_hash, std::string_view key) const;
+    void write_file(const std::string& path, std::string_view bytes) const;
+
+public:
+    explicit ResultCache(std::string directory);
+
+    // the stamp recorded for `path`, if any (whether or not the file changed since)
+    std::optional<SourceStamp> source(const std::string& path) const;
+    void record(const std::string& path, const SourceStamp& stamp) const;
+
+    std::optional<std::string> find(std::uint64_t data_hash, std::string_view key) const;
+    void store(std::uint64_t data_hash, std::string_view key, std::string_view value) const;
+};
+
+
+// SMA / MACD state as bytes for ResultCache::store; restore returns false (leaving the indicator as it
+// was) if the bytes are not a state of an indicator with the same periods
+std::string save_state(const StreamingSMA& sma);
+std::string save_state(const StreamingMACD& macd);
+bool restore_state(std::string_view bytes, StreamingSMA& sma);
+bool restore_state(std::string_view bytes, StreamingMACD& macd);
+
+
+// latest SMA 50/200 and / or MACD 12/26 signals of `bars`, as Simulator::indicator_report, from streaming
+// indicators: when the bars only appended rows to those of `known` (the data the cache saw last) the
+// states saved after its last row are resumed and only the new rows are pushed, otherwise every row is;
+// the states after the last row are saved under the hash of `bars` for the next run, so states of
+// other bars (i.e. a resampled series of the same file) are never resumed
+// empty if the series is too short for the periods (a full run reports why)
+std::optional<IndicatorReport> incremental_signals(const ResultCache& cache, const BarsView& bars,
+                                                   const std::optional<SourceStamp>& known, bool sma_on, bool macd_on,
+                                                   int signal_period, MACD::Crossover cross);
+
+
+#endif
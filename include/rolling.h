@@ -0,0 +1,68 @@
+#ifndef ROLLING_H
+#define ROLLING_H
+
+
+#include "price_view.h"
+#include <vector>
+
+
+// fixed-size sliding window over a stream of values
+// keeps a running sum so push() and mean() are O(1) regardless of window size
+class RollingWindow {
+private:
+    std::vector<double> buffer;     // ring buffer holding the last `window` values
+    int window;
+    int head {};
+    int count {};
+    double sum {};
+    double compensation {};         // Neumaier error term (only used when compensated)
+    bool compensated;
+
+    void accumulate(double x);
+
+public:
+    RollingWindow(int w, bool c=true);
+
+    void push(double x);
+    void reset();
+    bool full() const { return count == window; }
+    int get_window() const { return window; }
+    int get_count() const { return count; }
+    double get_sum() const { return sum + compensation; }
+    double mean() const;
+
+    // everything push() has accumulated, to save a window and resume it later
+    struct State {
+        std::vector<double> buffer;
+        int head;
+        int count;
+        double sum;
+        double compensation;
+    };
+
+    State get_state() const { return {buffer, head, count, sum, compensation}; }
+
+    // throws std::invalid_argument if `state` cannot be one of a window of this size
+    void set_state(const State& state);
+};
+
+
+// rolling mean of `p` over `window` values, computed in a single pass
+// result[day] is the mean of p[day - window, day), matching the SMA day convention
+// result has p.size() + 1 entries; entries before `window` are left at 0
+std::vector<double> rolling_mean(PriceView p, int window, bool compensated=true);
+
+// same as rolling_mean, with the caller's window (reset first) and a buffer of p.size() + 1 values,
+// so repeated series of one length allocate nothing
+void rolling_mean_into(PriceView p, RollingWindow& rolling, double* out);
+
+// population standard deviation over the same windows (same indexing as rolling_mean)
+// sums are taken around p[0], so prices far from 0 do not cancel away the variance
+std::vector<double> rolling_stdev(PriceView p, int window, bool compensated=true);
+
+// lowest / highest value over the same windows, O(1) amortized per day (monotonic queue)
+std::vector<double> rolling_min(PriceView p, int window);
+std::vector<double> rolling_max(PriceView p, int window);
+
+
+#endif
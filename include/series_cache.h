@@ -0,0 +1,81 @@
+#ifndef SERIES_CACHE_H
+#define SERIES_CACHE_H
+
+
+#include "price_view.h"
+#include "resample.h"
+#include <map>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+// inputs of the window statistics: bar columns and series derived from them
+// high and low fall back to close when the bars only have closing prices
+enum class Source {close, high, low, gain, loss, true_range};
+
+struct TimeframeSeries;
+
+
+// shared rolling core: every window statistic of one bar series, computed on first use and then
+// served from memory, so indicators built on the same cache (i.e. Bollinger 20 and SMA 20/50, or
+// EMACross 12/26 and MACD 12/26) pay for each distinct statistic once
+// returned references stay valid as long as the cache (entries are never moved or erased)
+// coarser timeframes of the bars are cached the same way, each with a cache of its own
+// not thread-safe: build the strategies sharing a cache on one thread, then use them anywhere
+class SeriesCache {
+private:
+    enum class Stat {source, mean, stdev, min, max, ema};
+
+    BarsView bars;
+    bool compensated;
+    std::map<std::tuple<Stat, Source, int>, std::vector<double>> series;
+    std::map<std::pair<Timeframe::Unit, int>, std::unique_ptr<TimeframeSeries>> timeframes;
+
+    PriceView column(Source s);
+    const std::vector<double>& statistic(Stat stat, Source s, int window);
+
+public:
+    explicit SeriesCache(const BarsView& b, bool c=true);
+    ~SeriesCache();
+
+    SeriesCache(const SeriesCache&) = delete;
+    SeriesCache& operator=(const SeriesCache&) = delete;
+
+    const BarsView& get_bars() const { return bars; }
+    int size() const { return bars.size(); }
+
+    // number of statistics (and derived sources) computed so far
+    int computed() const { return series.size(); }
+
+    // close, high, low as stored; gain / loss: close-to-close rise / fall (0 on day 0);
+    // true_range: max(high - low, |high - previous close|, |low - previous close|), |close change| without OHLC
+    PriceView source(Source s) { return column(s); }
+
+    // result[day] = statistic of source[day - window, day): p.size() + 1 entries, as rolling_mean
+    const std::vector<double>& mean(Source s, int window);
+    const std::vector<double>& stdev(Source s, int window);
+    const std::vector<double>& min(Source s, int window);
+    const std::vector<double>& max(Source s, int window);
+
+    // result[day] = EMA including source[day], valid from span - 1, as ema_series
+    const std::vector<double>& ema(Source s, int span);
+
+    // these bars resampled to `tf`, built on first use and shared by every strategy of that timeframe
+    // (throws std::invalid_argument as resample does)
+    TimeframeSeries& timeframe(const Timeframe& tf);
+};
+
+
+// a coarser timeframe of a cache's bars and the cache of its statistics
+struct TimeframeSeries {
+    Timeframe tf;
+    ResampledBars resampled;
+    SeriesCache cache;
+
+    TimeframeSeries(const BarsView& source, const Timeframe& t, bool compensated=true);
+};
+
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef SERVICE_H
+#define SERVICE_H
+
+
+#include "backtest.h"
+#include "latency.h"
+#include "price_cache.h"
+#include "series_cache.h"
+#include "simulator.h"
+#include "strategy_config.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+// one line of the service protocol: a flat JSON object, i.e.
+//     {"id":1,"ticker":"MSFT","strategy":"sma","short":20,"long":50,"stocks":10,"mode":"backtest"}
+//     {"id":2,"ticker":"TSLA"}                          SMA 50/200 and MACD 12/26, indicator and backtest
+//     {"id":3,"stats":true}                             request count and latency percentiles
+// every key besides id, ticker, strategy, mode, stocks and stats is a parameter of the strategy
+// (as in a --config line), so periods need a single strategy
+struct ServiceRequest {
+    std::string id {"null"};                                    // JSON value echoed in the response
+    bool stats {false};
+    std::string ticker;
+    std::string strategy {"both"};                              // both (SMA and MACD) or a strategy kind
+    std::vector<std::pair<std::string, std::string>> params;
+    bool indicator {true};
+    bool backtest {true};
+    int stocks {1};
+};
+
+// fill `request` from one line; throws std::invalid_argument for malformed JSON, nested values and
+// invalid fields (the id is read before the other fields, so an error can still be answered to it)
+void parse_request(std::string_view line, ServiceRequest& request);
+
+
+struct ServiceSummary {
+    std::uint64_t requests {};
+    std::uint64_t errors {};
+    LatencyStats latency;           // from reading a request to writing its response
+};
+
+
+// answers requests from data files kept in memory: a ticker's file (the latest export of it) is loaded
+// on its first request, and the last MAX_STRATEGIES strategies used on it stay built, so repeated
+// requests only run the backtest
+// memory does not grow with the number of distinct parameter sets: the least recently used strategy
+// is dropped, and the ticker's SeriesCache is replaced by an empty one after MAX_STRATEGIES builds
+// (a strategy keeps the cache it was built on alive)
+// safe to call from many threads: each ticker has its own lock, held while loading and building
+// strategies; simulations run outside it on the shared, immutable strategies
+class BacktestService {
+public:
+    static constexpr std::size_t MAX_STRATEGIES {64};
+
+private:
+    struct Cached {
+        StrategyEntry entry;
+        std::uint64_t used;                                 // the ticker's lookup count when last used
+    };
+
+    struct Ticker {
+        std::string path;
+        std::mutex mutex;
+        std::optional<PriceSeries> series;
+        std::shared_ptr<SeriesCache> cache;
+        std::size_t built {};                               // strategies built on `cache`
+        std::uint64_t lookups {};
+        std::map<std::string, Cached> strategies;           // by kind and parameters
+    };
+
+    std::map<std::string, std::unique_ptr<Ticker>> tickers;  // fixed at construction
+    bool use_cache;
+    ExecutionModel execution;
+    mutable std::mutex stats_mutex;
+    ServiceSummary summary;
+
+    StrategyEntry build(Ticker& ticker, const StrategySpec& spec);
+    void evict(Ticker& ticker);
+    std::string run(const ServiceRequest& request);
+
+public:
+    // TICKER_start_to_end.csv files (see find_data_files)
+    BacktestService(const std::vector<std::string>& files, bool use_cache=true, const ExecutionModel& execution={});
+
+    BacktestService(const BacktestService&) = delete;
+    BacktestService& operator=(const BacktestService&) = delete;
+
+    std::vector<std::string> get_tickers() const;
+
+    // strategies kept built for `ticker` (0 for an unknown one)
+    std::size_t cached_strategies(const std::string& ticker) const;
+
+    // the response line (with its newline) to one request line:
+    //     {"id":1,"ok":true,"result":{...as --format=json...}}
+    //     {"id":1,"ok":false,"error":"..."}
+    // never throws: every failure is an error response
+    std::string handle(std::string_view line);
+
+    // count a response written `ns` after its request was read
+    void record(double ns);
+    ServiceSummary get_summary() const;
+};
+
+
+// answer every line of `in` on the pool and write each response to `out` as soon as it is ready
+// (responses of concurrent requests may come back in any order; their id tells them apart)
+void serve_stream(BacktestService& service, std::istream& in, std::ostream& out, ThreadPool& pool);
+
+// listen on a Unix socket at `path` (replacing a stale one) and serve every connection like
+// serve_stream until `stop` is set; throws std::runtime_error if the socket cannot be created
+void serve_socket(BacktestService& service, const std::string& path, ThreadPool& pool, const std::atomic<bool>& stop);
+
+void print_service_summary(const ServiceSummary& summary, std::ostream& out);
+
+
+#endif
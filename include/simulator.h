@@ -4,30 +4,80 @@
 
 #include "./SMA.h"
 #include "./MACD.h"
+#include "./report.h"
+#include "./compose.h"
+#include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 
+// one strategy of a simulation and the weight of its vote
+struct StrategyEntry {
+    std::string name;                           // as reported, i.e. "SMA" or "RSI"
+    std::shared_ptr<const Strategy> strategy;
+    double weight {1};
+};
+
+
+// weighted vote of the strategies: each BUY adds its weight, each SELL subtracts it, and the sum is
+// divided by the total weight, so the score runs from -1 (all SELL) to 1 (all BUY)
+// the vote is BUY above `buy` and SELL below `sell`; in between, its backtest keeps its position
+// (the defaults are a plain weighted majority, holding on a tie)
+struct VoteRule {
+    double buy {0};
+    double sell {0};
+};
+
+// throws std::invalid_argument unless -1 <= sell <= buy <= 1
+void check_vote_rule(const VoteRule& rule);
+
+
 class Simulator {
 private:
-    std::optional<SMA> sma;
-    std::optional<MACD> macd;
-    const std::vector<double>& price;
+    std::vector<StrategyEntry> entries;
+    PriceView price;
     const int size;
-    const int start_day;
-
-    void indicator_sma(bool signal) const;
-    void indicator_macd(bool signal) const;
-    void backtest_strategy(bool is_sma, int stocks=1) const;
-    void backtest_bnh(int stocks=1) const;
-    void break_line() const;
-    void print_profit(double profit, double percent) const;
+    int start_day {0};
+    double total_weight {0};
+    VoteRule vote;
+    bool vote_backtest {false};
+    std::optional<Combine> combination;
+    std::optional<PriceView> open_price;    // set: trades fill at the open instead of the close
+    ExecutionModel execution;
+    bool with_metrics {false};
 
 public:
-    Simulator(const SMA& s, const std::vector<double>& p);
-    Simulator(const MACD& m, const std::vector<double>& p);
-    Simulator(const SMA& s, const MACD& m, const std::vector<double>& p);
+    // every strategy in `strategies`, backtested from the first day all of them are valid
+    Simulator(std::vector<StrategyEntry> strategies, PriceView p);
+
+    Simulator(const SMA& s, PriceView p);
+    Simulator(const MACD& m, PriceView p);
+    Simulator(const SMA& s, const MACD& m, PriceView p);
+
+    // also report and backtest `strategy` as `name`
+    void add_strategy(std::string name, std::shared_ptr<const Strategy> strategy, double weight=1);
+
+    // thresholds of the recommendation, and also backtest the vote as a strategy of its own ("Vote")
+    void set_vote(const VoteRule& rule);
+
+    // also backtest every strategy combined with `mode` (needs at least two)
+    void set_combination(Combine mode);
+
+    // fill backtest trades at the open (needs an open column as long as the prices)
+    // strategies reading the day's close (all but SMA) fill at the next day's open
+    void set_open_fill(PriceView open);
+
+    // fees, slippage, sizing and fill delay applied to every backtest trade (default: frictionless)
+    void set_execution(const ExecutionModel& model);
+
+    // also compute each backtest's equity-curve metrics and trade ledger
+    void set_metrics(bool on);
+
+    IndicatorReport indicator_report() const;
+    BacktestReport backtest_report(int stocks=1) const;
 
+    // print the reports as coloured text to std::cout
     void indicator() const;
     void backtest(int stocks=1) const;
 };
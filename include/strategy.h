@@ -1,22 +1,51 @@
 #ifndef STRATEGY_H
 #define STRATEGY_H
 
-#include <vector>
+#include "price_view.h"
+#include <algorithm>
+#include <cstdint>
 
 
 class Strategy {
 protected:
-    const std::vector<double>& price;
+    BarsView bars;                  // every column the data has; only close is guaranteed
+    PriceView price;                // bars.close
     int short_term;
     int long_term;
     int size;
 
+    // strategies with a single period (RSI, Bollinger, ATR): short_term == long_term == period
+    Strategy(const BarsView& b, int period);
+
 public:
-    Strategy(const std::vector<double>& p, int s, int l);
+    Strategy(PriceView p, int s, int l);
+    Strategy(const BarsView& b, int s, int l);
+    const BarsView& get_bars() const { return bars; }
     int get_short_term() const { return short_term; }
     int get_long_term() const { return long_term; }
+    // first day indicator() can be asked about
+    virtual int first_signal_day() const { return long_term; }
     virtual bool indicator(int day=-1) const = 0;
+
+    // out[day] = indicator(day) for every day in [begin, end), first_signal_day() <= begin, end <= data size
+    // one virtual call per range: strategies write their precomputed signal in bulk
+    virtual void fill(int begin, int end, std::uint8_t* out) const;
+
+    // true when indicator(day) reads the close of `day` itself, so a trade filled at the open can only
+    // act on it the next day (SMA only reads earlier closes)
+    virtual bool needs_day_close() const { return true; }
+
     virtual ~Strategy() = default;
 };
 
+
+// signal of a strategy whose position is precomputed per day (entry and exit rules with memory,
+// i.e. enter below one level and leave above another), one 0/1 byte per day
+struct StateSignal {
+    const std::uint8_t* state;
+
+    bool operator()(int day) const { return state[day]; }
+    void fill(int begin, int end, std::uint8_t* out) const { std::copy(state + begin, state + end, out + begin); }
+};
+
 #endif
@@ -0,0 +1,57 @@
+#ifndef STRATEGY_CONFIG_H
+#define STRATEGY_CONFIG_H
+
+
+#include "simulator.h"
+#include "series_cache.h"
+#include <istream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+// one strategy of a runtime config: its kind, the parameters given (as written) and its vote
+struct StrategySpec {
+    std::string kind;                                           // sma, macd, rsi, bollinger, ema or atr
+    std::vector<std::pair<std::string, std::string>> params;    // i.e. {"short", "20"}; defaults for the rest
+    std::string name;                                           // empty: the kind's report name
+    double weight {1};
+    int line {0};                                               // config line, 0 if not from a config
+};
+
+
+// strategies of a simulation and the thresholds of their vote
+struct SimulationConfig {
+    std::vector<StrategySpec> strategies;
+    VoteRule vote;
+};
+
+
+// true for the kinds make_strategy builds
+bool is_strategy_kind(std::string_view kind);
+
+// a config file: one strategy per line, i.e.
+//     sma short=20 long=50 weight=2
+//     rsi period=14 oversold=25 overbought=75 name=RSI-25
+//     sma short=10 long=40 timeframe=weekly
+// plus an optional 'vote buy=X sell=Y' line; '#' starts a comment
+// throws std::invalid_argument naming the line for unknown kinds and malformed lines or values;
+// parameter names are checked by make_strategy
+SimulationConfig parse_config(std::istream& in);
+
+// parse_config of a file; throws std::runtime_error if it cannot be opened
+SimulationConfig load_config(const std::string& path);
+
+// the strategy of `spec` on the shared cache, checking its parameter names and values; with a
+// timeframe parameter it runs on the cache's resampled bars (see HigherTimeframe)
+// (parameter errors and series too short for them throw std::invalid_argument, naming the config line if any)
+StrategyEntry make_strategy(const StrategySpec& spec, SeriesCache& cache);
+
+// make_strategy of every strategy of a config, in order; unnamed strategies of the same kind (and
+// timeframe) get their parameters in their names, i.e. "SMA 10/40" and "SMA 50/200"
+// throws std::invalid_argument naming the line if two strategies still share a name
+std::vector<StrategyEntry> make_strategies(const SimulationConfig& config, SeriesCache& cache);
+
+
+#endif
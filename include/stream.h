@@ -0,0 +1,107 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+
+#include "rolling.h"
+#include "MACD.h"
+#include "latency.h"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+
+// live SMA: two ring buffers updated in O(1) per tick
+// after n prices, signal() equals SMA::indicator(n) on the same history
+class StreamingSMA {
+private:
+    RollingWindow short_window;
+    RollingWindow long_window;
+
+public:
+    StreamingSMA(int s=50, int l=200, bool compensated=true);
+
+    void push(double price);
+    bool ready() const { return long_window.full(); }
+    bool signal() const;
+    int get_short_term() const { return short_window.get_window(); }
+    int get_long_term() const { return long_window.get_window(); }
+
+    // resume from saved windows (see RollingWindow::set_state)
+    const RollingWindow& get_short_window() const { return short_window; }
+    const RollingWindow& get_long_window() const { return long_window; }
+    void set_state(const RollingWindow::State& s, const RollingWindow::State& l);
+};
+
+
+// live MACD: recursive EMAs updated in O(1) per tick
+// after n prices, signal() equals MACD::indicator(n - 1) on the same history
+class StreamingMACD {
+private:
+    int short_term;
+    int long_term;
+    int signal_term;
+    MACD::Crossover mode;
+    std::int64_t count {};
+    double short_ema {};
+    double long_ema {};
+    double short_k;
+    double long_k;
+    double signal_k;
+    double macd {};
+    double signal_ema {};
+    int macd_count {};
+
+public:
+    StreamingMACD(int s=12, int l=26, int sig=9, MACD::Crossover m=MACD::Crossover::zero_line);
+
+    void push(double price);
+    bool ready() const;
+    bool signal() const;
+    double get_macd() const { return macd; }
+    double get_signal_line() const { return signal_ema; }
+    int get_short_term() const { return short_term; }
+    int get_long_term() const { return long_term; }
+    int get_signal_term() const { return signal_term; }
+    MACD::Crossover get_crossover() const { return mode; }
+
+    // everything push() has accumulated, to save the indicator and resume it later
+    struct State {
+        std::int64_t count;
+        double short_ema;
+        double long_ema;
+        double macd;
+        double signal_ema;
+        int macd_count;
+    };
+
+    State get_state() const { return {count, short_ema, long_ema, macd, signal_ema, macd_count}; }
+    void set_state(const State& state);
+};
+
+
+struct StreamOptions {
+    bool sma_on {true};
+    bool macd_on {true};
+    int signal_period {9};
+    MACD::Crossover macd_cross {MACD::Crossover::zero_line};
+    bool follow {false};            // keep waiting for appended data at EOF (tail -f)
+    int poll_ms {100};
+};
+
+
+struct StreamSummary {
+    std::int64_t ticks {};
+    std::int64_t rejected {};
+    std::int64_t transitions {};
+    LatencyStats latency;           // indicator update time per tick
+};
+
+
+// read one price per line from `in`, update the enabled indicators and write a BUY/SELL line to `out`
+// the moment a signal flips; malformed lines are reported on `err` and skipped
+StreamSummary run_stream(std::istream& in, std::ostream& out, std::ostream& err, const StreamOptions& options);
+
+void print_stream_summary(const StreamSummary& summary, std::ostream& out);
+
+
+#endif
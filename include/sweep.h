@@ -0,0 +1,67 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+
+#include "backtest.h"
+#include "metrics.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// inclusive range of periods: from, from + step, ..., to
+struct SweepRange {
+    int from {};
+    int to {};
+    int step {1};
+};
+
+
+struct SweepResult {
+    std::string strategy;
+    int short_term {};
+    int long_term {};
+    BacktestResult result;
+    std::optional<Metrics> metrics;
+};
+
+
+SweepRange parse_range(std::string_view text);
+
+
+// every (short, long) pair of two ranges and the moving-average series they use, each computed once
+// a series value at day t only depends on prices up to t, so one grid serves every window of the data
+class SweepGrid {
+private:
+    int size {};
+    std::vector<int> slot;                          // period -> row of the series tables
+    std::vector<std::vector<double>> averages;      // SMA: one rolling mean per period
+    std::vector<double> emas;                       // MACD: one EMA row of `size` values per period
+    std::vector<SweepResult> configs;
+
+public:
+    SweepGrid(PriceView price, SweepRange short_range, SweepRange long_range, bool sma_on, bool macd_on, ThreadPool& pool);
+
+    // one entry per configuration with an empty result, SMA before MACD for each pair
+    const std::vector<SweepResult>& configurations() const { return configs; }
+
+    // out[i] = BUY signal of the configuration for i in [begin, end)
+    void fill(const SweepResult& config, int begin, int end, std::uint8_t* out) const;
+};
+
+// backtest every (short, long) pair of the ranges for the enabled strategies, ranked by profit
+// each distinct moving-average series is computed once and shared by every pair that uses it
+// with metrics, every configuration also gets its equity-curve metrics; each worker thread keeps one
+// MetricsArena for all the configurations it runs
+std::vector<SweepResult> sweep(PriceView price, SweepRange short_range, SweepRange long_range,
+                               int stocks, bool sma_on, bool macd_on, ThreadPool& pool,
+                               const ExecutionModel& execution = {}, bool metrics = false);
+
+// the top results; Win rate, Max DD and Sharpe columns are added when the sweep computed metrics
+void print_sweep(const std::vector<SweepResult>& results, int top);
+
+
+#endif
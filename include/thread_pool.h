@@ -0,0 +1,110 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// work-stealing thread pool
+// every worker owns a deque: it pops its own work from the back and steals from the front of the others,
+// so uneven tasks (i.e. long vs short windows) keep all cores busy without a central queue bottleneck
+class ThreadPool {
+private:
+    struct WorkQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<int> queued {0};        // tasks sitting in a queue
+    std::atomic<int> pending {0};       // tasks submitted but not finished
+    std::atomic<unsigned> next_queue {0};
+    std::mutex state_mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::exception_ptr error;
+    bool stopping {false};
+
+    bool try_pop(int index, std::function<void()>& task);
+    bool try_steal(int index, std::function<void()>& task);
+    void execute(std::function<void()>& task);
+    void run(int index);
+    void finish_task();
+
+public:
+    explicit ThreadPool(int threads=0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // block until every submitted task has finished, rethrowing the first task failure
+    // (only for callers owning the whole pool: it also waits for other callers' tasks)
+    void wait();
+
+    // true on this pool's worker threads
+    bool on_worker() const;
+
+    // run one queued task on the calling pool worker; false if there is none (or not called from a worker)
+    bool run_pending();
+
+    int get_size() const { return workers.size(); }
+};
+
+
+// completion of one batch of tasks, so a caller waits for its own work and not for the whole pool
+class TaskLatch {
+private:
+    int left;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+
+public:
+    explicit TaskLatch(int count) : left(count) {}
+
+    // one task of the batch finished, with its failure if it threw
+    void count_down(std::exception_ptr failure=nullptr);
+
+    // block until the whole batch has finished, rethrowing its first failure; a pool worker runs queued
+    // tasks while it waits, so a batch submitted from inside a task cannot deadlock the pool
+    void wait(ThreadPool& pool);
+};
+
+
+// run fn(i) for every i in [begin, end) on the pool and wait for those calls only
+template <typename Fn>
+void parallel_for(ThreadPool& pool, int begin, int end, Fn fn) {
+    TaskLatch latch {std::max(end - begin, 0)};
+
+    for (int i = begin; i < end; i++) {
+        pool.submit([&fn, &latch, i]() {
+            try {
+                fn(i);
+            }
+            catch (...) {
+                latch.count_down(std::current_exception());
+                return;
+            }
+
+            latch.count_down();
+        });
+    }
+
+    latch.wait(pool);
+}
+
+
+#endif
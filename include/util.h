@@ -2,11 +2,37 @@
 #define DATA_READER_H
 
 
+#include <cstdint>
 #include <string_view>
 #include <vector>
 
 
+// OHLCV bars in struct-of-arrays form; columns the file does not have are left empty
+// (a headerless temp.csv only has closes)
+struct BarData {
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> volume;
+    std::vector<std::int64_t> timestamps;   // Date / Datetime column as UTC epoch seconds
+};
+
+
 std::vector<double> read_file(std::string_view file_name);
+
+// also collects the Date column of exported files as UTC epoch seconds (left empty if there is none)
+std::vector<double> read_file(std::string_view file_name, std::vector<std::int64_t>& timestamps);
+
+// every OHLCV column (and the Date column) the file has, in one pass
+BarData read_bars(std::string_view file_name);
+
+// parse a whole field as a double, allowing surrounding blanks and a leading '+'
+bool parse_price(std::string_view field, double& value);
+
+// parse 'YYYY-MM-DD[ HH:MM:SS[Z|+HH:MM|-HH:MM]]' into UTC epoch seconds
+bool parse_timestamp(std::string_view text, std::int64_t& seconds);
+
 void parser_error(std::string_view argv0);
 void print_help();
 
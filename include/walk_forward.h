@@ -0,0 +1,56 @@
+#ifndef WALK_FORWARD_H
+#define WALK_FORWARD_H
+
+
+#include "sweep.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+struct WalkForwardOptions {
+    int train {504};            // days the periods are optimized on (~2 trading years)
+    int test {126};             // days the chosen periods are then traded on (~6 months)
+    int step {0};               // days between fold starts; 0 = test (back-to-back test windows)
+    bool anchored {false};      // every train window starts at day 0 and grows (expanding window)
+};
+
+
+// train on [train_begin, train_end), test on [train_end, test_end)
+struct Fold {
+    int train_begin {};
+    int train_end {};
+    int test_end {};
+};
+
+
+// the best configuration of one strategy on a fold's train window and how it did on the test window
+struct FoldResult {
+    Fold fold;
+    std::string strategy;
+    int short_term {};
+    int long_term {};
+    BacktestResult train;           // in-sample
+    BacktestResult test;            // out-of-sample
+};
+
+
+// train / test windows covering a series of `size` days; only full test windows are kept
+// throws std::invalid_argument on non-positive lengths or when not even one fold fits
+std::vector<Fold> walk_forward_folds(int size, const WalkForwardOptions& options);
+
+// optimize the (short, long) periods of each enabled strategy by profit on every train window,
+// then backtest the winner on the following test window
+// all series are computed once over the whole price history and every configuration's signal mask
+// once, so overlapping train windows share them instead of recomputing per fold; configurations and
+// then folds run in parallel
+// results are fold-major, SMA before MACD
+std::vector<FoldResult> walk_forward(PriceView price, SweepRange short_range, SweepRange long_range,
+                                     int stocks, bool sma_on, bool macd_on,
+                                     const WalkForwardOptions& options, ThreadPool& pool,
+                                     const ExecutionModel& execution = {});
+
+void print_walk_forward(const std::vector<FoldResult>& results, const WalkForwardOptions& options, std::ostream& out);
+
+
+#endif
@@ -0,0 +1,75 @@
+import sys
+import json
+import argparse
+
+
+# create a parser
+parser = argparse.ArgumentParser(description="TradingSim: compare two `make bench` JSON results and flag regressions")
+
+
+# add arguments
+parser.add_argument(
+    "baseline",
+    help="Results of the previous version (i.e. bench_results.json)"
+)
+
+parser.add_argument(
+    "current",
+    help="Results of the version under test"
+)
+
+parser.add_argument(
+    "--threshold", "-t",
+    type=float,
+    default=10.0,
+    help="Slowdown in percent reported as a regression (default: 10)"
+)
+
+
+args = parser.parse_args()
+
+
+# benchmark name -> cpu time (ns), skipping aggregate rows (mean/median/stddev of repetitions)
+def load(path):
+    try:
+        with open(path) as f:
+            results = json.load(f)
+    except (OSError, ValueError) as e:
+        sys.exit(f"Error: could not read '{path}': {e}")
+
+    scale = {"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}
+    times = {}
+
+    for bench in results.get("benchmarks", []):
+        if bench.get("run_type") == "aggregate":
+            continue
+
+        times[bench["name"]] = bench["cpu_time"] * scale[bench.get("time_unit", "ns")]
+
+    return times
+
+
+baseline = load(args.baseline)
+current = load(args.current)
+regressions = 0
+
+print(f"{'Benchmark':<50}{'Baseline':>14}{'Current':>14}{'Change':>10}")
+
+for name, time in current.items():
+    if name not in baseline:
+        continue
+
+    change = (time / baseline[name] - 1) * 100
+    flag = ""
+
+    if change > args.threshold:
+        regressions += 1
+        flag = "  REGRESSION"
+
+    print(f"{name:<50}{baseline[name] / 1e6:>12.3f}ms{time / 1e6:>12.3f}ms{change:>+9.1f}%{flag}")
+
+
+if regressions:
+    sys.exit(f"\n{regressions} benchmark(s) slower than the {args.threshold:g}% threshold")
+
+print("\nNo regressions")
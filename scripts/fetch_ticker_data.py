@@ -116,7 +116,8 @@ if data.empty:
 save_dir = os.path.join(data_dir, "temp.csv")
 
 try:
-    data[["Close"]].to_csv(save_dir, index=False, header=False)
+    # full OHLCV bars with a header row; trading_sim reads the columns it needs
+    data[["Open", "High", "Low", "Close", "Volume"]].to_csv(save_dir, index_label="Date")
 
     if args.export:
         start_date_str = start_date.date()
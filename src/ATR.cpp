@@ -0,0 +1,57 @@
+#include "../include/ATR.h"
+#include "../include/profile.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+ATR::ATR(SeriesCache& cache, int period, double m, int b)
+    : Strategy(cache.get_bars(), period), multiple(m), breakout(b), atr(size), state(size)
+{
+    if (!(m > 0)) throw std::invalid_argument("ATR stop multiple must be positive");
+    if (b <= 0) throw std::invalid_argument("Breakout period must be positive");
+    if (first_signal_day() >= size) throw std::invalid_argument("Not enough data for the ATR and breakout periods");
+
+    const std::vector<double>& average = cache.ema(Source::true_range, 2 * period - 1);
+    const std::vector<double>& highest_close = cache.max(Source::close, breakout);
+    const std::vector<double>& highest_high = cache.max(Source::high, period);
+
+    PROFILE_SCOPE("ATR stops");
+
+    std::copy(average.begin(), average.end(), atr.begin());
+
+    bool holding {false};
+
+    // rolling maxima are indexed by the day after their window: entry i excludes day i, entry i + 1 includes it
+    for (int i = first_signal_day(); i < size; i++) {
+        if (price[i] > highest_close[i]) holding = true;
+        else if (price[i] < highest_high[i + 1] - multiple * atr[i]) holding = false;
+
+        state[i] = holding;
+    }
+}
+
+// the ATR and the breakout window both exist
+int ATR::first_signal_day() const {
+    return std::max(2 * long_term - 2, breakout);
+}
+
+bool ATR::indicator(int day) const {
+    // decisions use the close of `day`, so the latest signal is on the last recorded day
+    if (day == -1) day = size - 1;
+
+    if (day >= size) throw std::invalid_argument("day cannot exceed available data size");
+    if (day < first_signal_day()) throw std::invalid_argument("ATR indicator requested for day before the ATR and breakout exist");
+
+    return state[day];
+}
+
+double ATR::value(int day) const {
+    if (day == -1) day = size - 1;
+
+    if (day >= size) throw std::invalid_argument("day cannot exceed available data size");
+    if (day < 2 * long_term - 2) throw std::invalid_argument("ATR requested for day before it exists");
+
+    return atr[day];
+}
@@ -0,0 +1,38 @@
+#include "../include/Bollinger.h"
+#include "../include/profile.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+// the cache's rolling mean and stdev are indexed by the day after their window, so day i reads entry i + 1
+Bollinger::Bollinger(SeriesCache& cache, int period, double w)
+    : Strategy(cache.get_bars(), period), width(w), state(size)
+{
+    if (period < 2) throw std::invalid_argument("Bollinger period must be at least 2");
+    if (!(w > 0)) throw std::invalid_argument("Bollinger band width must be positive");
+
+    const std::vector<double>& mean = cache.mean(Source::close, period);
+    const std::vector<double>& stdev = cache.stdev(Source::close, period);
+
+    PROFILE_SCOPE("Bollinger bands");
+
+    bool holding {false};
+
+    for (int i = first_signal_day(); i < size; i++) {
+        if (price[i] < mean[i + 1] - width * stdev[i + 1]) holding = true;
+        else if (price[i] > mean[i + 1]) holding = false;
+
+        state[i] = holding;
+    }
+}
+
+bool Bollinger::indicator(int day) const {
+    // the bands include the close of `day`, so the latest signal is on the last recorded day
+    if (day == -1) day = size - 1;
+
+    if (day >= size) throw std::invalid_argument("day cannot exceed available data size");
+    if (day < first_signal_day()) throw std::invalid_argument("Bollinger indicator requested for day earlier than its period");
+
+    return state[day];
+}
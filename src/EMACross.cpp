@@ -0,0 +1,29 @@
+#include "../include/EMACross.h"
+#include "../include/backtest.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+EMACross::EMACross(SeriesCache& cache, int s, int l)
+    : Strategy(cache.get_bars(), s, l), spread(size)
+{
+    const std::vector<double>& short_ema = cache.ema(Source::close, s);
+    const std::vector<double>& long_ema = cache.ema(Source::close, l);
+
+    for (int i = l - 1; i < size; i++) spread[i] = short_ema[i] - long_ema[i];
+}
+
+bool EMACross::indicator(int day) const {
+    // EMAs include the price of `day` itself, so the latest signal is on the last recorded day
+    if (day == -1) day = size - 1;
+
+    if (day >= size) throw std::invalid_argument("day cannot exceed available data size");
+    if (day < long_term) throw std::invalid_argument("EMA crossover indicator requested for day earlier than long-term period");
+
+    return spread[day] > 0;
+}
+
+void EMACross::Signal::fill(int begin, int end, std::uint8_t* out) const {
+    greater_mask(spread, nullptr, begin, end, out);
+}
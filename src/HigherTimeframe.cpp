@@ -0,0 +1,50 @@
+#include "../include/HigherTimeframe.h"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+HigherTimeframe::HigherTimeframe(SeriesCache& cache, const Timeframe& t, std::shared_ptr<const Strategy> c)
+    : Strategy(cache.get_bars(), c->get_long_term()), coarse(std::move(c)), tf(t), first(size), state(size)
+{
+    const TimeframeSeries& series = cache.timeframe(tf);
+
+    if (coarse->get_bars().close.data() != series.cache.get_bars().close.data()) {
+        throw std::invalid_argument("The coarser strategy must be built on the cache of its timeframe");
+    }
+
+    short_term = coarse->get_short_term();
+
+    const std::vector<int>& ends = series.resampled.ends;
+    int bars = ends.size();
+    int from = coarse->first_signal_day();
+    bool at_close {coarse->needs_day_close()};
+    std::vector<std::uint8_t> decisions(bars);
+
+    if (from < bars) coarse->fill(from, bars, decisions.data());
+
+    // bar k is complete at the close of its last day; a decision that only reads earlier bars
+    // (SMA) already holds from its first day
+    for (int day = 0, k = 0; day < size; day++) {
+        if (day == ends[k]) k++;
+
+        int known = (at_close && day + 1 < ends[k]) ? k - 1 : k;
+
+        if (known < from) continue;
+        if (first == size) first = day;
+
+        state[day] = decisions[known];
+    }
+
+    if (first >= size) throw std::invalid_argument("Not enough " + timeframe_name(tf) + " bars for the strategy's periods");
+}
+
+bool HigherTimeframe::indicator(int day) const {
+    if (day == -1) day = size - 1;
+    if (day >= size) throw std::invalid_argument("day cannot exceed available data size");
+    if (day < first) throw std::invalid_argument("Timeframe indicator requested for day before its first coarse signal");
+
+    return state[day];
+}
@@ -1,45 +1,114 @@
 #include "../include/MACD.h"
+#include "../include/profile.h"
+#include "../include/backtest.h"
+#include <cstdint>
+#include <algorithm>
 #include <vector>
 #include <stdexcept>
 
 
-MACD::MACD(const std::vector<double> &p, int s, int l)
-    : Strategy(p, s, l)
+MACD::MACD(PriceView p, int s, int l, int sig, Crossover mode)
+    : MACD(close_only(p), s, l, sig, mode) {}
+
+// only the close column is read
+MACD::MACD(const BarsView& b, int s, int l, int sig, Crossover mode)
+    : Strategy(b, s, l), signal_term(sig), crossover_mode(mode),
+      short_ema(size), long_ema(size), macd_line(size), signal_line(size), histogram(size)
 {
+    PROFILE_SCOPE("MACD series");
+
+    if (sig <= 0) throw std::invalid_argument("Signal period must be positive");
+
     // store EMAs for efficiency usage later
-    double EMA {seed(short_term)};
-    double k {2.0 / (short_term + 1)};
+    ema_into(price, short_term, short_ema.data());
+    ema_into(price, long_term, long_ema.data());
 
-    for (int i = short_term; i < size; i++) {
-        EMA = (price.at(i) * k) + (EMA * (1 - k));
-        short_ema.push_back(EMA);
-    }
+    build_lines();
+}
+
+MACD::MACD(SeriesCache& cache, int s, int l, int sig, Crossover mode)
+    : Strategy(cache.get_bars(), s, l), signal_term(sig), crossover_mode(mode),
+      short_ema(cache.ema(Source::close, s)), long_ema(cache.ema(Source::close, l)),
+      macd_line(size), signal_line(size), histogram(size)
+{
+    PROFILE_SCOPE("MACD series");
+
+    if (sig <= 0) throw std::invalid_argument("Signal period must be positive");
+
+    build_lines();
+}
+
+void MACD::build_lines() {
+    int sig = signal_term;
+
+    // MACD line exists once both EMAs do
+    int macd_start = long_term - 1;
+
+    for (int i = macd_start; i < size; i++) macd_line[i] = short_ema[i] - long_ema[i];
+
+    // signal line: EMA of the MACD line, seeded with the mean of its first `sig` values
+    signal_start = macd_start + sig - 1;
+
+    if (signal_start < size) {
+        double sum {0};
+
+        for (int i = macd_start; i <= signal_start; i++) sum += macd_line[i];
+
+        double EMA {sum / sig};
+        double k {2.0 / (sig + 1)};
+
+        signal_line[signal_start] = EMA;
 
-    EMA = {seed(long_term)};
-    k = 2.0 / (long_term + 1);
+        for (int i = signal_start + 1; i < size; i++) {
+            EMA = (macd_line[i] * k) + (EMA * (1 - k));
+            signal_line[i] = EMA;
+        }
 
-    for (int i = long_term; i < size; i++) {
-        EMA = (price.at(i) * k) + (EMA * (1 - k));
-        long_ema.push_back(EMA);
+        for (int i = signal_start; i < size; i++) histogram[i] = macd_line[i] - signal_line[i];
+    } else {
+        signal_start = size;
+    }
+
+    if (crossover_mode == Crossover::signal_line && signal_start >= size) {
+        throw std::invalid_argument("Not enough data for the MACD signal line");
     }
 }
 
-double MACD::seed(int t) const {
-    if (t <= 0) throw std::invalid_argument("t must be positive");
-    
-    double sum {0};
-    
-    for (int i = 0; i < t; i++) sum += price.at(i);
-    
-    return sum / t;
+int MACD::first_signal_day() const {
+    return (crossover_mode == Crossover::signal_line) ? std::max(long_term, signal_start) : long_term;
 }
 
-bool MACD::indicator(int day) const {
-    if (day == -1) day = size;
-    if (day > size) throw std::invalid_argument("day cannot exceed available data size");
+void MACD::check_day(int day) const {
+    if (day >= size) throw std::invalid_argument("day cannot exceed available data size");
     if (day < long_term) throw std::invalid_argument("MACD indicator requested for day earlier than long-term period");
-    
-    // MACD calculation now O(1) because EMAs are pre-stored
-    // MACD calculation done with no signal line for simplicity
-    return (short_ema[day - short_term] - long_ema[day - long_term]) > 0;
+    if (day < first_signal_day()) throw std::invalid_argument("MACD indicator requested for day before the signal line exists");
+}
+
+bool MACD::indicator(int day) const {
+    // EMAs include the price of `day` itself, so the latest signal is on the last recorded day
+    if (day == -1) day = size - 1;
+
+    check_day(day);
+
+    // O(1): every line is precomputed
+    if (crossover_mode == Crossover::signal_line) return histogram[day] > 0;
+
+    return macd_line[day] > 0;
+}
+
+int MACD::crossover(int day) const {
+    if (day == -1) day = size - 1;
+
+    check_day(day);
+
+    if (day == first_signal_day()) return 0;
+
+    bool now {indicator(day)};
+    bool before {indicator(day - 1)};
+
+    return (now == before) ? 0 : (now ? 1 : -1);
+}
+
+void MACD::Signal::fill(int begin, int end, std::uint8_t* out) const {
+    greater_mask(line, nullptr, begin, end, out);
 }
@@ -0,0 +1,59 @@
+#include "../include/RSI.h"
+#include "../include/profile.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+RSI::RSI(SeriesCache& cache, int period, double low, double high)
+    : Strategy(cache.get_bars(), period), oversold(low), overbought(high), rsi(size), state(size)
+{
+    if (period < 2) throw std::invalid_argument("RSI period must be at least 2");
+    if (!(0 <= low && low < high && high <= 100)) throw std::invalid_argument("RSI levels must satisfy 0 <= oversold < overbought <= 100");
+    if (first_signal_day() >= size) throw std::invalid_argument("Not enough data for the RSI period");
+
+    const std::vector<double>& gain = cache.ema(Source::gain, 2 * period - 1);
+    const std::vector<double>& loss = cache.ema(Source::loss, 2 * period - 1);
+
+    PROFILE_SCOPE("RSI series");
+
+    bool holding {false};
+
+    for (int i = first_signal_day(); i < size; i++) {
+        // flat window: neither side has strength
+        if (loss[i] > 0) rsi[i] = 100 - 100 / (1 + gain[i] / loss[i]);
+        else rsi[i] = (gain[i] > 0) ? 100 : 50;
+
+        if (rsi[i] < oversold) holding = true;
+        else if (rsi[i] > overbought) holding = false;
+
+        state[i] = holding;
+    }
+}
+
+// first day both smoothed averages exist (their seed counts day 0, which has no change, as 0)
+int RSI::first_signal_day() const {
+    return 2 * long_term - 2;
+}
+
+void RSI::check_day(int day) const {
+    if (day >= size) throw std::invalid_argument("day cannot exceed available data size");
+    if (day < first_signal_day()) throw std::invalid_argument("RSI indicator requested for day before the averages exist");
+}
+
+bool RSI::indicator(int day) const {
+    // RSI includes the close of `day`, so the latest signal is on the last recorded day
+    if (day == -1) day = size - 1;
+
+    check_day(day);
+
+    return state[day];
+}
+
+double RSI::value(int day) const {
+    if (day == -1) day = size - 1;
+
+    check_day(day);
+
+    return rsi[day];
+}
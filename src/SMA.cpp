@@ -1,25 +1,32 @@
 #include "../include/SMA.h"
+#include "../include/rolling.h"
+#include "../include/backtest.h"
+#include <cstdint>
 #include <vector>
 #include <stdexcept>
 
 
-SMA::SMA(const std::vector<double>& p, int s, int l)
-    : Strategy(p, s, l) {}
+// both averages are precomputed with a rolling window so each lookup is O(1)
+SMA::SMA(PriceView p, int s, int l, bool compensated)
+    : SMA(close_only(p), s, l, compensated) {}
 
-double SMA::short_term_avg(int day) const {
-    double sum {0};
+// only the close column is read
+SMA::SMA(const BarsView& b, int s, int l, bool compensated)
+    : Strategy(b, s, l),
+      short_avg(rolling_mean(b.close, s, compensated)),
+      long_avg(rolling_mean(b.close, l, compensated)) {}
 
-    for (int i = day - short_term; i < day; i++) sum += price.at(i);
+SMA::SMA(SeriesCache& cache, int s, int l)
+    : Strategy(cache.get_bars(), s, l),
+      short_avg(cache.mean(Source::close, s)),
+      long_avg(cache.mean(Source::close, l)) {}
 
-    return sum / short_term;
+double SMA::short_term_avg(int day) const {
+    return short_avg[day];
 }
 
 double SMA::long_term_avg(int day) const {
-    double sum {0};
-
-    for (int i = day - long_term; i < day; i++) sum += price.at(i);
-
-    return sum / long_term;
+    return long_avg[day];
 }
 
 // give buy/sell indication based on the comparison between short_term and long-term averages
@@ -31,3 +38,6 @@ bool SMA::indicator(int day) const {
     return short_term_avg(day) > long_term_avg(day);
 }
 
+void SMA::Signal::fill(int begin, int end, std::uint8_t* out) const {
+    greater_mask(short_avg, long_avg, begin, end, out);
+}
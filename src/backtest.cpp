@@ -0,0 +1,246 @@
+#include "../include/backtest.h"
+#include "../include/profile.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+#if defined(__SSE2__)
+// bit j of the index -> byte j of the entry (0 or 1), to widen an 8-lane movemask into 8 mask bytes
+static constexpr std::array<std::uint64_t, 256> make_expand_table() {
+    std::array<std::uint64_t, 256> table {};
+
+    for (int bits = 0; bits < 256; bits++) {
+        for (int j = 0; j < 8; j++) {
+            if (bits & (1 << j)) table[bits] |= std::uint64_t {1} << (8 * j);
+        }
+    }
+
+    return table;
+}
+
+static constexpr std::array<std::uint64_t, 256> EXPAND {make_expand_table()};
+#endif
+
+
+void greater_mask(const double* a, const double* b, int begin, int end, std::uint8_t* out) {
+    int i {begin};
+
+#if defined(__SSE2__)
+    const __m128d zero = _mm_setzero_pd();
+
+    // 8 days per step: four 2-lane compares packed into one byte, widened to 8 mask bytes
+    for (; i + 8 <= end; i += 8) {
+        int bits {0};
+
+        for (int k = 0; k < 4; k++) {
+            __m128d x = _mm_loadu_pd(a + i + 2 * k);
+            __m128d y = (b) ? _mm_loadu_pd(b + i + 2 * k) : zero;
+
+            bits |= _mm_movemask_pd(_mm_cmpgt_pd(x, y)) << (2 * k);
+        }
+
+        std::memcpy(out + i, &EXPAND[bits], 8);
+    }
+#endif
+
+    for (; i < end; i++) out[i] = a[i] > ((b) ? b[i] : 0.0);
+}
+
+void greater_mask(const float* a, const float* b, int begin, int end, std::uint8_t* out) {
+    int i {begin};
+
+#if defined(__SSE2__)
+    const __m128 zero = _mm_setzero_ps();
+
+    // 8 days per step: two 4-lane compares packed into one byte, widened to 8 mask bytes
+    for (; i + 8 <= end; i += 8) {
+        int bits {0};
+
+        for (int k = 0; k < 2; k++) {
+            __m128 x = _mm_loadu_ps(a + i + 4 * k);
+            __m128 y = (b) ? _mm_loadu_ps(b + i + 4 * k) : zero;
+
+            bits |= _mm_movemask_ps(_mm_cmpgt_ps(x, y)) << (4 * k);
+        }
+
+        std::memcpy(out + i, &EXPAND[bits], 8);
+    }
+#endif
+
+    for (; i < end; i++) out[i] = a[i] > ((b) ? b[i] : 0.0f);
+}
+
+// SSE2 has no 64-bit integer compare; this loop is left to the compiler
+void greater_mask(const std::int64_t* a, const std::int64_t* b, int begin, int end, std::uint8_t* out) {
+    if (b) {
+        for (int i = begin; i < end; i++) out[i] = a[i] > b[i];
+    } else {
+        for (int i = begin; i < end; i++) out[i] = a[i] > 0;
+    }
+}
+
+void find_transitions(const std::uint8_t* mask, int start_day, int end, std::vector<int>& out, bool shorts) {
+    if (start_day >= end) return;
+
+    if (mask[start_day] || shorts) out.push_back(start_day);
+
+    int i {start_day + 1};
+
+#if defined(__SSE2__)
+    // 16 days per step; most blocks hold no transition and cost one compare
+    for (; i + 16 <= end; i += 16) {
+        __m128i now = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+        __m128i before = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i - 1));
+        unsigned changed = ~_mm_movemask_epi8(_mm_cmpeq_epi8(now, before)) & 0xFFFF;
+
+        while (changed) {
+            out.push_back(i + __builtin_ctz(changed));
+            changed &= changed - 1;
+        }
+    }
+#endif
+
+    for (; i < end; i++) {
+        if (mask[i] != mask[i - 1]) out.push_back(i);
+    }
+}
+
+BacktestResult backtest_mask(PriceView price, int start_day, int stocks, const std::uint8_t* mask) {
+    BacktestResult result;
+    int size = price.size();
+    std::vector<int> transitions;
+
+    find_transitions(mask, start_day, size, transitions);
+
+    // a position still open at the end is sold on the last day
+    if (transitions.size() % 2 == 1) transitions.push_back(size - 1);
+
+    int trades = transitions.size() / 2;
+    double initial_buy {(trades > 0) ? price[transitions[0]] : 0.0};
+
+    // summed in trade order, exactly like the day loop
+    for (int k = 0; k < trades; k++) {
+        result.profit += (price[transitions[2 * k + 1]] - price[transitions[2 * k]]) * stocks;
+    }
+
+    result.transactions = 2 * trades;
+    result.percent = ((result.profit / stocks) / initial_buy) * 100;
+
+    PROFILE_COUNT(Counter::signal_days, std::max(size - start_day, 0));
+    PROFILE_COUNT(Counter::trades, trades);
+
+    return result;
+}
+
+void check_execution_model(const ExecutionModel& execution) {
+    if (execution.fee < 0) throw std::invalid_argument("Transaction fee cannot be negative");
+    if (execution.slippage_bps < 0 || execution.slippage_bps >= 10000) throw std::invalid_argument("Slippage must be in [0, 10000) basis points");
+    if (execution.equity_percent < 0 || execution.equity_percent > 100) throw std::invalid_argument("Position size must be in (0, 100] percent of equity");
+    if (execution.capital <= 0) throw std::invalid_argument("Starting capital must be positive");
+    if (execution.delay < 0) throw std::invalid_argument("Fill delay cannot be negative");
+}
+
+// the transitions of find_transitions closed on the last day: long only, trade k runs from
+// transitions[2k] to transitions[2k + 1]; with shorts from transitions[k] to transitions[k + 1]
+static void close_positions(std::vector<int>& transitions, int size, bool shorts) {
+    if (shorts) {
+        if (!transitions.empty()) transitions.push_back(size - 1);
+    } else if (transitions.size() % 2 == 1) {
+        transitions.push_back(size - 1);
+    }
+}
+
+// trades are still found on the mask; only their fill days and prices change
+// the side of a trade is +1 or -1 from the mask on its signal day (always +1 long only, and without a
+// mask), and enters every price and share count as a factor, so shorts add no branch per trade
+// every filled trade is also appended to ledger when one is given
+static BacktestResult execute_trades(PriceView price, int stocks, const std::vector<int>& transitions, const std::uint8_t* mask,
+                                     const ExecutionModel& execution, std::vector<Trade>* ledger=nullptr) {
+    BacktestResult result;
+    int last = price.size() - 1;
+    int step = (execution.shorts) ? 1 : 2;
+    int trades = (execution.shorts) ? std::max<int>(transitions.size() - 1, 0) : transitions.size() / 2;
+    double slip = execution.slippage_bps / 10000;
+    double equity {execution.capital};        // only limits equity_percent sizing
+    double initial_cost {0};
+
+    for (int k = 0; k < trades; k++) {
+        int signal_day = transitions[step * k];
+        int entry_day = signal_day + execution.delay;
+        int exit_day = std::min(transitions[step * k + 1] + execution.delay, last);
+
+        if (entry_day > last || equity <= 0) break;
+
+        // buys fill above the price and sells below it: a long enters with a buy, a short with a sell
+        double side = (mask) ? 2.0 * mask[signal_day] - 1 : 1.0;
+        double entry = price[entry_day] * (1 + side * slip);
+        double exit = price[exit_day] * (1 - side * slip);
+        double quantity = (execution.equity_percent > 0) ? equity * execution.equity_percent / 100 / entry : stocks;
+        double shares = side * quantity;
+        double pnl = (exit - entry) * shares - 2 * execution.fee;
+
+        if (k == 0) initial_cost = entry * quantity;
+        if (ledger) ledger->push_back({entry_day, exit_day, entry, exit, shares, pnl});
+
+        result.transactions += 2;
+        result.profit += pnl;
+        equity += pnl;
+    }
+
+    // 0 / 0 (NaN) when nothing was bought, like the frictionless backtest
+    double base = (execution.equity_percent > 0 && result.transactions > 0) ? execution.capital : initial_cost;
+
+    result.percent = result.profit / base * 100;
+
+    return result;
+}
+
+BacktestResult backtest_mask(PriceView price, int start_day, int stocks, const std::uint8_t* mask,
+                             const ExecutionModel& execution) {
+    if (execution.frictionless()) return backtest_mask(price, start_day, stocks, mask);
+
+    int size = price.size();
+    std::vector<int> transitions;
+
+    find_transitions(mask, start_day, size, transitions, execution.shorts);
+    close_positions(transitions, size, execution.shorts);
+
+    BacktestResult result {execute_trades(price, stocks, transitions, mask, execution)};
+
+    PROFILE_COUNT(Counter::signal_days, std::max(size - start_day, 0));
+    PROFILE_COUNT(Counter::trades, result.transactions / 2);
+
+    return result;
+}
+
+void trade_ledger(PriceView price, int start_day, int stocks, const std::uint8_t* mask,
+                  const ExecutionModel& execution, std::vector<int>& transitions, std::vector<Trade>& ledger) {
+    int size = price.size();
+
+    transitions.clear();
+    ledger.clear();
+    find_transitions(mask, start_day, size, transitions, execution.shorts);
+    close_positions(transitions, size, execution.shorts);
+
+    execute_trades(price, stocks, transitions, mask, execution, &ledger);
+}
+
+BacktestResult backtest_buy_and_hold(PriceView price, int stocks, const ExecutionModel& execution) {
+    ExecutionModel long_only {execution};
+    long_only.shorts = false;
+
+    if (long_only.frictionless()) return backtest_buy_and_hold(price, stocks);
+
+    int last = price.size() - 1;
+
+    // a buy on day 0 (filled after the delay) and a sale on the last day
+    return execute_trades(price, stocks, {0, last}, nullptr, long_only);
+}
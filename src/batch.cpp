@@ -0,0 +1,193 @@
+#include "../include/batch.h"
+#include "../include/profile.h"
+#include "../include/price_cache.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include <fnmatch.h>
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <optional>
+#include <ostream>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace fs = std::filesystem;
+
+
+// file names written by fetch_ticker_data.py --export
+static const std::regex DATA_FILE_NAME {R"(^([^_]+)_(\d{4}-\d{2}-\d{2})_to_(\d{4}-\d{2}-\d{2})\.csv$)"};
+
+
+std::vector<std::string> find_data_files(std::string_view spec) {
+    std::vector<std::string> files;
+    std::string text {spec};
+
+    if (text.find(',') != std::string::npos) {
+        std::istringstream list(text);
+        std::string item;
+
+        // every list entry may itself be a directory or a glob
+        while (std::getline(list, item, ',')) {
+            if (item.empty()) continue;
+
+            std::vector<std::string> matched {find_data_files(item)};
+            files.insert(files.end(), matched.begin(), matched.end());
+        }
+
+        return files;
+    }
+
+    std::error_code ec;
+
+    if (fs::is_directory(text, ec)) {
+        for (const fs::directory_entry& entry : fs::directory_iterator(text)) {
+            std::string name {entry.path().filename().string()};
+
+            if (entry.is_regular_file() && std::regex_match(name, DATA_FILE_NAME)) {
+                files.push_back(entry.path().string());
+            }
+        }
+    } else if (text.find_first_of("*?[") != std::string::npos) {
+        // glob: wildcards are only supported in the file name, not in directories
+        fs::path pattern {text};
+        fs::path dir {pattern.has_parent_path() ? pattern.parent_path() : fs::path(".")};
+        std::string name_pattern {pattern.filename().string()};
+
+        if (!fs::is_directory(dir, ec)) throw std::runtime_error("Directory not found: '" + dir.string() + "'");
+
+        for (const fs::directory_entry& entry : fs::directory_iterator(dir)) {
+            std::string name {entry.path().filename().string()};
+
+            if (entry.is_regular_file() && fnmatch(name_pattern.c_str(), name.c_str(), 0) == 0) {
+                files.push_back(entry.path().string());
+            }
+        }
+    } else {
+        files.push_back(text);
+    }
+
+    std::sort(files.begin(), files.end());
+
+    return files;
+}
+
+void parse_data_file_name(std::string_view path, std::string& ticker, std::string& period) {
+    fs::path file {std::string(path)};
+    std::string name {file.filename().string()};
+    std::smatch match;
+
+    if (std::regex_match(name, match, DATA_FILE_NAME)) {
+        ticker = match[1];
+        period = match[2].str() + " to " + match[3].str();
+    } else {
+        ticker = file.stem().string();
+        period = "";
+    }
+}
+
+static void backtest_file(BatchReport& report, int stocks, bool use_cache, const ExecutionModel& execution) {
+    PriceSeries series {load_prices(report.path, use_cache)};
+    PriceView price {series.prices()};
+
+    report.days = price.size();
+
+    if (price.empty()) throw std::runtime_error("no data");
+
+    std::optional<SMA> sma;
+    std::optional<MACD> macd;
+
+    if (report.sma_on) sma.emplace(price);
+    if (report.macd_on) macd.emplace(price);
+
+    // same common start day as Simulator, so batch rows match a single-file run
+    int start_day = std::max((sma) ? sma->first_signal_day() : 0, (macd) ? macd->first_signal_day() : 0);
+
+    if (sma) report.sma = backtest_vectorized(price, start_day, stocks, sma->signal(), execution);
+    if (macd) report.macd = backtest_vectorized(price, start_day, stocks, macd->signal(), execution);
+
+    report.bnh = backtest_buy_and_hold(price, stocks, execution);
+}
+
+std::vector<BatchReport> run_batch(const std::vector<std::string>& files, int stocks,
+                                   bool sma_on, bool macd_on, bool use_cache, ThreadPool& pool,
+                                   const ExecutionModel& execution) {
+    if (stocks <= 0) throw std::invalid_argument("Error: Invalid number of stocks");
+
+    PROFILE_SCOPE("batch");
+
+    std::vector<BatchReport> reports(files.size());
+
+    for (std::size_t i = 0; i < files.size(); i++) {
+        reports[i].path = files[i];
+        reports[i].sma_on = sma_on;
+        reports[i].macd_on = macd_on;
+        parse_data_file_name(files[i], reports[i].ticker, reports[i].period);
+    }
+
+    // a failing file only marks its own report
+    parallel_for(pool, 0, reports.size(), [&](int i) {
+        try {
+            backtest_file(reports[i], stocks, use_cache, execution);
+        }
+        catch (const std::exception& e) {
+            reports[i].error = e.what();
+        }
+    });
+
+    return reports;
+}
+
+static std::string percent_cell(const BacktestResult& result) {
+    std::ostringstream oss;
+    double percent = (std::isnan(result.percent)) ? 0 : result.percent;
+
+    oss << std::fixed << std::setprecision(2) << std::showpos << percent << "% (" << std::noshowpos
+        << result.transactions << ")";
+
+    return oss.str();
+}
+
+void print_batch(const std::vector<BatchReport>& reports, std::ostream& out) {
+    int failed {};
+
+    out << " [ Batch Backtest Results ]" << "\n\n"
+        << std::left
+        << " " << std::setw(8) << "Ticker"
+        << std::setw(28) << "Period"
+        << std::setw(7) << "Days"
+        << std::setw(18) << "SMA (trades)"
+        << std::setw(18) << "MACD (trades)"
+        << "Buy and hold" << "\n";
+
+    for (const BatchReport& r : reports) {
+        if (!r.error.empty()) {
+            failed++;
+            continue;
+        }
+
+        out << " " << std::setw(8) << r.ticker
+            << std::setw(28) << r.period
+            << std::setw(7) << r.days
+            << std::setw(18) << ((r.sma_on) ? percent_cell(r.sma) : "---")
+            << std::setw(18) << ((r.macd_on) ? percent_cell(r.macd) : "---")
+            << percent_cell(r.bnh) << "\n";
+    }
+
+    out << std::right;
+
+    if (failed == 0) return;
+
+    out << "\n Failed files: " << failed << "\n";
+
+    for (const BatchReport& r : reports) {
+        if (!r.error.empty()) out << "  " << r.path << ": " << r.error << "\n";
+    }
+}
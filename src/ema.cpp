@@ -0,0 +1,118 @@
+#include "../include/ema.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+static void check_span(int t, int size) {
+    if (t <= 0) throw std::invalid_argument("t must be positive");
+    if (t > size) throw std::invalid_argument("EMA period cannot be larger than data size");
+}
+
+void ema_into(PriceView p, int t, double* out) {
+    int size = p.size();
+
+    check_span(t, size);
+
+    double sum {0};
+
+    for (int i = 0; i < t; i++) {
+        sum += p[i];
+        out[i] = 0;
+    }
+
+    double EMA {sum / t};
+    double k {2.0 / (t + 1)};
+
+    out[t - 1] = EMA;
+
+    for (int i = t; i < size; i++) {
+        EMA = (p[i] * k) + (EMA * (1 - k));
+        out[i] = EMA;
+    }
+}
+
+std::vector<double> ema_series(PriceView p, int t) {
+    check_span(t, p.size());
+
+    std::vector<double> ema(p.size());
+    ema_into(p, t, ema.data());
+
+    return ema;
+}
+
+std::vector<double> batch_ema(PriceView p, const std::vector<int>& spans) {
+    int size = p.size();
+    int count = spans.size();
+
+    for (int t : spans) check_span(t, size);
+
+    std::vector<double> out(static_cast<std::size_t>(count) * size, 0.0);
+
+    // process spans in ascending order so paired lanes start close together
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return spans[a] < spans[b]; });
+
+    // seeds for every span from one running sum (same additions, in the same order, as ema_into)
+    std::vector<double> seed(count);
+    double sum {0};
+
+    for (int i = 0, next = 0; next < count; i++) {
+        sum += p[i];
+
+        while (next < count && spans[order[next]] == i + 1) {
+            seed[order[next]] = sum / (i + 1);
+            next++;
+        }
+    }
+
+    auto row = [&](int j) { return out.data() + static_cast<std::size_t>(j) * size; };
+
+    int j {0};
+
+#if defined(__SSE2__)
+    // two spans per 128-bit lane pair: p[i] is loaded once and updates both EMAs
+    for (; j + 1 < count; j += 2) {
+        int a = order[j];
+        int b = order[j + 1];
+        double* out_a = row(a);
+        double* out_b = row(b);
+        double k_a {2.0 / (spans[a] + 1)};
+        double k_b {2.0 / (spans[b] + 1)};
+
+        // run the shorter span alone until the longer one has its seed
+        double ema_a {seed[a]};
+        out_a[spans[a] - 1] = ema_a;
+
+        for (int i = spans[a]; i < spans[b]; i++) {
+            ema_a = (p[i] * k_a) + (ema_a * (1 - k_a));
+            out_a[i] = ema_a;
+        }
+
+        out_b[spans[b] - 1] = seed[b];
+
+        __m128d ema = _mm_set_pd(seed[b], ema_a);
+        __m128d k = _mm_set_pd(k_b, k_a);
+        __m128d decay = _mm_set_pd(1 - k_b, 1 - k_a);
+
+        for (int i = spans[b]; i < size; i++) {
+            __m128d price = _mm_set1_pd(p[i]);
+
+            ema = _mm_add_pd(_mm_mul_pd(price, k), _mm_mul_pd(ema, decay));
+            _mm_storel_pd(out_a + i, ema);
+            _mm_storeh_pd(out_b + i, ema);
+        }
+    }
+#endif
+
+    // remaining span(s) (or every span without SIMD support)
+    for (; j < count; j++) ema_into(p, spans[order[j]], row(order[j]));
+
+    return out;
+}
@@ -0,0 +1,52 @@
+#include "../include/latency.h"
+#include <algorithm>
+#include <cmath>
+
+
+int LatencyStats::bucket_of(double ns) {
+    if (ns < 1) return 0;
+
+    int bucket = static_cast<int>(std::log2(ns) * SUB_BUCKETS);
+
+    return std::min(bucket, BUCKETS - 1);
+}
+
+double LatencyStats::bucket_upper(int bucket) {
+    return std::exp2(static_cast<double>(bucket + 1) / SUB_BUCKETS);
+}
+
+void LatencyStats::record(double ns) {
+    if (samples == 0 || ns < min_ns) min_ns = ns;
+    if (ns > max_ns) max_ns = ns;
+
+    samples++;
+    total_ns += ns;
+    buckets[bucket_of(ns)]++;
+}
+
+void LatencyStats::merge(const LatencyStats& other) {
+    if (other.samples == 0) return;
+    if (samples == 0 || other.min_ns < min_ns) min_ns = other.min_ns;
+
+    max_ns = std::max(max_ns, other.max_ns);
+    samples += other.samples;
+    total_ns += other.total_ns;
+
+    for (int i = 0; i < BUCKETS; i++) buckets[i] += other.buckets[i];
+}
+
+double LatencyStats::percentile_us(double q) const {
+    if (samples == 0) return 0;
+
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(q * samples));
+    std::uint64_t seen {};
+
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += buckets[i];
+
+        // never report more than the largest sample actually seen
+        if (seen >= rank) return std::min(bucket_upper(i), max_ns) / 1000;
+    }
+
+    return max_ns / 1000;
+}
@@ -7,16 +7,152 @@
 #include "../include/MACD.h"
 #include "../include/SMA.h"
 #include "../include/simulator.h"
+#include "../include/series_cache.h"
+#include "../include/strategy_config.h"
+#include "../include/sweep.h"
+#include "../include/walk_forward.h"
+#include "../include/thread_pool.h"
+#include "../include/batch.h"
+#include "../include/price_cache.h"
+#include "../include/resample.h"
+#include "../include/result_cache.h"
+#include "../include/stream.h"
+#include "../include/service.h"
+#include "../include/portfolio.h"
+#include "../include/monte_carlo.h"
+#include "../include/precision.h"
+#include "../include/report.h"
+#include "../include/compose.h"
+#include "../include/profile.h"
+#include <csignal>
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <string>
 #include <string_view>
+#include <atomic>
 #include <stdexcept>
 #include <optional>
 #include <iostream>
+#include <fstream>
+#include <sstream>
 
 
-constexpr int MAX_ARGS {5};
+constexpr int MAX_ARGS {16};
+
+
+// set by SIGINT / SIGTERM to shut a --serve socket down after the requests in flight
+static std::atomic<bool> stop_serving {false};
+
+static void request_stop(int) {
+    stop_serving = true;
+}
+
+
+// everything a single run's output depends on besides the data: its arguments in order (and the contents
+// of a --config file), leaving out those that only change how it runs
+static std::string run_key(int argc, char* argv[]) {
+    std::string key {"run"};
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg {argv[i]};
+
+        if (arg.rfind("--result-cache", 0) == 0 || arg.rfind("--profile", 0) == 0 || arg == "--no-cache"
+            || arg.rfind("--threads=", 0) == 0) {
+            continue;
+        }
+
+        key += "\n" + arg;
+
+        if (arg.rfind("--config=", 0) == 0) {
+            std::ifstream file(arg.substr(arg.find("=") + 1), std::ios::binary);
+            std::ostringstream contents;
+
+            contents << file.rdbuf();
+            key += "\n" + contents.str();
+        }
+    }
+
+    return key;
+}
+
+// parse the integer value of a '--flag=value' argument, reporting errors the same way for every flag
+static bool parse_int_value(const std::string& arg, int& out) {
+    std::size_t splitter = arg.find("=");
+    std::string value = arg.substr(splitter + 1);
+
+    // turn the string into an integer
+    try {
+        out = std::stoi(value);
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << "Error: '" << arg << "' is not a valid integer\n";
+        return false;
+    }
+    catch (const std::out_of_range& e) {
+        std::cerr << "Error: '" << arg << "' is out of range for int\n";
+        return false;
+    }
+
+    return true;
+}
+
+// parse the number value of a '--flag=value' argument
+static bool parse_double_value(const std::string& arg, double& out) {
+    std::string value = arg.substr(arg.find("=") + 1);
+    std::size_t used {};
+
+    try {
+        out = std::stod(value, &used);
+    }
+    catch (const std::exception& e) {
+        used = 0;
+    }
+
+    if (used == 0 || used != value.size()) {
+        std::cerr << "Error: '" << arg << "' is not a valid number\n";
+        return false;
+    }
+
+    return true;
+}
+
+// parse the 'from:to[:step]' value of a '--flag=value' argument
+static bool parse_range_value(const std::string& arg, SweepRange& out) {
+    try {
+        out = parse_range(std::string_view(arg).substr(arg.find("=") + 1));
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << "Error: '" << arg << "': " << e.what() << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+// split the comma-separated '--indicators=' list, rejecting unknown names
+static bool parse_indicator_list(const std::string& arg, std::vector<std::string>& out) {
+    std::string list {arg.substr(arg.find("=") + 1)};
+    std::size_t begin {0};
+
+    while (begin <= list.size()) {
+        std::size_t end = std::min(list.find(',', begin), list.size());
+        std::string name {list.substr(begin, end - begin)};
+
+        if (name != "rsi" && name != "bollinger" && name != "ema" && name != "atr") {
+            std::cerr << "Error: unknown indicator '" << name << "' in '" << arg << "' (expected rsi, bollinger, ema or atr)\n";
+            return false;
+        }
+
+        out.push_back(name);
+        begin = end + 1;
+    }
+
+    return true;
+}
 
 
 int main(int argc, char* argv[]) {
@@ -28,7 +164,7 @@ int main(int argc, char* argv[]) {
 
     // check duplicate arguments
     // brute-force check (O(n²)), chosen deliberately over std::unordered_set
-    // since MAX_ARGS = 5, this is faster, simpler, and avoids unnecessary hashing and allocations
+    // since MAX_ARGS = 16, this is faster, simpler, and avoids unnecessary hashing and allocations
     for (int i = 1; i < argc; i++) {
         std::string_view arg {argv[i]};
 
@@ -43,6 +179,24 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // --profile is picked up before parsing, so argument parsing is timed too
+    std::optional<ProfileSession> profile;
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg {argv[i]};
+
+        if (arg != "--profile" && arg.rfind("--profile=", 0) != 0) continue;
+
+        if (!PROFILING_BUILT_IN) {
+            std::cerr << "Error: this build has no profiling support (rebuild with make PROFILE=1)\n";
+            return 2;
+        }
+
+        if (!profile) profile.emplace(std::string((arg == "--profile") ? "" : arg.substr(arg.find("=") + 1)));
+    }
+
+    PROFILE_TIMER(parsing, "parse arguments");
+
     // default values in case of no flags used
     int no_of_stocks {1};
     std::string ticker_symbol {"---"};
@@ -50,6 +204,43 @@ int main(int argc, char* argv[]) {
     bool indicator_mode {true};
     bool sma_on {true};
     bool macd_on {true};
+    bool sweep_mode {false};
+    SweepRange short_range {5, 50, 5};
+    SweepRange long_range {20, 200, 10};
+    int top {20};
+    bool walk_forward_mode {false};
+    WalkForwardOptions walk_options;
+    int threads {0};
+    bool batch_mode {false};
+    std::string batch_spec {DATA_DIR};
+    std::string output_file;
+    bool use_cache {true};
+    int signal_period {9};
+    MACD::Crossover macd_cross {MACD::Crossover::zero_line};
+    bool macd_options {false};              // --signal or --macd-cross given
+    bool stream_mode {false};
+    std::string stream_source {"-"};
+    bool follow {false};
+    bool portfolio_mode {false};
+    std::string portfolio_spec {DATA_DIR};
+    int cash {100000};
+    bool monte_carlo_mode {false};
+    bool serve_mode {false};
+    bool precision_mode {false};
+    StoreType store {StoreType::doubles};
+    std::string serve_socket_path {"-"};
+    std::string monte_carlo_spec {DATA_DIR};
+    MonteCarloOptions monte_carlo_options;
+    int seed {42};
+    OutputFormat format {OutputFormat::text};
+    std::optional<Combine> combination;
+    bool fill_open {false};
+    ExecutionModel execution;
+    bool metrics {false};
+    std::vector<std::string> indicators;
+    std::string config_file;
+    std::optional<Timeframe> timeframe;
+    std::string result_dir;
 
     // check valid arguments
     for (int i = 1; i < argc; i++) {
@@ -59,28 +250,140 @@ int main(int argc, char* argv[]) {
             print_help();
             return 0;
         } else if (arg.rfind("--stocks=", 0) == 0 || arg.rfind("-sk=", 0) == 0) {
+            if (!parse_int_value(arg, no_of_stocks)) return 2;
+        } else if (arg.rfind("--ticker=", 0) == 0 || arg.rfind("-t=", 0) == 0) {
             std::size_t splitter = arg.find("=");
-            std::string value = arg.substr(splitter + 1);
+            ticker_symbol = arg.substr(splitter + 1);
+        } else if (arg == "--mode=backtest" || arg == "-m=backtest") indicator_mode = false;
+        else if (arg == "--mode=indicator" || arg == "-m=indicator") backtest_mode = false;
+        else if (arg == "--strategy=macd" || arg == "-s=macd") sma_on = false;
+        else if (arg == "--strategy=sma" || arg == "-s=sma") macd_on = false;
+        else if (arg.rfind("--indicators=", 0) == 0) {
+            if (!parse_indicator_list(arg, indicators)) return 2;
+        } else if (arg.rfind("--config=", 0) == 0) config_file = arg.substr(arg.find("=") + 1);
+        else if (arg == "--sweep") sweep_mode = true;
+        else if (arg.rfind("--short=", 0) == 0) {
+            if (!parse_range_value(arg, short_range)) return 2;
+        } else if (arg.rfind("--long=", 0) == 0) {
+            if (!parse_range_value(arg, long_range)) return 2;
+        } else if (arg.rfind("--top=", 0) == 0) {
+            if (!parse_int_value(arg, top)) return 2;
+        } else if (arg == "--walk-forward") walk_forward_mode = true;
+        else if (arg.rfind("--train=", 0) == 0) {
+            if (!parse_int_value(arg, walk_options.train)) return 2;
+        } else if (arg.rfind("--test=", 0) == 0) {
+            if (!parse_int_value(arg, walk_options.test)) return 2;
+        } else if (arg.rfind("--step=", 0) == 0) {
+            if (!parse_int_value(arg, walk_options.step)) return 2;
+        } else if (arg == "--anchored") walk_options.anchored = true;
+        else if (arg.rfind("--threads=", 0) == 0) {
+            if (!parse_int_value(arg, threads)) return 2;
+        } else if (arg == "--batch") batch_mode = true;
+        else if (arg.rfind("--batch=", 0) == 0) {
+            batch_mode = true;
+            batch_spec = arg.substr(arg.find("=") + 1);
+        } else if (arg.rfind("--output=", 0) == 0) output_file = arg.substr(arg.find("=") + 1);
+        else if (arg == "--no-cache") use_cache = false;
+        else if (arg == "--result-cache") result_dir = std::string(DATA_DIR) + "results";
+        else if (arg.rfind("--result-cache=", 0) == 0) result_dir = arg.substr(arg.find("=") + 1);
+        else if (arg.rfind("--signal=", 0) == 0) {
+            if (!parse_int_value(arg, signal_period)) return 2;
 
-            // turn the string into an integer
+            macd_options = true;
+        } else if (arg == "--macd-cross=zero" || arg == "--macd-cross=signal") {
+            macd_cross = (arg == "--macd-cross=signal") ? MACD::Crossover::signal_line : MACD::Crossover::zero_line;
+            macd_options = true;
+        }
+        else if (arg == "--stream") stream_mode = true;
+        else if (arg.rfind("--stream=", 0) == 0) {
+            stream_mode = true;
+            stream_source = arg.substr(arg.find("=") + 1);
+        } else if (arg == "--follow") follow = true;
+        else if (arg == "--portfolio") portfolio_mode = true;
+        else if (arg.rfind("--portfolio=", 0) == 0) {
+            portfolio_mode = true;
+            portfolio_spec = arg.substr(arg.find("=") + 1);
+        } else if (arg.rfind("--cash=", 0) == 0) {
+            if (!parse_int_value(arg, cash)) return 2;
+        } else if (arg.rfind("--fee=", 0) == 0) {
+            if (!parse_double_value(arg, execution.fee)) return 2;
+        } else if (arg.rfind("--slippage=", 0) == 0) {
+            if (!parse_double_value(arg, execution.slippage_bps)) return 2;
+        } else if (arg.rfind("--size=", 0) == 0) {
+            if (arg.back() != '%') {
+                std::cerr << "Error: '" << arg << "' must be a percent of equity, i.e. --size=25%\n";
+                return 2;
+            }
+
+            if (!parse_double_value(arg.substr(0, arg.size() - 1), execution.equity_percent)) return 2;
+
+            if (execution.equity_percent <= 0) {
+                std::cerr << "Error: Invalid position size\n";
+                return 2;
+            }
+        } else if (arg == "--next-bar") execution.delay = 1;
+        else if (arg == "--long-short") execution.shorts = true;
+        else if (arg == "--metrics") metrics = true;
+        else if (arg == "--profile" || arg.rfind("--profile=", 0) == 0) continue;   // handled above
+        else if (arg == "--serve") serve_mode = true;
+        else if (arg == "--precision") precision_mode = true;
+        else if (arg.rfind("--serve=", 0) == 0) {
+            serve_mode = true;
+            serve_socket_path = arg.substr(arg.find("=") + 1);
+        } else if (arg == "--monte-carlo") monte_carlo_mode = true;
+        else if (arg.rfind("--monte-carlo=", 0) == 0) {
+            monte_carlo_mode = true;
+            monte_carlo_spec = arg.substr(arg.find("=") + 1);
+        } else if (arg.rfind("--paths=", 0) == 0) {
+            if (!parse_int_value(arg, monte_carlo_options.paths)) return 2;
+        } else if (arg.rfind("--block=", 0) == 0) {
+            if (!parse_int_value(arg, monte_carlo_options.block)) return 2;
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            if (!parse_int_value(arg, seed)) return 2;
+        } else if (arg.rfind("--model=", 0) == 0) {
             try {
-                no_of_stocks = std::stoi(value);
+                monte_carlo_options.model = parse_model(std::string_view(arg).substr(arg.find("=") + 1));
             }
             catch (const std::invalid_argument& e) {
-                std::cerr << "Error: '" << arg << "' is not a valid integer\n";
+                std::cerr << "Error: " << e.what() << "\n";
                 return 2;
             }
-            catch (const std::out_of_range& e) {
-                std::cerr << "Error: '" << arg << "' is out of range for int\n";
+        } else if (arg.rfind("--combine=", 0) == 0) {
+            try {
+                combination = parse_combine(std::string_view(arg).substr(arg.find("=") + 1));
+            }
+            catch (const std::invalid_argument& e) {
+                std::cerr << "Error: " << e.what() << "\n";
                 return 2;
             }
-        } else if (arg.rfind("--ticker=", 0) == 0 || arg.rfind("-t=", 0) == 0) {
-            std::size_t splitter = arg.find("=");
-            ticker_symbol = arg.substr(splitter + 1);
-        } else if (arg == "--mode=backtest" || arg == "-m=backtest") indicator_mode = false;
-        else if (arg == "--mode=indicator" || arg == "-m=indicator") backtest_mode = false;
-        else if (arg == "--strategy=macd" || arg == "-s=macd") sma_on = false;
-        else if (arg == "--strategy=sma" || arg == "-s=sma") macd_on = false;
+        } else if (arg.rfind("--timeframe=", 0) == 0) {
+            try {
+                timeframe = parse_timeframe(std::string_view(arg).substr(arg.find("=") + 1));
+            }
+            catch (const std::invalid_argument& e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                return 2;
+            }
+        } else if (arg == "--fill=close") fill_open = false;
+        else if (arg == "--fill=open") fill_open = true;
+        else if (arg.rfind("--store=", 0) == 0) {
+            try {
+                store = parse_store(std::string_view(arg).substr(arg.find("=") + 1));
+            }
+            catch (const std::invalid_argument& e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                return 2;
+            }
+        }
+        else if (arg.rfind("--format=", 0) == 0) {
+            try {
+                format = parse_format(std::string_view(arg).substr(arg.find("=") + 1));
+            }
+            catch (const std::invalid_argument& e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                return 2;
+            }
+        }
         else {
             parser_error(argv[0]);
             return 2;
@@ -101,10 +404,334 @@ int main(int argc, char* argv[]) {
         return 2;
     }
 
-    std::vector<double> stock_data;
+    if (batch_mode + sweep_mode + walk_forward_mode + stream_mode + portfolio_mode + monte_carlo_mode + serve_mode + precision_mode > 1) {
+        std::cerr << "Error: conflicting modes specified\n"
+                  << " --batch --sweep --walk-forward --stream --portfolio --monte-carlo --serve --precision\n";
+
+        return 2;
+    }
+
+    if (format != OutputFormat::text && (sweep_mode || walk_forward_mode || stream_mode || portfolio_mode || monte_carlo_mode || serve_mode || precision_mode)) {
+        std::cerr << "Error: --format=json|csv is only supported for single runs and --batch\n";
+
+        return 2;
+    }
+
+    if (combination && (batch_mode || sweep_mode || walk_forward_mode || stream_mode || portfolio_mode || monte_carlo_mode || serve_mode || precision_mode)) {
+        std::cerr << "Error: --combine is only supported for single runs\n";
+
+        return 2;
+    }
+
+    if (!config_file.empty() && (!indicators.empty() || !sma_on || !macd_on)) {
+        std::cerr << "Error: --config lists the strategies itself; it cannot be combined with --strategy or --indicators\n";
+
+        return 2;
+    }
+
+    if (!indicators.empty() && (batch_mode || sweep_mode || walk_forward_mode || stream_mode || portfolio_mode || monte_carlo_mode || serve_mode || precision_mode)) {
+        std::cerr << "Error: --indicators is only supported for single runs\n";
+
+        return 2;
+    }
+
+    // --precision validates the SMA and MACD lines of a config with their periods
+    if (!config_file.empty() && (batch_mode || sweep_mode || walk_forward_mode || stream_mode || portfolio_mode || monte_carlo_mode || serve_mode)) {
+        std::cerr << "Error: --config is only supported for single runs and --precision\n";
+
+        return 2;
+    }
+
+    if (store != StoreType::doubles && (batch_mode || sweep_mode || walk_forward_mode || stream_mode || portfolio_mode || monte_carlo_mode || serve_mode || precision_mode)) {
+        std::cerr << "Error: --store is only supported for single runs\n";
+
+        return 2;
+    }
+
+    // the sweep grid, walk-forward, batch, portfolio and Monte Carlo MACDs are zero-line with default periods,
+    // and --serve requests name their own parameters
+    if (macd_options && (batch_mode || sweep_mode || walk_forward_mode || portfolio_mode || monte_carlo_mode || serve_mode)) {
+        std::cerr << "Error: --signal and --macd-cross are only supported for single runs, --stream and --precision\n";
+
+        return 2;
+    }
+
+    if (!result_dir.empty() && (batch_mode || sweep_mode || walk_forward_mode || stream_mode || portfolio_mode || monte_carlo_mode || serve_mode || precision_mode)) {
+        std::cerr << "Error: --result-cache is only supported for single runs\n";
+
+        return 2;
+    }
+
+    if (timeframe && (batch_mode || stream_mode || portfolio_mode || monte_carlo_mode || serve_mode)) {
+        std::cerr << "Error: --timeframe is only supported for single runs, --sweep and --walk-forward\n";
+
+        return 2;
+    }
+
+    if (metrics && (!backtest_mode || batch_mode || walk_forward_mode || stream_mode || portfolio_mode || monte_carlo_mode || serve_mode || precision_mode)) {
+        std::cerr << "Error: --metrics is only supported for backtests of single runs and --sweep\n";
+
+        return 2;
+    }
+
+    if (fill_open && (batch_mode || sweep_mode || walk_forward_mode || stream_mode || portfolio_mode || monte_carlo_mode || serve_mode || precision_mode)) {
+        std::cerr << "Error: --fill=open is only supported for single runs\n";
+
+        return 2;
+    }
+
+    // --cash is the portfolio's balance, or the starting equity of --size
+    if (execution.equity_percent > 0) execution.capital = cash;
+
+    if (!execution.frictionless() && (stream_mode || portfolio_mode || precision_mode)) {
+        std::cerr << "Error: --fee, --slippage, --size, --next-bar and --long-short are not supported with --stream, --portfolio or --precision\n";
+
+        return 2;
+    }
+
+    // a float or cents store reruns SMA and MACD on their own, frictionless
+    if (store != StoreType::doubles && (!indicators.empty() || combination || fill_open || metrics || !execution.frictionless())) {
+        std::cerr << "Error: --store=float|cents cannot be combined with --indicators, --combine, --fill=open, --metrics,"
+                  << " --fee, --slippage, --size, --next-bar or --long-short\n";
+
+        return 2;
+    }
+
+    try {
+        check_execution_model(execution);
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+
+        return 2;
+    }
+
+    PROFILE_STOP(parsing);
+
+    // stream mode: prices arrive one at a time and signals are emitted as they flip
+    if (stream_mode) {
+        StreamOptions options;
+        options.sma_on = sma_on;
+        options.macd_on = macd_on;
+        options.signal_period = signal_period;
+        options.macd_cross = macd_cross;
+        options.follow = follow;
+
+        std::ifstream file;
+
+        if (stream_source != "-") {
+            file.open(stream_source);
+
+            if (!file.is_open()) {
+                std::cerr << "Error: Failed to open file: '" << stream_source << "'\n";
+                return 3;
+            }
+        }
+
+        std::istream& in = (stream_source == "-") ? std::cin : file;
+
+        std::cout << "** Streaming signals for " << ticker_symbol << " **" << "\n\n";
+
+        try {
+            print_stream_summary(run_stream(in, std::cout, std::cerr, options), std::cout);
+        }
+        catch (const std::invalid_argument& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 2;
+        }
+
+        return 0;
+    }
+
+    // serve mode keeps every exported data file's series and strategies in memory and answers JSON
+    // requests, one per line, from stdin or a Unix socket
+    if (serve_mode) {
+        std::vector<std::string> files;
+
+        try {
+            files = find_data_files(DATA_DIR);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 3;
+        }
+
+        BacktestService service(files, use_cache, execution);
+        ThreadPool pool(threads);
+
+        std::cerr << "Serving " << service.get_tickers().size() << " tickers on " << pool.get_size() << " threads from "
+                  << ((serve_socket_path == "-") ? "stdin" : "'" + serve_socket_path + "'") << "\n";
+
+        if (serve_socket_path == "-") {
+            serve_stream(service, std::cin, std::cout, pool);
+        } else {
+            std::signal(SIGINT, request_stop);
+            std::signal(SIGTERM, request_stop);
+
+            try {
+                serve_socket(service, serve_socket_path, pool, stop_serving);
+            }
+            catch (const std::runtime_error& e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                return 3;
+            }
+        }
+
+        print_service_summary(service.get_summary(), std::cerr);
+
+        return 0;
+    }
+
+    // batch mode backtests every data file instead of temp.csv
+    if (batch_mode) {
+        if (no_of_stocks <= 0) {
+            std::cerr << "Error: Invalid number of stocks\n";
+            return 2;
+        }
+
+        std::vector<std::string> files;
+
+        try {
+            files = find_data_files(batch_spec);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 3;
+        }
+
+        if (files.empty()) {
+            std::cerr << "Error: no data files found for '" << batch_spec << "'\n";
+            return 3;
+        }
+
+        ThreadPool pool(threads);
+        std::vector<BatchReport> reports {run_batch(files, no_of_stocks, sma_on, macd_on, use_cache, pool, execution)};
+        std::string text {format_batch(reports, format)};
+
+        if (output_file.empty()) {
+            std::cout.write(text.data(), text.size());
+        } else {
+            std::ofstream out(output_file);
+
+            if (!out.is_open()) {
+                std::cerr << "Error: Failed to open file: '" << output_file << "'\n";
+                return 3;
+            }
+
+            out.write(text.data(), text.size());
+            std::cout << "Batch report for " << reports.size() << " files written to '" << output_file << "'\n";
+        }
+
+        return 0;
+    }
+
+    // portfolio mode trades every ticker found from one shared cash balance
+    if (portfolio_mode) {
+        if (cash <= 0) {
+            std::cerr << "Error: Invalid amount of cash\n";
+            return 2;
+        }
+
+        std::vector<std::string> files;
+
+        try {
+            files = find_data_files(portfolio_spec);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 3;
+        }
+
+        if (files.empty()) {
+            std::cerr << "Error: no data files found for '" << portfolio_spec << "'\n";
+            return 3;
+        }
+
+        ThreadPool pool(threads);
+
+        std::cout << "** Running portfolio backtest **" << "\n\n";
+
+        run_portfolio_files(files, cash, sma_on, macd_on, use_cache, pool, std::cout);
+
+        std::cout << "Note: transaction fees and dividends have not been factored in the calculations\n";
+
+        return 0;
+    }
+
+    // monte carlo mode backtests synthetic paths of every data file instead of temp.csv
+    if (monte_carlo_mode) {
+        if (no_of_stocks <= 0) {
+            std::cerr << "Error: Invalid number of stocks\n";
+            return 2;
+        }
+
+        if (monte_carlo_options.paths <= 0 || monte_carlo_options.block <= 0 || seed < 0) {
+            std::cerr << "Error: --paths and --block must be positive and --seed not negative\n";
+            return 2;
+        }
+
+        monte_carlo_options.seed = seed;
+
+        std::vector<std::string> files;
+
+        try {
+            files = find_data_files(monte_carlo_spec);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 3;
+        }
+
+        if (files.empty()) {
+            std::cerr << "Error: no data files found for '" << monte_carlo_spec << "'\n";
+            return 3;
+        }
+
+        ThreadPool pool(threads);
+
+        std::cout << "** Running Monte Carlo simulation **" << "\n\n"
+                  << " Simulating for: " << no_of_stocks << " stocks\n"
+                  << " Threads: " << pool.get_size() << "\n";
+
+        if (!execution.frictionless()) std::cout << " Execution: " << describe_execution(execution) << "\n";
+
+        std::cout << "\n";
+
+        print_monte_carlo(run_monte_carlo(files, no_of_stocks, sma_on, macd_on, use_cache, monte_carlo_options, pool, execution),
+                          monte_carlo_options, std::cout);
+
+        return 0;
+    }
+
+    std::string source {std::string(DATA_DIR) + "temp.csv"};
+    std::optional<ResultCache> result_cache;
+    std::string result_key;
+    std::optional<SourceStamp> known;
+    std::optional<SourceStamp> current;
+
+    // --result-cache: an identical earlier run on the same data already has the answer
+    if (!result_dir.empty()) {
+        result_cache.emplace(result_dir);
+        result_key = run_key(argc, argv);
+        known = result_cache->source(source);
+        current = stat_source(source);
+
+        // a data file unchanged since the cache last saw it is not even loaded
+        if (known && current && known->same_file(*current)) {
+            if (std::optional<std::string> text = result_cache->find(known->hash, result_key)) {
+                std::cout.write(text->data(), text->size());
+                std::cout.flush();
+
+                return 0;
+            }
+        }
+    }
+
+    // loaded series (memory-mapped from its binary cache when up to date)
+    std::optional<PriceSeries> series;
 
     try {
-        stock_data = read_file(std::string(DATA_DIR) + "temp.csv"); // read data file
+        series.emplace(load_prices(source, use_cache)); // read data file
     }
     catch (std::runtime_error& e) {
         std::cerr << "Error: " << e.what() << "\n";
@@ -112,32 +739,257 @@ int main(int argc, char* argv[]) {
         return 3;
     }
 
+    std::uint64_t data_hash {0};
+
+    // a rewritten file may still hold the same rows
+    if (result_cache) {
+        data_hash = hash_bars(series->bars());
+
+        if (current) {
+            current->rows = series->bars().size();
+            current->hash = data_hash;
+            result_cache->record(source, *current);
+        }
+
+        if (std::optional<std::string> text = result_cache->find(data_hash, result_key)) {
+            std::cout.write(text->data(), text->size());
+            std::cout.flush();
+
+            return 0;
+        }
+    }
+
+    // every bar of the run becomes one of the coarser timeframe (periods then count weeks, months, ...)
+    if (timeframe) {
+        try {
+            series.emplace(resample(series->bars(), *timeframe).bars);
+        }
+        catch (const std::invalid_argument& e) {
+            std::cerr << "Error: --timeframe: " << e.what() << "\n";
+
+            return 3;
+        }
+    }
+
+    const BarsView& bars {series->bars()};
+    PriceView stock_data {bars.close};
+
     int days_analysed = stock_data.size();
+    std::string bar_unit {(timeframe) ? " " + timeframe_name(*timeframe) + " bars" : " days"};
+
+    // sweep mode replaces the single 50/200 and 12/26 run with every pair of the requested ranges
+    if (sweep_mode) {
+        if (no_of_stocks <= 0) {
+            std::cerr << "Error: Invalid number of stocks\n";
+            return 2;
+        }
+
+        ThreadPool pool(threads);
+
+        std::cout << "** Running parameter sweep **" << "\n\n"
+                  << " Stock: " << ticker_symbol << "\n"
+                  << " Days Analysed: " << days_analysed << bar_unit << "\n"
+                  << " Threads: " << pool.get_size() << "\n";
+
+        if (!execution.frictionless()) std::cout << " Execution: " << describe_execution(execution) << "\n";
+
+        std::cout << "\n";
+
+        print_sweep(sweep(stock_data, short_range, long_range, no_of_stocks, sma_on, macd_on, pool, execution, metrics), top);
+
+        return 0;
+    }
+
+    // walk-forward mode picks the sweep's best periods on each train window and trades them on the next test window
+    if (walk_forward_mode) {
+        if (no_of_stocks <= 0) {
+            std::cerr << "Error: Invalid number of stocks\n";
+            return 2;
+        }
+
+        ThreadPool pool(threads);
+        std::vector<FoldResult> results;
 
-    MACD macd(stock_data);
-    SMA sma(stock_data);
+        try {
+            results = walk_forward(stock_data, short_range, long_range, no_of_stocks, sma_on, macd_on, walk_options, pool, execution);
+        }
+        catch (const std::invalid_argument& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 2;
+        }
+
+        std::cout << "** Running walk-forward backtest **" << "\n\n"
+                  << " Stock: " << ticker_symbol << "\n"
+                  << " Days Analysed: " << days_analysed << bar_unit << "\n"
+                  << " Threads: " << pool.get_size() << "\n";
+
+        if (!execution.frictionless()) std::cout << " Execution: " << describe_execution(execution) << "\n";
+
+        std::cout << "\n";
+
+        print_walk_forward(results, walk_options, std::cout);
+
+        return 0;
+    }
+
+    // latest SMA / MACD signals from saved streaming state: rows appended since the last run are the only
+    // ones pushed through the indicators (not for resampled bars, whose last bar can change with new rows)
+    if (result_cache && !backtest_mode && config_file.empty() && indicators.empty() && !combination && !fill_open
+        && !timeframe && store == StoreType::doubles) {
+        if (std::optional<IndicatorReport> signals = incremental_signals(*result_cache, bars, known, sma_on, macd_on,
+                                                                         signal_period, macd_cross)) {
+            RunReport report;
+            report.ticker = ticker_symbol;
+            report.current_price = stock_data.at(days_analysed - 1);
+            report.days = days_analysed;
+            report.stocks = no_of_stocks;
+            report.indicator = std::move(*signals);
+
+            std::string text {format_run(report, format)};
+            std::cout.write(text.data(), text.size());
+            std::cout.flush();
 
-    // optional TradingSim object to be defined later
-    std::optional<Simulator> sim;
+            result_cache->store(data_hash, result_key, text);
 
-    // conditional construction of sim object (based on user flags)
-    if (!macd_on) sim.emplace(sma, stock_data);
-    else if (!sma_on) sim.emplace(macd, stock_data);
-    else sim.emplace(sma, macd, stock_data);
+            return 0;
+        }
+    }
+
+    SimulationConfig config;
+
+    // a config file lists the strategies, their weights and the vote thresholds; otherwise they come from
+    // --strategy and --indicators with default parameters
+    if (!config_file.empty()) {
+        try {
+            config = load_config(config_file);
+        }
+        catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 3;
+        }
+        catch (const std::invalid_argument& e) {
+            std::cerr << "Error: '" << config_file << "': " << e.what() << "\n";
+            return 2;
+        }
+    } else {
+        if (sma_on) config.strategies.push_back({"sma", {}, "", 1});
+
+        if (macd_on) {
+            std::string cross {(macd_cross == MACD::Crossover::signal_line) ? "signal" : "zero"};
+            config.strategies.push_back({"macd", {{"signal", std::to_string(signal_period)}, {"cross", cross}}, "", 1});
+        }
+
+        for (const std::string& name : indicators) config.strategies.push_back({name, {}, "", 1});
+    }
+
+    if (combination && config.strategies.size() < 2) {
+        std::cerr << "Error: --combine needs at least two strategies\n";
+        return 2;
+    }
+
+    // every strategy reads its windows from one cache, so a statistic two of them use is computed once
+    SeriesCache cache {bars};
+    std::vector<StrategyEntry> strategies;
+
+    // series shorter than the long-term periods (or the signal line) cannot be analysed
+    try {
+        strategies = make_strategies(config, cache);
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+
+        return 3;
+    }
+
+    // precision mode checks the float and fixed-point kernels against the double SMA and MACD strategies on this data
+    if (precision_mode) {
+        if (no_of_stocks <= 0) {
+            std::cerr << "Error: Invalid number of stocks\n";
+            return 2;
+        }
+
+        std::vector<PrecisionCheck> checks;
+
+        try {
+            checks = validate_precision(stock_data, no_of_stocks, strategies);
+        }
+        catch (const std::invalid_argument& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 2;
+        }
+
+        std::cout << "** Running precision validation **" << "\n\n"
+                  << " Stock: " << ticker_symbol << "\n"
+                  << " Days Analysed: " << days_analysed << bar_unit << "\n"
+                  << " Simulating for: " << no_of_stocks << " stocks\n\n";
+
+        print_precision(checks, std::cout);
+
+        return 0;
+    }
+
+    if (backtest_mode && no_of_stocks <= 0) {
+        std::cerr << "Error: Invalid number of stocks\n";
+        return 2;
+    }
+
+    RunReport report;
+    report.ticker = ticker_symbol;
+    report.current_price = stock_data.at(days_analysed - 1);
+    report.days = days_analysed;
+    if (timeframe) report.timeframe = timeframe_name(*timeframe);
+    report.stocks = no_of_stocks;
+
+    // SMA and MACD rerun with every series and backtest on the float or cents store
+    auto run_on_store = [&](auto run) {
+        if (!config_file.empty()) run.set_vote(config.vote);
+        if (indicator_mode) report.indicator = run.indicator_report();
+        if (backtest_mode) report.backtest = run.backtest_report(no_of_stocks);
+    };
+
+    if (store != StoreType::doubles) {
+        try {
+            if (store == StoreType::floats) run_on_store(PrecisionRun<float>(std::move(strategies), stock_data));
+            else run_on_store(PrecisionRun<Cents>(std::move(strategies), stock_data));
+        }
+        catch (const std::invalid_argument& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 2;
+        }
+    } else {
+        std::optional<Simulator> sim;
+
+        sim.emplace(std::move(strategies), stock_data);
+
+        if (!config_file.empty()) sim->set_vote(config.vote);
+        if (combination) sim->set_combination(*combination);
+
+        sim->set_execution(execution);
+        sim->set_metrics(metrics);
+
+        if (fill_open) {
+            if (!bars.has_ohlc()) {
+                std::cerr << "Error: --fill=open needs data with an Open column (re-fetch it with fetch_ticker_data.py)\n";
+                return 3;
+            }
+
+            sim->set_open_fill(bars.open);
+        }
+
+        if (indicator_mode) report.indicator = sim->indicator_report();
+        if (backtest_mode) report.backtest = sim->backtest_report(no_of_stocks);
+    }
 
-    std::cout << "** Running tests **" << "\n\n"
-              << " Stock: " << ticker_symbol << "\n"
-              << " Current Price: " << stock_data.at(days_analysed - 1) << "\n"
-              << " Days Analysed: " << days_analysed << " days\n"
-              << " Simulating for: " << no_of_stocks << " stocks\n\n";
-    
-    if (indicator_mode) sim->indicator();
+    // the whole report is formatted first and reaches stdout in one write
+    PROFILE_TIMER(output, "format and write");
 
-    std::cout << "\n";
+    std::string text {format_run(report, format)};
+    std::cout.write(text.data(), text.size());
+    std::cout.flush();
 
-    if (backtest_mode) sim->backtest(no_of_stocks);
+    PROFILE_STOP(output);
 
-    std::cout << "\nNote: transaction fees and dividends have not been factored in the calculations\n";
+    if (result_cache) result_cache->store(data_hash, result_key, text);
 
     return 0;
 }
@@ -0,0 +1,74 @@
+#include "../include/mapped_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+
+MappedFile::MappedFile(std::string_view file_name) {
+    std::string name {file_name};
+    int fd = open(name.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+        std::ostringstream oss;
+        oss << "Failed to open file: '" << file_name << "'";
+
+        throw std::runtime_error(oss.str());
+    }
+
+    struct stat info {};
+
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+
+        std::ostringstream oss;
+        oss << "Failed to open file: '" << file_name << "'";
+
+        throw std::runtime_error(oss.str());
+    }
+
+    length = info.st_size;
+
+    // mmap rejects empty mappings; an empty file is simply an empty view
+    if (length > 0) {
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapped == MAP_FAILED) {
+            close(fd);
+
+            std::ostringstream oss;
+            oss << "Failed to map file: '" << file_name << "'";
+
+            throw std::runtime_error(oss.str());
+        }
+
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        ptr = static_cast<const char*>(mapped);
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (ptr) munmap(const_cast<char*>(ptr), length);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : ptr(std::exchange(other.ptr, nullptr)), length(std::exchange(other.length, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (ptr) munmap(const_cast<char*>(ptr), length);
+
+        ptr = std::exchange(other.ptr, nullptr);
+        length = std::exchange(other.length, 0);
+    }
+
+    return *this;
+}
@@ -0,0 +1,101 @@
+#include "../include/metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+
+Metrics compute_metrics(PriceView price, int start_day, int stocks, const std::uint8_t* mask,
+                        const ExecutionModel& execution, MetricsArena& arena) {
+    Metrics m;
+    int size = price.size();
+
+    if (start_day >= size) return m;
+
+    trade_ledger(price, start_day, stocks, mask, execution, arena.transitions, arena.ledger);
+
+    const std::vector<Trade>& ledger = arena.ledger;
+    int trades = ledger.size();
+    double base {execution.capital};
+
+    if (execution.equity_percent <= 0) {
+        base = (trades > 0) ? ledger[0].entry_price * std::abs(ledger[0].shares) : price[start_day] * stocks;
+    }
+
+    arena.equity.resize(size - start_day);
+
+    double* equity = arena.equity.data();
+    double realized {0};
+    double peak {base};
+    double previous {base};
+    double drawdown {0};
+    // plain sums of the daily returns and their squares: returns are small and close to 0, so the
+    // one-pass variance loses nothing worth Welford's division per day
+    double sum {0};
+    double squares {0};
+    double downside {0};
+    int returns {0};
+    int held {0};
+    int k {0};
+
+    // equity = starting equity + closed P&L + the open position marked at the day's price (its entry fee
+    // paid; a short's shares are negative, so it gains as the price falls)
+    for (int d = start_day; d < size; d++) {
+        while (k < trades && ledger[k].exit_day <= d) realized += ledger[k++].pnl;
+
+        double value {base + realized};
+
+        if (k < trades && ledger[k].entry_day <= d) {
+            value += (price[d] - ledger[k].entry_price) * ledger[k].shares - execution.fee;
+            held++;
+        }
+
+        equity[d - start_day] = value;
+
+        if (d > start_day && previous > 0) {
+            double r = value / previous - 1;
+
+            returns++;
+            sum += r;
+            squares += r * r;
+            downside += (r < 0) ? r * r : 0.0;
+        }
+
+        // divides only on a new deepest drawdown
+        peak = std::max(peak, value);
+        if (peak - value > drawdown * peak) drawdown = (peak - value) / peak;
+
+        previous = value;
+    }
+
+    int wins {0};
+    for (const Trade& t : ledger) wins += (t.pnl > 0);
+
+    double mean = (returns > 0) ? sum / returns : 0.0;
+    double variance = (returns > 1) ? (squares - sum * mean) / (returns - 1) : 0.0;
+    double stdev = (variance > squares * 1e-12) ? std::sqrt(variance) : 0.0;     // below that: rounding noise
+    double downside_deviation = (returns > 0) ? std::sqrt(downside / returns) : 0.0;
+    double years = (size - 1 - start_day) / TRADING_DAYS;
+
+    m.trades = trades;
+    m.win_rate = (trades > 0) ? 100.0 * wins / trades : 0.0;
+    m.exposure = 100.0 * held / (size - start_day);
+    m.final_equity = previous;
+    m.total_return = (m.final_equity / base - 1) * 100;
+    m.max_drawdown = drawdown * 100;
+    m.sharpe = (stdev > 0) ? mean / stdev * std::sqrt(TRADING_DAYS) : 0.0;
+    m.sortino = (downside_deviation > 0) ? mean / downside_deviation * std::sqrt(TRADING_DAYS) : 0.0;
+
+    // a wiped-out account has no growth rate to compound: -100%
+    if (m.final_equity <= 0) m.cagr = -100;
+    else if (years > 0) m.cagr = (std::pow(m.final_equity / base, 1 / years) - 1) * 100;
+
+    return m;
+}
+
+Metrics buy_and_hold_metrics(PriceView price, int stocks, const ExecutionModel& execution, MetricsArena& arena) {
+    // always in the market: a buy on day 0, closed on the last day
+    arena.mask.assign(price.size(), 1);
+
+    return compute_metrics(price, 0, stocks, arena.mask.data(), execution, arena);
+}
@@ -0,0 +1,476 @@
+#include "../include/monte_carlo.h"
+#include "../include/profile.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include "../include/rolling.h"
+#include "../include/ema.h"
+#include "../include/batch.h"
+#include "../include/price_cache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+PathModel parse_model(std::string_view name) {
+    if (name == "bootstrap") return PathModel::bootstrap;
+    if (name == "gbm") return PathModel::gbm;
+
+    throw std::invalid_argument("Unknown path model '" + std::string(name) + "' (expected bootstrap or gbm)");
+}
+
+
+PathGenerator::PathGenerator(PriceView price, PathModel m, int b) : model(m), block(b) {
+    if (price.size() < 2) throw std::invalid_argument("Monte Carlo paths need at least two prices");
+    if (block <= 0) throw std::invalid_argument("Bootstrap block length must be positive");
+
+    int size = price.size();
+    double sum {0};
+
+    first = price[0];
+    ratios.reserve(size - 1);
+
+    for (int i = 1; i < size; i++) {
+        if (!(price[i - 1] > 0) || !(price[i] > 0)) throw std::invalid_argument("Monte Carlo paths need positive prices");
+
+        ratios.push_back(price[i] / price[i - 1]);
+        sum += std::log(ratios.back());
+    }
+
+    int count = ratios.size();
+    double squares {0};
+
+    drift = sum / count;
+
+    for (double r : ratios) squares += (std::log(r) - drift) * (std::log(r) - drift);
+
+    volatility = (count > 1) ? std::sqrt(squares / (count - 1)) : 0.0;
+}
+
+void PathGenerator::generate(std::mt19937_64& rng, double* out) const {
+    int count = ratios.size();
+
+    out[0] = first;
+
+    if (model == PathModel::gbm) {
+        std::normal_distribution<double> normal(0.0, 1.0);
+
+        for (int i = 1; i <= count; i++) out[i] = out[i - 1] * std::exp(drift + volatility * normal(rng));
+
+        return;
+    }
+
+    // moving block bootstrap: concatenate randomly placed runs of `length` consecutive returns
+    int length = std::min(block, count);
+    std::uniform_int_distribution<int> start(0, count - length);
+
+    for (int i = 1; i <= count;) {
+        const double* run = ratios.data() + start(rng);
+
+        for (int k = 0; k < length && i <= count; k++, i++) out[i] = out[i - 1] * run[k];
+    }
+}
+
+
+// splitmix64 finalizer: nearby (seed, index) pairs give unrelated RNG states
+std::uint64_t task_seed(std::uint64_t seed, std::uint64_t index) {
+    std::uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ull;
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return z ^ (z >> 31);
+}
+
+
+// linear interpolation between the closest ranks of a sorted sample
+static double percentile(const std::vector<double>& sorted, double q) {
+    double rank = q * (sorted.size() - 1);
+    std::size_t lower = static_cast<std::size_t>(rank);
+    std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - lower);
+}
+
+Distribution summarize(std::vector<double>& values) {
+    Distribution d;
+
+    if (values.empty()) return d;
+
+    std::sort(values.begin(), values.end());
+
+    double sum {0};
+    for (double v : values) sum += v;
+
+    d.mean = sum / values.size();
+
+    double squares {0};
+    for (double v : values) squares += (v - d.mean) * (v - d.mean);
+
+    d.stdev = (values.size() > 1) ? std::sqrt(squares / (values.size() - 1)) : 0.0;
+    d.min = values.front();
+    d.p5 = percentile(values, 0.05);
+    d.median = percentile(values, 0.5);
+    d.p95 = percentile(values, 0.95);
+    d.max = values.back();
+
+    return d;
+}
+
+
+SampleSummary::SampleSummary(double low, double high)
+    : lower(low), width((high - low) / SUMMARY_BINS), bins(SUMMARY_BINS + 2)
+{
+    if (!(low < high)) throw std::invalid_argument("Summary range must not be empty");
+}
+
+void SampleSummary::add(double x) {
+    // Welford update: no sum of squares to cancel away the variance of large values
+    double delta {x - mean};
+
+    n++;
+    mean += delta / n;
+    m2 += delta * (x - mean);
+    min = (n == 1) ? x : std::min(min, x);
+    max = (n == 1) ? x : std::max(max, x);
+
+    double index {std::floor((x - lower) / width) + 1};
+    Bin& bin = bins[static_cast<int>(std::clamp(index, 0.0, SUMMARY_BINS + 1.0))];
+
+    bin.low = (bin.count == 0) ? x : std::min(bin.low, x);
+    bin.high = (bin.count == 0) ? x : std::max(bin.high, x);
+    bin.count++;
+}
+
+void SampleSummary::merge(const SampleSummary& other) {
+    if (other.n == 0) return;
+
+    if (n == 0) {
+        mean = other.mean;
+        m2 = other.m2;
+        min = other.min;
+        max = other.max;
+    } else {
+        // pairwise (Chan et al.) combination of the two means and squared differences
+        double total = static_cast<double>(n + other.n);
+        double delta {other.mean - mean};
+
+        mean += delta * other.n / total;
+        m2 += other.m2 + delta * delta * n * other.n / total;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    n += other.n;
+
+    for (std::size_t b = 0; b < bins.size(); b++) {
+        const Bin& from = other.bins[b];
+        Bin& to = bins[b];
+
+        if (from.count == 0) continue;
+
+        to.low = (to.count == 0) ? from.low : std::min(to.low, from.low);
+        to.high = (to.count == 0) ? from.high : std::max(to.high, from.high);
+        to.count += from.count;
+    }
+}
+
+double SampleSummary::value_at(std::uint64_t i) const {
+    std::uint64_t seen {0};
+
+    // the values of a bin are spread evenly from its lowest to its highest
+    for (const Bin& bin : bins) {
+        if (i < seen + bin.count) {
+            double position = (bin.count > 1) ? static_cast<double>(i - seen) / (bin.count - 1) : 0.0;
+
+            return bin.low + (bin.high - bin.low) * position;
+        }
+
+        seen += bin.count;
+    }
+
+    return max;
+}
+
+Distribution SampleSummary::distribution() const {
+    Distribution d;
+
+    if (n == 0) return d;
+
+    auto percentile = [this](double q) {
+        double rank = q * (n - 1);
+        std::uint64_t low = static_cast<std::uint64_t>(rank);
+        std::uint64_t high = std::min(low + 1, n - 1);
+        double a {value_at(low)};
+
+        return a + (value_at(high) - a) * (rank - low);
+    };
+
+    d.mean = mean;
+    d.stdev = (n > 1) ? std::sqrt(m2 / (n - 1)) : 0.0;
+    d.min = min;
+    d.p5 = percentile(0.05);
+    d.median = percentile(0.5);
+    d.p95 = percentile(0.95);
+    d.max = max;
+
+    return d;
+}
+
+
+// histogram range for a quantity whose first values are `sample`: their span again on either side
+static SampleSummary summary_for(const std::vector<double>& sample) {
+    auto [low, high] = std::minmax_element(sample.begin(), sample.end());
+    double span {*high - *low};
+
+    if (span == 0) span = std::max(std::abs(*low), 1.0);
+
+    return SampleSummary(*low - span, *high + span);
+}
+
+
+MonteCarloReport monte_carlo(PriceView price, int stocks, bool sma_on, bool macd_on,
+                             const MonteCarloOptions& options, ThreadPool& pool,
+                             const ExecutionModel& execution) {
+    if (stocks <= 0) throw std::invalid_argument("Error: Invalid number of stocks");
+    if (options.paths <= 0 || options.batch <= 0) throw std::invalid_argument("Number of paths must be positive");
+
+    PROFILE_SCOPE("monte carlo");
+
+    MonteCarloReport report;
+    PathGenerator generator(price, options.model, options.block);
+    std::optional<SMA> sma;
+    std::optional<MACD> macd;
+
+    report.days = price.size();
+
+    if (sma_on) sma.emplace(price);
+    if (macd_on) macd.emplace(price);
+
+    // same common start day as Simulator and --batch, so the actual row matches a single run
+    int start_day = std::max((sma) ? sma->first_signal_day() : 0, (macd) ? macd->first_signal_day() : 0);
+
+    if (sma) report.strategies.push_back({"SMA", backtest_vectorized(price, start_day, stocks, sma->signal(), execution), {}, {}, 0, 0});
+    if (macd) report.strategies.push_back({"MACD", backtest_vectorized(price, start_day, stocks, macd->signal(), execution), {}, {}, 0, 0});
+
+    report.strategies.push_back({"Buy and hold", backtest_buy_and_hold(price, stocks, execution), {}, {}, 0, 0});
+
+    int count = report.strategies.size();
+    int paths = options.paths;
+    int tasks = (paths + options.batch - 1) / options.batch;
+    int size = price.size();
+
+    // every path of `task` in order, calling record(k, result) for each strategy k
+    auto evaluate = [&](int task, auto&& record) {
+        std::mt19937_64 rng(task_seed(options.seed, task));
+        std::vector<double> path(size);
+        PriceView view {path};
+        int end = std::min(paths, (task + 1) * options.batch);
+
+        // the lines SMA and MACD would allocate for every path, allocated once per task
+        std::vector<double> short_avg(size + 1);
+        std::vector<double> long_avg(size + 1);
+        std::vector<double> short_ema(size);
+        std::vector<double> long_ema(size);
+        std::vector<double> macd_line(size);
+        std::optional<RollingWindow> short_window;
+        std::optional<RollingWindow> long_window;
+
+        if (sma) short_window.emplace(sma->get_short_term());
+        if (sma) long_window.emplace(sma->get_long_term());
+
+        for (int p = task * options.batch; p < end; p++) {
+            BacktestResult results[3];
+            int n {0};
+
+            generator.generate(rng, path.data());
+
+            if (sma) {
+                rolling_mean_into(view, *short_window, short_avg.data());
+                rolling_mean_into(view, *long_window, long_avg.data());
+                results[n++] = backtest_vectorized(view, start_day, stocks, SMA::Signal {short_avg.data(), long_avg.data()}, execution);
+            }
+
+            if (macd) {
+                ema_into(view, macd->get_short_term(), short_ema.data());
+                ema_into(view, macd->get_long_term(), long_ema.data());
+
+                for (int i = macd->get_long_term() - 1; i < size; i++) macd_line[i] = short_ema[i] - long_ema[i];
+
+                results[n++] = backtest_vectorized(view, start_day, stocks, MACD::Signal {macd_line.data()}, execution);
+            }
+
+            results[n] = backtest_buy_and_hold(view, stocks, execution);
+
+            for (int k = 0; k < count; k++) record(k, results[k]);
+        }
+    };
+
+    // one task's (or all tasks') results, per strategy
+    struct Totals {
+        std::vector<SampleSummary> profit;
+        std::vector<SampleSummary> transactions;
+        std::vector<std::uint64_t> wins;
+        std::vector<std::uint64_t> beats;
+    };
+
+    // the first batch runs alone and sets the histogram ranges of every later one
+    std::vector<std::vector<double>> first_profit(count);
+    std::vector<std::vector<double>> first_transactions(count);
+
+    evaluate(0, [&](int k, const BacktestResult& r) {
+        first_profit[k].push_back(r.profit);
+        first_transactions[k].push_back(r.transactions);
+    });
+
+    Totals empty;
+
+    for (int k = 0; k < count; k++) {
+        empty.profit.push_back(summary_for(first_profit[k]));
+        empty.transactions.push_back(summary_for(first_transactions[k]));
+    }
+
+    empty.wins.assign(count, 0);
+    empty.beats.assign(count, 0);
+
+    Totals total {empty};
+
+    auto record = [&](Totals& t, int k, double profit, double transactions) {
+        t.profit[k].add(profit);
+        t.transactions[k].add(transactions);
+        t.wins[k] += (profit > 0);
+        t.beats[k] += (profit >= report.strategies[k].actual.profit);
+    };
+
+    for (int k = 0; k < count; k++) {
+        for (std::size_t i = 0; i < first_profit[k].size(); i++) record(total, k, first_profit[k][i], first_transactions[k][i]);
+    }
+
+    // the rest in waves of a few tasks per worker, folded in task order so sums round the same way
+    // on any number of threads
+    int wave = 2 * pool.get_size();
+    std::vector<Totals> slots;
+
+    for (int first = 1; first < tasks; first += wave) {
+        int last = std::min(tasks, first + wave);
+
+        slots.assign(last - first, empty);
+
+        parallel_for(pool, first, last, [&](int task) {
+            Totals& t = slots[task - first];
+
+            evaluate(task, [&](int k, const BacktestResult& r) { record(t, k, r.profit, r.transactions); });
+        });
+
+        for (const Totals& t : slots) {
+            for (int k = 0; k < count; k++) {
+                total.profit[k].merge(t.profit[k]);
+                total.transactions[k].merge(t.transactions[k]);
+                total.wins[k] += t.wins[k];
+                total.beats[k] += t.beats[k];
+            }
+        }
+    }
+
+    for (int k = 0; k < count; k++) {
+        MonteCarloStrategy& s = report.strategies[k];
+
+        s.win_rate = static_cast<double>(total.wins[k]) / paths;
+        s.beat_actual = static_cast<double>(total.beats[k]) / paths;
+        s.profit = total.profit[k].distribution();
+        s.transactions = total.transactions[k].distribution();
+    }
+
+    return report;
+}
+
+std::vector<MonteCarloReport> run_monte_carlo(const std::vector<std::string>& files, int stocks, bool sma_on,
+                                              bool macd_on, bool use_cache, const MonteCarloOptions& options,
+                                              ThreadPool& pool, const ExecutionModel& execution) {
+    std::vector<MonteCarloReport> reports;
+
+    // files one after another: the pool is busy with the paths of the current one
+    for (const std::string& file : files) {
+        MonteCarloReport report;
+        std::string ticker;
+        std::string period;
+
+        parse_data_file_name(file, ticker, period);
+
+        try {
+            PriceSeries series {load_prices(file, use_cache)};
+
+            report = monte_carlo(series.prices(), stocks, sma_on, macd_on, options, pool, execution);
+        }
+        catch (const std::exception& e) {
+            report.error = e.what();
+        }
+
+        report.ticker = ticker;
+        report.period = period;
+        report.path = file;
+        reports.push_back(report);
+    }
+
+    return reports;
+}
+
+void print_monte_carlo(const std::vector<MonteCarloReport>& reports, const MonteCarloOptions& options, std::ostream& out) {
+    out << " [ Monte Carlo ]" << "\n\n"
+        << " Model: ";
+
+    if (options.model == PathModel::bootstrap) out << "block bootstrap of daily returns (" << options.block << "-day blocks)";
+    else out << "geometric Brownian motion (fitted drift and volatility)";
+
+    out << "\n"
+        << " Paths: " << options.paths << " per series, seed " << options.seed << "\n";
+
+    for (const MonteCarloReport& r : reports) {
+        out << "\n " << r.ticker;
+
+        if (!r.period.empty()) out << " (" << r.period << ")";
+
+        if (!r.error.empty()) {
+            out << "\n Error: " << r.error << "\n";
+            continue;
+        }
+
+        out << ", " << r.days << " days\n\n"
+            << std::left
+            << " " << std::setw(14) << "Strategy"
+            << std::setw(12) << "Actual"
+            << std::setw(12) << "Mean"
+            << std::setw(12) << "Stdev"
+            << std::setw(12) << "5%"
+            << std::setw(12) << "Median"
+            << std::setw(12) << "95%"
+            << std::setw(12) << "Profitable"
+            << std::setw(12) << ">= Actual"
+            << "Trades" << "\n";
+
+        for (const MonteCarloStrategy& s : r.strategies) {
+            out << " " << std::setw(14) << s.strategy
+                << std::setw(12) << s.actual.profit
+                << std::setw(12) << s.profit.mean
+                << std::setw(12) << s.profit.stdev
+                << std::setw(12) << s.profit.p5
+                << std::setw(12) << s.profit.median
+                << std::setw(12) << s.profit.p95
+                << std::setw(12) << std::to_string(static_cast<int>(std::lround(s.win_rate * 100))) + "%"
+                << std::setw(12) << std::to_string(static_cast<int>(std::lround(s.beat_actual * 100))) + "%"
+                << s.transactions.mean << "\n";
+        }
+
+        out << std::right;
+    }
+
+    out << "\n Profitable: share of paths with a profit. >= Actual: share of paths doing at least as well\n"
+        << " as the real series; a small share means the result is unlikely to be luck.\n";
+}
@@ -0,0 +1,278 @@
+#include "../include/portfolio.h"
+#include "../include/profile.h"
+#include "../include/batch.h"
+#include "../include/price_cache.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+Portfolio::Portfolio(const std::vector<PortfolioInput>& inputs, double cash)
+    : symbols(inputs.size()), initial_cash(cash)
+{
+    if (inputs.empty()) throw std::invalid_argument("Portfolio needs at least one symbol");
+    if (cash <= 0) throw std::invalid_argument("Initial cash must be positive");
+
+    for (const PortfolioInput& input : inputs) {
+        if (input.price.empty()) throw std::invalid_argument("No price data for '" + input.ticker + "'");
+        if (input.signal.size() != input.price.size()) {
+            throw std::invalid_argument("Signal and price lengths differ for '" + input.ticker + "'");
+        }
+
+        tickers.push_back(input.ticker);
+    }
+
+    bool dated = std::all_of(inputs.begin(), inputs.end(), [](const PortfolioInput& input) {
+        return input.timestamps.size() == input.price.size();
+    });
+
+    if (dated) align_by_date(inputs);
+    else align_by_end(inputs);
+}
+
+// shared timeline = union of every symbol's dates; a symbol missing a date carries its last bar forward
+// a symbol whose data ends before the timeline does is sold on its last bar and inactive (price 0) after it
+void Portfolio::align_by_date(const std::vector<PortfolioInput>& inputs) {
+    std::vector<std::int64_t> timeline;
+
+    for (const PortfolioInput& input : inputs) timeline.insert(timeline.end(), input.timestamps.begin(), input.timestamps.end());
+
+    std::sort(timeline.begin(), timeline.end());
+    timeline.erase(std::unique(timeline.begin(), timeline.end()), timeline.end());
+
+    days = timeline.size();
+    prices.assign(static_cast<std::size_t>(days) * symbols, 0.0);
+    signals.assign(static_cast<std::size_t>(days) * symbols, 0);
+
+    for (int k = 0; k < symbols; k++) {
+        const PortfolioInput& input = inputs[k];
+        std::size_t next {0};
+        double last_price {0};
+        std::uint8_t last_signal {0};
+
+        std::int64_t end {input.timestamps.back()};
+
+        for (int d = 0; d < days && timeline[d] <= end; d++) {
+            while (next < input.timestamps.size() && input.timestamps[next] <= timeline[d]) {
+                last_price = input.price[next];
+                last_signal = input.signal[next];
+                next++;
+            }
+
+            prices[static_cast<std::size_t>(d) * symbols + k] = last_price;
+            signals[static_cast<std::size_t>(d) * symbols + k] = (timeline[d] < end || end == timeline.back()) ? last_signal : 0;
+        }
+    }
+}
+
+// without dates, every series is assumed to end on the same (latest) day
+void Portfolio::align_by_end(const std::vector<PortfolioInput>& inputs) {
+    days = 0;
+
+    for (const PortfolioInput& input : inputs) days = std::max<int>(days, input.price.size());
+
+    prices.assign(static_cast<std::size_t>(days) * symbols, 0.0);
+    signals.assign(static_cast<std::size_t>(days) * symbols, 0);
+
+    for (int k = 0; k < symbols; k++) {
+        const PortfolioInput& input = inputs[k];
+        int offset = days - input.price.size();
+
+        for (std::size_t i = 0; i < input.price.size(); i++) {
+            prices[(offset + i) * symbols + k] = input.price[i];
+            signals[(offset + i) * symbols + k] = input.signal[i];
+        }
+    }
+}
+
+PortfolioResult Portfolio::run() const {
+    PortfolioResult result;
+    std::vector<double> shares(symbols, 0.0);
+    std::vector<double> cost(symbols, 0.0);         // cash spent on the open position
+    std::vector<double> realised(symbols, 0.0);
+    double cash {initial_cash};
+    double peak {initial_cash};
+    double max_drawdown {0};
+
+    result.tickers = tickers;
+    result.initial_cash = initial_cash;
+    result.days = days;
+    result.equity.resize(days);
+
+    for (int d = 0; d < days; d++) {
+        const double* price = prices.data() + static_cast<std::size_t>(d) * symbols;
+        const std::uint8_t* signal = signals.data() + static_cast<std::size_t>(d) * symbols;
+
+        // sells first so their proceeds can fund today's buys
+        for (int k = 0; k < symbols; k++) {
+            if (shares[k] > 0 && !signal[k]) {
+                double proceeds = shares[k] * price[k];
+
+                cash += proceeds;
+                realised[k] += proceeds - cost[k];
+                shares[k] = 0;
+                cost[k] = 0;
+                result.trades++;
+            }
+        }
+
+        double holdings {0};
+
+        for (int k = 0; k < symbols; k++) holdings += shares[k] * price[k];
+
+        double slot = (cash + holdings) / symbols;
+
+        for (int k = 0; k < symbols; k++) {
+            if (shares[k] == 0 && signal[k] && price[k] > 0 && cash > 0) {
+                double spend = std::min(slot, cash);
+
+                shares[k] = spend / price[k];
+                cost[k] = spend;
+                cash -= spend;
+                holdings += spend;
+                result.trades++;
+            }
+        }
+
+        double equity = cash + holdings;
+
+        result.equity[d] = equity;
+        peak = std::max(peak, equity);
+        max_drawdown = std::max(max_drawdown, (peak - equity) / peak);
+    }
+
+    const double* last = prices.data() + static_cast<std::size_t>(days - 1) * symbols;
+
+    result.pnl.resize(symbols);
+
+    for (int k = 0; k < symbols; k++) result.pnl[k] = realised[k] + shares[k] * last[k] - cost[k];
+
+    result.final_equity = result.equity.back();
+    result.return_percent = (result.final_equity / initial_cash - 1) * 100;
+    result.max_drawdown_percent = max_drawdown * 100;
+
+    return result;
+}
+
+
+void print_portfolio(const PortfolioResult& result, const std::string& strategy, std::ostream& out) {
+    out << " [ Portfolio Backtest: " << strategy << " ]" << "\n\n"
+        << " Symbols: " << result.tickers.size() << "\n"
+        << " Days: " << result.days << "\n"
+        << " Trades: " << result.trades << "\n"
+        << std::fixed << std::setprecision(2)
+        << " Initial cash: $" << result.initial_cash << "\n"
+        << " Final equity: $" << result.final_equity << "\n"
+        << " Return: " << std::showpos << result.return_percent << "%" << std::noshowpos << "\n"
+        << " Max drawdown: -" << result.max_drawdown_percent << "%" << "\n\n"
+        << std::left << " " << std::setw(10) << "Ticker" << "P&L" << "\n";
+
+    for (std::size_t k = 0; k < result.tickers.size(); k++) {
+        out << " " << std::setw(10) << result.tickers[k] << std::showpos << result.pnl[k] << std::noshowpos << "\n";
+    }
+
+    out << std::right << std::defaultfloat << std::setprecision(6);
+}
+
+
+// hold/flat state of a strategy for every day of its series (flat before its first signal day)
+static std::vector<std::uint8_t> strategy_signal(const Strategy& strategy, int size) {
+    std::vector<std::uint8_t> signal(size, 0);
+
+    for (int day = strategy.first_signal_day(); day < size; day++) signal[day] = strategy.indicator(day);
+
+    return signal;
+}
+
+void run_portfolio_files(const std::vector<std::string>& files, double cash, bool sma_on, bool macd_on,
+                         bool use_cache, ThreadPool& pool, std::ostream& out) {
+    PROFILE_SCOPE("portfolio");
+
+    int count = files.size();
+    std::vector<std::optional<PriceSeries>> series(count);
+    std::vector<std::string> errors(count);
+    std::vector<std::string> tickers(count);
+
+    parallel_for(pool, 0, count, [&](int i) {
+        std::string period;
+        parse_data_file_name(files[i], tickers[i], period);
+
+        try {
+            series[i].emplace(load_prices(files[i], use_cache));
+        }
+        catch (const std::exception& e) {
+            errors[i] = e.what();
+        }
+    });
+
+    // one symbol per ticker: the file with the longest history wins
+    std::map<std::string, int> chosen;
+
+    for (int i = 0; i < count; i++) {
+        if (!series[i]) continue;
+
+        auto it = chosen.find(tickers[i]);
+
+        if (it == chosen.end() || series[i]->prices().size() > series[it->second]->prices().size()) {
+            chosen[tickers[i]] = i;
+        }
+    }
+
+    for (int strategy = 0; strategy < 2; strategy++) {
+        bool is_sma = (strategy == 0);
+
+        if ((is_sma && !sma_on) || (!is_sma && !macd_on)) continue;
+
+        std::vector<PortfolioInput> inputs(chosen.size());
+        std::vector<int> source;
+
+        for (const auto& entry : chosen) source.push_back(entry.second);
+
+        parallel_for(pool, 0, source.size(), [&](int k) {
+            const PriceSeries& s = *series[source[k]];
+            PortfolioInput& input = inputs[k];
+            int size = s.prices().size();
+
+            input.ticker = tickers[source[k]];
+            input.price = s.prices();
+            input.timestamps = s.timestamps();
+
+            // series too short for the strategy never trade
+            try {
+                if (is_sma) input.signal = strategy_signal(SMA(s.prices()), size);
+                else input.signal = strategy_signal(MACD(s.prices()), size);
+            }
+            catch (const std::invalid_argument&) {
+                input.signal.assign(size, 0);
+            }
+        });
+
+        if (inputs.empty()) break;
+
+        Portfolio portfolio(inputs, cash);
+
+        print_portfolio(portfolio.run(), (is_sma) ? "SMA (50/200)" : "MACD (12/26)", out);
+        out << "\n";
+    }
+
+    bool failed = std::any_of(errors.begin(), errors.end(), [](const std::string& e) { return !e.empty(); });
+
+    if (chosen.empty()) out << " No data files could be loaded\n";
+    if (!failed) return;
+
+    out << " Failed files:" << "\n";
+
+    for (int i = 0; i < count; i++) {
+        if (!errors[i].empty()) out << "  " << files[i] << ": " << errors[i] << "\n";
+    }
+}
@@ -0,0 +1,485 @@
+#include "../include/precision.h"
+#include "../include/SMA.h"
+#include "../include/profile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+// a / b rounded to the nearest integer, halves away from zero (b > 0)
+static Cents rounded_divide(Cents a, Cents b) {
+    return (a >= 0) ? (a + b / 2) / b : -((-a + b / 2) / b);
+}
+
+// how each value type sums, averages and smooths
+template <typename T>
+struct Arithmetic;
+
+template <>
+struct Arithmetic<float> {
+    using Sum = double;         // a float running sum would drift over long series
+
+    static constexpr const char* name {"float"};
+
+    static float from(double x) { return static_cast<float>(x); }
+    static float mean(double sum, int n) { return static_cast<float>(sum / n); }
+    static float next_ema(float ema, float x, int t) {
+        float k {2.0f / (t + 1)};
+
+        return (x * k) + (ema * (1 - k));
+    }
+    static double units(double sum) { return sum; }
+};
+
+template <>
+struct Arithmetic<Cents> {
+    using Sum = Cents;          // exact
+
+    static constexpr const char* name {"cents"};
+
+    static Cents from(double x) {
+        if (std::abs(x) > MAX_CENTS_PRICE) throw std::invalid_argument("cannot be stored in whole cents");
+
+        return std::llround(x * CENTS_PER_UNIT);
+    }
+    static Cents mean(Cents sum, int n) { return rounded_divide(sum, n); }
+    static Cents next_ema(Cents ema, Cents x, int t) { return ema + rounded_divide((x - ema) * 2, t + 1); }
+    static double units(Cents sum) { return sum / CENTS_PER_UNIT; }
+};
+
+
+template <typename T>
+std::vector<T> to_precision(PriceView p) {
+    std::vector<T> out(p.size());
+
+    for (std::size_t i = 0; i < p.size(); i++) {
+        try {
+            if (!std::isfinite(p[i])) throw std::invalid_argument("is not a finite number");
+
+            out[i] = Arithmetic<T>::from(p[i]);
+        }
+        catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("Price " + std::to_string(i) + " " + e.what());
+        }
+    }
+
+    return out;
+}
+
+template <typename T>
+double to_double(T value) {
+    return Arithmetic<T>::units(value);
+}
+
+
+template <typename T>
+std::vector<T> precision_mean(ColumnView<T> p, int window) {
+    if (window <= 0) throw std::invalid_argument("Rolling window size must be positive");
+
+    int size = p.size();
+    std::vector<T> result(size + 1);
+    typename Arithmetic<T>::Sum sum {};
+
+    for (int i = 0; i < size; i++) {
+        sum += p[i];
+
+        if (i >= window) sum -= p[i - window];
+        if (i + 1 >= window) result[i + 1] = Arithmetic<T>::mean(sum, window);
+    }
+
+    return result;
+}
+
+template <typename T>
+std::vector<T> precision_ema(ColumnView<T> p, int t) {
+    int size = p.size();
+
+    if (t <= 0) throw std::invalid_argument("t must be positive");
+    if (t > size) throw std::invalid_argument("EMA period cannot be larger than data size");
+
+    std::vector<T> out(size);
+    typename Arithmetic<T>::Sum sum {};
+
+    for (int i = 0; i < t; i++) sum += p[i];
+
+    T EMA {Arithmetic<T>::mean(sum, t)};
+
+    out[t - 1] = EMA;
+
+    for (int i = t; i < size; i++) {
+        EMA = Arithmetic<T>::next_ema(EMA, p[i], t);
+        out[i] = EMA;
+    }
+
+    return out;
+}
+
+// the same lines as MACD::build_lines, in T
+template <typename T>
+std::vector<T> precision_macd(ColumnView<T> p, int s, int l, int sig, MACD::Crossover mode) {
+    if (sig <= 0) throw std::invalid_argument("Signal period must be positive");
+
+    int size = p.size();
+    std::vector<T> short_ema {precision_ema(p, s)};
+    std::vector<T> long_ema {precision_ema(p, l)};
+    std::vector<T> macd_line(size);
+
+    // MACD line exists once both EMAs do
+    int macd_start = l - 1;
+
+    for (int i = macd_start; i < size; i++) macd_line[i] = short_ema[i] - long_ema[i];
+
+    if (mode == MACD::Crossover::zero_line) return macd_line;
+
+    // signal line: EMA of the MACD line, seeded with the mean of its first `sig` values
+    int signal_start = macd_start + sig - 1;
+
+    if (signal_start >= size) throw std::invalid_argument("Not enough data for the MACD signal line");
+
+    std::vector<T> histogram(size);
+    typename Arithmetic<T>::Sum sum {};
+
+    for (int i = macd_start; i <= signal_start; i++) sum += macd_line[i];
+
+    T EMA {Arithmetic<T>::mean(sum, sig)};
+
+    histogram[signal_start] = macd_line[signal_start] - EMA;
+
+    for (int i = signal_start + 1; i < size; i++) {
+        EMA = Arithmetic<T>::next_ema(EMA, macd_line[i], sig);
+        histogram[i] = macd_line[i] - EMA;
+    }
+
+    return histogram;
+}
+
+template <typename T>
+BacktestResult precision_backtest(ColumnView<T> price, int start_day, int stocks, const std::uint8_t* mask) {
+    using Sum = typename Arithmetic<T>::Sum;
+
+    BacktestResult result;
+    int size = price.size();
+    std::vector<int> transitions;
+
+    find_transitions(mask, start_day, size, transitions);
+
+    // a position still open at the end is sold on the last day
+    if (transitions.size() % 2 == 1) transitions.push_back(size - 1);
+
+    int trades = transitions.size() / 2;
+    double initial_buy {(trades > 0) ? to_double(price[transitions[0]]) : 0.0};
+    Sum profit {};
+
+    // summed in trade order, like backtest_mask
+    for (int k = 0; k < trades; k++) {
+        profit += (static_cast<Sum>(price[transitions[2 * k + 1]]) - static_cast<Sum>(price[transitions[2 * k]])) * stocks;
+    }
+
+    result.transactions = 2 * trades;
+    result.profit = Arithmetic<T>::units(profit);
+    result.percent = ((result.profit / stocks) / initial_buy) * 100;
+
+    return result;
+}
+
+
+template std::vector<float> to_precision(PriceView);
+template std::vector<Cents> to_precision(PriceView);
+template double to_double(float);
+template double to_double(Cents);
+template std::vector<float> precision_mean(ColumnView<float>, int);
+template std::vector<Cents> precision_mean(ColumnView<Cents>, int);
+template std::vector<float> precision_ema(ColumnView<float>, int);
+template std::vector<Cents> precision_ema(ColumnView<Cents>, int);
+template std::vector<float> precision_macd(ColumnView<float>, int, int, int, MACD::Crossover);
+template std::vector<Cents> precision_macd(ColumnView<Cents>, int, int, int, MACD::Crossover);
+template BacktestResult precision_backtest(ColumnView<float>, int, int, const std::uint8_t*);
+template BacktestResult precision_backtest(ColumnView<Cents>, int, int, const std::uint8_t*);
+
+
+StoreType parse_store(std::string_view name) {
+    if (name == "double") return StoreType::doubles;
+    if (name == "float") return StoreType::floats;
+    if (name == "cents") return StoreType::cents;
+
+    throw std::invalid_argument("unknown price store '" + std::string(name) + "' (expected double, float or cents)");
+}
+
+
+template <typename T>
+PrecisionRun<T>::PrecisionRun(std::vector<StrategyEntry> strategies, PriceView p)
+    : entries(std::move(strategies)), store(to_precision<T>(p)), size(p.size())
+{
+    if (entries.empty()) throw std::invalid_argument("Simulator needs at least one strategy");
+
+    for (const StrategyEntry& e : entries) {
+        if (!e.strategy) throw std::invalid_argument("Strategy cannot be empty");
+        if (!(e.weight > 0)) throw std::invalid_argument("Strategy weight must be positive");
+
+        if (e.strategy->get_bars().close.data() != p.data() || e.strategy->get_bars().close.size() != p.size()) {
+            throw std::invalid_argument("'" + e.name + "' is not built on the prices of the run");
+        }
+
+        start_day = std::max(start_day, e.strategy->first_signal_day());
+        total_weight += e.weight;
+    }
+
+    for (const StrategyEntry& e : entries) {
+        std::vector<std::uint8_t> mask(size);
+
+        if (const SMA* sma = dynamic_cast<const SMA*>(e.strategy.get())) {
+            std::vector<T> fast {precision_mean<T>(store, sma->get_short_term())};
+            std::vector<T> slow {precision_mean<T>(store, sma->get_long_term())};
+
+            greater_mask(fast.data(), slow.data(), start_day, size, mask.data());
+
+            // the averages run one day past the prices, as SMA::indicator's latest day does
+            latest.push_back(fast[size] > slow[size]);
+        } else if (const MACD* macd = dynamic_cast<const MACD*>(e.strategy.get())) {
+            std::vector<T> line {precision_macd<T>(store, macd->get_short_term(), macd->get_long_term(),
+                                                   macd->get_signal_term(), macd->get_crossover())};
+
+            greater_mask(line.data(), nullptr, start_day, size, mask.data());
+            latest.push_back(line[size - 1] > 0);
+        } else {
+            throw std::invalid_argument("'" + e.name + "' cannot run on a " + Arithmetic<T>::name
+                                        + " store (only SMA and MACD can)");
+        }
+
+        decisions.push_back(std::move(mask));
+    }
+}
+
+template <typename T>
+void PrecisionRun<T>::set_vote(const VoteRule& rule) {
+    check_vote_rule(rule);
+
+    vote = rule;
+    vote_backtest = true;
+}
+
+template <typename T>
+IndicatorReport PrecisionRun<T>::indicator_report() const {
+    PROFILE_SCOPE("indicator");
+
+    IndicatorReport report;
+
+    for (std::size_t k = 0; k < entries.size(); k++) {
+        const StrategyEntry& e = entries[k];
+        SignalReport signal {e.name, e.strategy->get_short_term(), e.strategy->get_long_term(), 0, "",
+                             static_cast<bool>(latest[k]), e.weight};
+
+        if (const MACD* macd = dynamic_cast<const MACD*>(e.strategy.get())) {
+            signal.signal_term = macd->get_signal_term();
+            signal.crossover = (macd->get_crossover() == MACD::Crossover::signal_line) ? "signal" : "zero";
+        }
+
+        report.signals.push_back(signal);
+    }
+
+    tally_vote(report, vote.buy, vote.sell);
+
+    PROFILE_COUNT(Counter::indicator_calls, report.signals.size());
+
+    return report;
+}
+
+template <typename T>
+BacktestReport PrecisionRun<T>::backtest_report(int stocks) const {
+    if (stocks <= 0) throw std::invalid_argument("Error: Invalid number of stocks");
+
+    PROFILE_SCOPE("backtest");
+
+    BacktestReport report;
+
+    report.stocks = stocks;
+    report.first_price = to_double(store.front());
+    report.last_price = to_double(store.back());
+
+    for (std::size_t k = 0; k < entries.size(); k++) {
+        report.strategies.push_back({entries[k].name, precision_backtest<T>(store, start_day, stocks, decisions[k].data()),
+                                     std::nullopt, {}});
+    }
+
+    // the weighted vote holds its position between the thresholds, as in Simulator
+    if (vote_backtest) {
+        std::vector<std::uint8_t> voted(size);
+        bool holding {false};
+
+        for (int d = start_day; d < size; d++) {
+            double score {0};
+
+            for (std::size_t k = 0; k < entries.size(); k++) score += (decisions[k][d]) ? entries[k].weight : -entries[k].weight;
+
+            score /= total_weight;
+
+            if (score > vote.buy) holding = true;
+            else if (score < vote.sell) holding = false;
+
+            voted[d] = holding;
+        }
+
+        report.strategies.push_back({"Vote", precision_backtest<T>(store, start_day, stocks, voted.data()), std::nullopt, {}});
+    }
+
+    // bought on day 0 and held to the end
+    std::vector<std::uint8_t> held(size, 1);
+
+    report.buy_and_hold = precision_backtest<T>(store, 0, stocks, held.data());
+
+    return report;
+}
+
+template class PrecisionRun<float>;
+template class PrecisionRun<Cents>;
+
+
+// decisions of `mask` against the double `baseline` over [start, size), and both backtests
+template <typename T>
+static PrecisionCheck compare(const std::string& strategy, PriceView p, const std::vector<T>& q, int start, int stocks,
+                              const std::vector<std::uint8_t>& baseline, const std::vector<std::uint8_t>& mask) {
+    PrecisionCheck check;
+    int size = p.size();
+
+    check.strategy = strategy;
+    check.precision = Arithmetic<T>::name;
+    check.bytes = sizeof(T);
+    check.days = std::max(size - start, 0);
+
+    for (int day = start; day < size; day++) {
+        if (mask[day] == baseline[day]) continue;
+
+        if (check.mismatches++ == 0) check.first_mismatch = day;
+    }
+
+    check.baseline = backtest_mask(p, start, stocks, baseline.data());
+    check.result = precision_backtest<T>(q, start, stocks, mask.data());
+
+    return check;
+}
+
+template <typename T>
+static PrecisionCheck check_sma(const SMA& sma, PriceView p, const std::vector<T>& q, int stocks,
+                                const std::vector<std::uint8_t>& baseline) {
+    int size = p.size();
+    int start = sma.first_signal_day();
+    SMA::Signal line {sma.signal()};
+    std::vector<T> fast {precision_mean<T>(q, sma.get_short_term())};
+    std::vector<T> slow {precision_mean<T>(q, sma.get_long_term())};
+    std::vector<std::uint8_t> mask(size);
+
+    greater_mask(fast.data(), slow.data(), start, size, mask.data());
+
+    std::string name {"SMA " + std::to_string(sma.get_short_term()) + "/" + std::to_string(sma.get_long_term())};
+    PrecisionCheck check {compare(name, p, q, start, stocks, baseline, mask)};
+
+    // the compared series is the gap between the averages
+    for (int day = start; day < size; day++) {
+        double gap {to_double(fast[day]) - to_double(slow[day])};
+
+        check.max_error = std::max(check.max_error, std::abs(gap - (line.short_avg[day] - line.long_avg[day])));
+    }
+
+    return check;
+}
+
+template <typename T>
+static PrecisionCheck check_macd(const MACD& macd, PriceView p, const std::vector<T>& q, int stocks,
+                                 const std::vector<std::uint8_t>& baseline) {
+    int size = p.size();
+    int start = macd.first_signal_day();
+    std::vector<T> line {precision_macd<T>(q, macd.get_short_term(), macd.get_long_term(), macd.get_signal_term(), macd.get_crossover())};
+    std::vector<std::uint8_t> mask(size);
+
+    greater_mask(line.data(), nullptr, start, size, mask.data());
+
+    std::string name {"MACD " + std::to_string(macd.get_short_term()) + "/" + std::to_string(macd.get_long_term())};
+
+    if (macd.get_crossover() == MACD::Crossover::signal_line) name += "/" + std::to_string(macd.get_signal_term());
+
+    PrecisionCheck check {compare(name, p, q, start, stocks, baseline, mask)};
+
+    for (int day = start; day < size; day++) {
+        check.max_error = std::max(check.max_error, std::abs(to_double(line[day]) - macd.signal().line[day]));
+    }
+
+    return check;
+}
+
+std::vector<PrecisionCheck> validate_precision(PriceView p, int stocks, const std::vector<StrategyEntry>& strategies) {
+    PROFILE_SCOPE("precision validation");
+
+    std::vector<float> floats {to_precision<float>(p)};
+    std::vector<Cents> cents {to_precision<Cents>(p)};
+    std::vector<PrecisionCheck> checks;
+    int size = p.size();
+
+    for (const StrategyEntry& e : strategies) {
+        const Strategy& strategy = *e.strategy;
+        std::vector<std::uint8_t> baseline(size);
+
+        if (strategy.get_bars().close.data() != p.data() || strategy.get_bars().close.size() != p.size()) {
+            throw std::invalid_argument("'" + e.name + "' is not built on the validated prices");
+        }
+
+        strategy.fill(strategy.first_signal_day(), size, baseline.data());
+
+        if (const SMA* sma = dynamic_cast<const SMA*>(&strategy)) {
+            checks.push_back(check_sma(*sma, p, floats, stocks, baseline));
+            checks.push_back(check_sma(*sma, p, cents, stocks, baseline));
+        } else if (const MACD* macd = dynamic_cast<const MACD*>(&strategy)) {
+            checks.push_back(check_macd(*macd, p, floats, stocks, baseline));
+            checks.push_back(check_macd(*macd, p, cents, stocks, baseline));
+        } else {
+            throw std::invalid_argument("'" + e.name + "' has no reduced-precision kernels (only SMA and MACD do)");
+        }
+    }
+
+    return checks;
+}
+
+static std::string percent_text(double percent) {
+    std::ostringstream out;
+
+    out << std::fixed << std::setprecision(2) << percent << "%";
+
+    return out.str();
+}
+
+void print_precision(const std::vector<PrecisionCheck>& checks, std::ostream& out) {
+    out << " [ Precision Validation ]" << "\n\n"
+        << " Baseline: double (8 bytes per price)" << "\n\n"
+        << std::left
+        << " " << std::setw(16) << "Strategy"
+        << std::setw(11) << "Precision"
+        << std::setw(7) << "Bytes"
+        << std::setw(12) << "Agreement"
+        << std::setw(12) << "Mismatches"
+        << std::setw(8) << "First"
+        << std::setw(14) << "Max error"
+        << std::setw(16) << "Profit (double)"
+        << std::setw(14) << "Profit"
+        << "Difference\n";
+
+    for (const PrecisionCheck& c : checks) {
+        out << " " << std::setw(16) << c.strategy
+            << std::setw(11) << c.precision
+            << std::setw(7) << c.bytes
+            << std::setw(12) << percent_text(c.agreement())
+            << std::setw(12) << c.mismatches
+            << std::setw(8) << ((c.first_mismatch < 0) ? "-" : std::to_string(c.first_mismatch))
+            << std::setw(14) << c.max_error
+            << std::setw(16) << c.baseline.profit
+            << std::setw(14) << c.result.profit
+            << c.result.profit - c.baseline.profit << "\n";
+    }
+
+    out << "\n Agreement is the share of days deciding as double does; profits are frictionless backtests.\n";
+}
@@ -0,0 +1,175 @@
+#include "../include/price_cache.h"
+#include "../include/profile.h"
+#include "../include/util.h"
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace fs = std::filesystem;
+
+
+PriceSeries::PriceSeries(std::vector<double> prices, std::vector<std::int64_t> timestamps)
+    : PriceSeries(BarData {{}, {}, {}, std::move(prices), {}, std::move(timestamps)}) {}
+
+// moving the vectors into `owned` keeps their buffers, so the views can be taken afterwards
+PriceSeries::PriceSeries(BarData bars)
+    : owned(std::move(bars)),
+      view {owned.open, owned.high, owned.low, owned.close, owned.volume, owned.timestamps} {}
+
+PriceSeries::PriceSeries(MappedFile cache, const BarsView& bars)
+    : mapping(std::move(cache)), view(bars) {}
+
+
+std::string cache_path(std::string_view csv_file) {
+    return std::string(csv_file) + ".tsc";
+}
+
+// map a cache file and check it against the source CSV it was built from
+static std::optional<PriceSeries> open_cache(const std::string& file, std::uint64_t source_size, std::int64_t source_mtime) {
+    std::error_code ec;
+
+    if (!fs::is_regular_file(file, ec)) return std::nullopt;
+
+    MappedFile cache(file);
+
+    if (cache.size() < sizeof(CacheHeader)) return std::nullopt;
+
+    CacheHeader header;
+    std::memcpy(&header, cache.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) return std::nullopt;
+    if (header.version != CACHE_VERSION) return std::nullopt;
+    if (header.source_size != source_size || header.source_mtime != source_mtime) return std::nullopt;
+
+    std::uint64_t count = header.count;
+    bool has_timestamps = header.flags & CACHE_HAS_TIMESTAMPS;
+    bool has_ohlc = header.flags & CACHE_HAS_OHLC;
+    bool has_volume = header.flags & CACHE_HAS_VOLUME;
+    std::uint64_t columns = 1 + has_timestamps + 3 * has_ohlc + has_volume;
+
+    if (cache.size() != sizeof(CacheHeader) + columns * count * sizeof(double)) return std::nullopt;
+
+    // the mapping is page aligned and the header is 64 bytes, so every column is suitably aligned
+    const double* next = reinterpret_cast<const double*>(cache.data() + sizeof(CacheHeader));
+    auto column = [&](bool present) {
+        if (!present) return PriceView();
+
+        PriceView view(next, count);
+        next += count;
+
+        return view;
+    };
+
+    BarsView bars;
+
+    bars.close = column(true);
+
+    if (has_timestamps) {
+        bars.timestamps = TimestampView(reinterpret_cast<const std::int64_t*>(next), count);
+        next += count;
+    }
+
+    bars.open = column(has_ohlc);
+    bars.high = column(has_ohlc);
+    bars.low = column(has_ohlc);
+    bars.volume = column(has_volume);
+
+    return PriceSeries(std::move(cache), bars);
+}
+
+// write to a unique temporary file and rename it into place, so concurrent readers never see a partial cache
+static void write_cache(const std::string& file, const BarsView& bars,
+                        std::uint64_t source_size, std::int64_t source_mtime) {
+    CacheHeader header {};
+    bool has_timestamps = bars.timestamps.size() == bars.size();
+    bool has_ohlc = bars.has_ohlc();
+    bool has_volume = bars.has_volume();
+
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.flags = ((has_timestamps) ? CACHE_HAS_TIMESTAMPS : 0) | ((has_ohlc) ? CACHE_HAS_OHLC : 0)
+                 | ((has_volume) ? CACHE_HAS_VOLUME : 0);
+    header.count = bars.size();
+    header.source_size = source_size;
+    header.source_mtime = source_mtime;
+
+    std::ostringstream tmp;
+    tmp << file << ".tmp." << getpid() << "." << std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+    {
+        std::ofstream out(tmp.str(), std::ios::binary | std::ios::trunc);
+
+        if (!out.is_open()) return;
+
+        auto write = [&](const void* data) { out.write(static_cast<const char*>(data), bars.size() * sizeof(double)); };
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write(bars.close.data());
+
+        if (has_timestamps) write(bars.timestamps.data());
+
+        if (has_ohlc) {
+            write(bars.open.data());
+            write(bars.high.data());
+            write(bars.low.data());
+        }
+
+        if (has_volume) write(bars.volume.data());
+
+        if (!out) {
+            std::error_code ec;
+            out.close();
+            fs::remove(tmp.str(), ec);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp.str(), file, ec);
+
+    if (ec) fs::remove(tmp.str(), ec);
+}
+
+PriceSeries load_prices(std::string_view csv_file, bool use_cache) {
+    PROFILE_SCOPE("load prices");
+
+    std::string source {csv_file};
+    std::error_code size_ec;
+    std::error_code time_ec;
+    std::uint64_t source_size = fs::file_size(source, size_ec);
+    std::int64_t source_mtime = fs::last_write_time(source, time_ec).time_since_epoch().count();
+
+    // missing source: let read_file report it as before
+    if (size_ec || time_ec) use_cache = false;
+
+    std::string cache {cache_path(csv_file)};
+
+    if (use_cache) {
+        std::optional<PriceSeries> cached {open_cache(cache, source_size, source_mtime)};
+
+        if (cached) {
+            PROFILE_COUNT(Counter::rows, cached->prices().size());
+
+            return std::move(*cached);
+        }
+    }
+
+    PriceSeries series {read_bars(csv_file)};
+
+    if (use_cache) write_cache(cache, series.bars(), source_size, source_mtime);
+
+    return series;
+}
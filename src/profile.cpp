@@ -0,0 +1,178 @@
+#include "../include/profile.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <ios>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+const char* counter_name(Counter counter) {
+    switch (counter) {
+        case Counter::bytes_parsed: return "bytes parsed";
+        case Counter::rows: return "rows";
+        case Counter::indicator_calls: return "indicator calls";
+        case Counter::signal_days: return "signal days";
+        default: return "trades";
+    }
+}
+
+// numbered in the order threads first record an event
+static int thread_number() {
+    static std::atomic<int> next {0};
+    thread_local int number {next.fetch_add(1)};
+
+    return number;
+}
+
+
+void Profiler::enable() {
+    std::lock_guard<std::mutex> guard(lock);
+
+    events.clear();
+    for (std::atomic<std::uint64_t>& c : counters) c.store(0, std::memory_order_relaxed);
+
+    origin = std::chrono::steady_clock::now();
+    on.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::disable() {
+    on.store(false, std::memory_order_relaxed);
+}
+
+std::int64_t Profiler::now_ns() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void Profiler::record(const char* stage, std::int64_t start_ns, std::int64_t end_ns) {
+    int thread = thread_number();
+    std::lock_guard<std::mutex> guard(lock);
+
+    events.push_back({stage, start_ns, end_ns - start_ns, thread});
+}
+
+std::vector<StageEvent> Profiler::get_events() const {
+    std::lock_guard<std::mutex> guard(lock);
+
+    return events;
+}
+
+std::vector<StageSummary> Profiler::summary() const {
+    std::vector<StageEvent> sorted {get_events()};
+    std::vector<StageSummary> stages;
+
+    // events are recorded when they end; nested stages start before their parents end
+    std::stable_sort(sorted.begin(), sorted.end(), [](const StageEvent& a, const StageEvent& b) {
+        return a.start_ns < b.start_ns;
+    });
+
+    for (const StageEvent& e : sorted) {
+        auto it = std::find_if(stages.begin(), stages.end(), [&](const StageSummary& s) { return s.stage == e.stage; });
+
+        if (it == stages.end()) it = stages.insert(stages.end(), StageSummary {e.stage, 0, 0, 0});
+
+        double ms = e.duration_ns / 1e6;
+
+        it->calls++;
+        it->total_ms += ms;
+        it->max_ms = std::max(it->max_ms, ms);
+    }
+
+    return stages;
+}
+
+void Profiler::write_report(std::ostream& out) const {
+    double run_ms = now_ns() / 1e6;
+    std::ios_base::fmtflags flags {out.flags()};
+    std::streamsize precision {out.precision()};
+
+    out << " [ Profile ]" << "\n\n"
+        << std::left
+        << " " << std::setw(22) << "Stage"
+        << std::setw(8) << "Calls"
+        << std::setw(14) << "Total ms"
+        << std::setw(14) << "Mean ms"
+        << std::setw(14) << "Max ms"
+        << "% of run" << "\n";
+
+    out << std::fixed << std::setprecision(3);
+
+    for (const StageSummary& s : summary()) {
+        out << " " << std::setw(22) << s.stage
+            << std::setw(8) << s.calls
+            << std::setw(14) << s.total_ms
+            << std::setw(14) << s.total_ms / s.calls
+            << std::setw(14) << s.max_ms
+            << std::setprecision(1) << ((run_ms > 0) ? 100 * s.total_ms / run_ms : 0.0) << "%\n"
+            << std::setprecision(3);
+    }
+
+    out << std::right << "\n"
+        << " Run: " << run_ms << " ms (stages nest, and parallel ones overlap, so shares can add up to more than 100%)\n\n";
+
+    for (int k = 0; k < COUNTERS; k++) {
+        out << " " << counter_name(static_cast<Counter>(k)) << ": " << count(static_cast<Counter>(k)) << "\n";
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Profiler::write_trace(std::ostream& out) const {
+    std::vector<StageEvent> recorded {get_events()};
+
+    out << "{\"traceEvents\":[";
+
+    // trace timestamps are in microseconds
+    for (std::size_t i = 0; i < recorded.size(); i++) {
+        const StageEvent& e = recorded[i];
+
+        out << ((i > 0) ? ",\n" : "\n") << "{\"name\":\"" << e.stage << "\",\"cat\":\"stage\",\"ph\":\"X\",\"ts\":"
+            << e.start_ns / 1e3 << ",\"dur\":" << e.duration_ns / 1e3 << ",\"pid\":1,\"tid\":" << e.thread << "}";
+    }
+
+    out << ((recorded.empty()) ? "\n" : ",\n") << "{\"name\":\"counters\",\"ph\":\"C\",\"ts\":" << now_ns() / 1e3
+        << ",\"pid\":1,\"args\":{";
+
+    for (int k = 0; k < COUNTERS; k++) {
+        out << ((k > 0) ? "," : "") << "\"" << counter_name(static_cast<Counter>(k)) << "\":" << count(static_cast<Counter>(k));
+    }
+
+    out << "}}\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+
+ProfileSession::ProfileSession(std::string trace) : trace_file(std::move(trace)) {
+    Profiler::instance().enable();
+}
+
+ProfileSession::~ProfileSession() {
+    Profiler& profiler = Profiler::instance();
+
+    profiler.disable();
+
+    // a destructor must not throw: a failed trace write is reported and dropped
+    try {
+        std::cerr << "\n";
+        profiler.write_report(std::cerr);
+
+        if (!trace_file.empty()) {
+            std::ofstream out(trace_file);
+
+            if (out) profiler.write_trace(out);
+            if (!out) std::cerr << "Error: could not write the trace to '" << trace_file << "'\n";
+            else std::cerr << " Trace written to " << trace_file << "\n";
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+    }
+}
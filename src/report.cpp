@@ -0,0 +1,525 @@
+#include "../include/report.h"
+#include <charconv>
+#include <cmath>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+OutputFormat parse_format(std::string_view name) {
+    if (name == "text") return OutputFormat::text;
+    if (name == "json") return OutputFormat::json;
+    if (name == "csv") return OutputFormat::csv;
+
+    throw std::invalid_argument("Unknown output format '" + std::string(name) + "' (expected json, csv or text)");
+}
+
+std::string recommendation_label(double score, double buy, double sell, int strategies) {
+    if (strategies > 1 && score >= 1) return "STRONG BUY";
+    if (strategies > 1 && score <= -1) return "STRONG SELL";
+    if (score > buy) return "BUY";
+    if (score < sell) return "SELL";
+
+    return "MIXED SIGNAL";
+}
+
+void tally_vote(IndicatorReport& report, double buy, double sell) {
+    double score {0};
+    double total {0};
+
+    for (const SignalReport& s : report.signals) {
+        score += (s.buy) ? s.weight : -s.weight;
+        total += s.weight;
+    }
+
+    report.score = (total > 0) ? score / total : 0.0;
+    report.recommendation = recommendation_label(report.score, buy, sell, report.signals.size());
+}
+
+std::string describe_execution(const ExecutionModel& execution) {
+    if (execution.frictionless()) return "frictionless";
+
+    std::ostringstream out;
+    std::string separator;
+
+    auto part = [&]() -> std::ostream& {
+        out << separator;
+        separator = ", ";
+        return out;
+    };
+
+    if (execution.fee > 0) part() << "$" << execution.fee << " fee";
+    if (execution.slippage_bps > 0) part() << execution.slippage_bps << " bps slippage";
+    if (execution.equity_percent > 0) part() << execution.equity_percent << "% of equity (from $" << execution.capital << ")";
+    if (execution.delay == 1) part() << "next-bar fills";
+    if (execution.delay > 1) part() << "fills " << execution.delay << " days after the signal";
+    if (execution.shorts) part() << "long / short";
+
+    return out.str();
+}
+
+
+// ---- text ----
+
+static void break_line(std::ostream& out) {
+    out << "------------------------------" << "\n";
+}
+
+// conditional naming and coloring
+static void write_profit(double profit, double percent, std::ostream& out) {
+    if (profit > 0) {
+        out << "\033[32m Profit: +$" << profit << "\n"
+            << " Percentage: +" << percent << "%\033[0m\n";
+    } else if (profit < 0) {
+        out << "\033[31m Losses: -$" << std::abs(profit) << "\n"
+            << " Percentage: -" << std::abs(percent) << "%\033[0m\n";
+    } else {
+        out << " Profit: ---" << "\n" << " Percentage: ---" << "\n";
+    }
+}
+
+static void write_metrics(const Metrics& m, std::ostream& out) {
+    out << " Win rate: " << m.win_rate << "% of " << m.trades << " trades" << "\n"
+        << " Exposure: " << m.exposure << "% of days" << "\n"
+        << " Max drawdown: " << m.max_drawdown << "%" << "\n"
+        << " Sharpe: " << m.sharpe << ", Sortino: " << m.sortino << "\n"
+        << " CAGR: " << m.cagr << "%" << "\n";
+}
+
+void write_indicator_text(const IndicatorReport& report, std::ostream& out) {
+    if (report.signals.empty()) return;
+
+    out << " [ Trading Signal ]" << "\n\n";
+
+    for (const SignalReport& s : report.signals) {
+        out << " Strategy: " << s.strategy << " (" << s.short_term;
+
+        // single-period strategies (RSI, Bollinger, ATR) have short_term == long_term
+        if (s.long_term != s.short_term) out << "/" << s.long_term;
+
+        if (s.crossover == "signal") out << ", signal line " << s.signal_term;
+        if (s.weight != 1) out << ", weight " << s.weight;
+
+        // conditional signal and coloring
+        out << ")" << "\n"
+            << " Signal: " << ((s.buy) ? "\033[32mBUY\033[0m" : "\033[31mSELL\033[0m") << "\n";
+
+        break_line(out);
+    }
+
+    // give final recommendation
+    const std::string& label = report.recommendation;
+
+    if (label == "STRONG BUY" || label == "BUY") out << " Recommendation: \033[32m" << label << "\033[0m" << "\n";
+    else if (label == "STRONG SELL" || label == "SELL") out << " Recommendation: \033[31m" << label << "\033[0m" << "\n";
+    else if (!label.empty()) out << " Recommendation: " << label << "\n";
+}
+
+void write_backtest_text(const BacktestReport& report, std::ostream& out) {
+    if (report.strategies.empty()) return;
+
+    out << " [ Backtest Results ]" << "\n\n";
+
+    for (const StrategyReport& s : report.strategies) {
+        out << " Strategy: " << s.strategy << "\n"
+            << " No. of transactions: " << s.result.transactions << "\n";
+
+        write_profit(s.result.profit, s.result.percent, out);
+
+        if (s.metrics) write_metrics(*s.metrics, out);
+
+        break_line(out);
+    }
+
+    out << " Strategy: Buy and hold" << "\n"
+        << " Starting buy price: " << report.first_price << "\n"
+        << " Final sell price: " << report.last_price << "\n";
+
+    write_profit(report.buy_and_hold.profit, report.buy_and_hold.percent, out);
+
+    if (report.buy_and_hold_metrics) write_metrics(*report.buy_and_hold_metrics, out);
+}
+
+static void write_run_text(const RunReport& report, std::ostream& out) {
+    out << "** Running tests **" << "\n\n"
+        << " Stock: " << report.ticker << "\n"
+        << " Current Price: " << report.current_price << "\n"
+        << " Days Analysed: " << report.days << ((report.timeframe.empty()) ? " days" : " " + report.timeframe + " bars") << "\n"
+        << " Simulating for: " << report.stocks << " stocks\n";
+
+    bool costs = report.backtest && (report.backtest->execution.fee > 0 || report.backtest->execution.slippage_bps > 0);
+
+    if (report.backtest && !report.backtest->execution.frictionless()) {
+        out << " Execution: " << describe_execution(report.backtest->execution) << "\n";
+    }
+
+    out << "\n";
+
+    if (report.indicator) write_indicator_text(*report.indicator, out);
+
+    out << "\n";
+
+    if (report.backtest) write_backtest_text(*report.backtest, out);
+
+    if (costs) out << "\nNote: dividends have not been factored in the calculations\n";
+    else out << "\nNote: transaction fees and dividends have not been factored in the calculations\n";
+}
+
+
+// ---- json / csv ----
+
+// shortest round-trip representation; NaN (i.e. percent of a strategy that never bought) has none
+static void write_number(double value, std::ostream& out, std::string_view missing) {
+    if (!std::isfinite(value)) {
+        out << missing;
+        return;
+    }
+
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+
+    out.write(buffer, end - buffer);
+}
+
+static void write_json_string(std::string_view text, std::ostream& out) {
+    out << '"';
+
+    for (char c : text) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if (c == '\n') out << "\\n";
+        else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+        else out << c;
+    }
+
+    out << '"';
+}
+
+static void write_json_result(const BacktestResult& result, std::ostream& out) {
+    out << "\"transactions\":" << result.transactions << ",\"profit\":";
+    write_number(result.profit, out, "null");
+    out << ",\"percent\":";
+    write_number(result.percent, out, "null");
+}
+
+static void write_json_metrics(const Metrics& m, std::ostream& out) {
+    const char* names[] {"win_rate", "exposure", "total_return", "cagr", "max_drawdown", "sharpe", "sortino", "final_equity"};
+    double values[] {m.win_rate, m.exposure, m.total_return, m.cagr, m.max_drawdown, m.sharpe, m.sortino, m.final_equity};
+
+    out << "\"metrics\":{\"trades\":" << m.trades;
+
+    for (int k = 0; k < 8; k++) {
+        out << ",\"" << names[k] << "\":";
+        write_number(values[k], out, "null");
+    }
+
+    out << "}";
+}
+
+static void write_json_trades(const std::vector<Trade>& trades, std::ostream& out) {
+    out << "\"trades\":[";
+
+    for (std::size_t i = 0; i < trades.size(); i++) {
+        const Trade& t = trades[i];
+
+        out << ((i > 0) ? "," : "") << "{\"entry_day\":" << t.entry_day << ",\"exit_day\":" << t.exit_day << ",\"entry_price\":";
+        write_number(t.entry_price, out, "null");
+        out << ",\"exit_price\":";
+        write_number(t.exit_price, out, "null");
+        out << ",\"shares\":";
+        write_number(t.shares, out, "null");
+        out << ",\"pnl\":";
+        write_number(t.pnl, out, "null");
+        out << "}";
+    }
+
+    out << "]";
+}
+
+static void write_csv_field(std::string_view text, std::ostream& out) {
+    if (text.find_first_of(",\"\n") == std::string_view::npos) {
+        out << text;
+        return;
+    }
+
+    out << '"';
+
+    for (char c : text) {
+        if (c == '"') out << '"';
+        out << c;
+    }
+
+    out << '"';
+}
+
+static void write_csv_result(const BacktestResult& result, std::ostream& out) {
+    out << result.transactions << ",";
+    write_number(result.profit, out, "");
+    out << ",";
+    write_number(result.percent, out, "");
+}
+
+static void write_csv_metrics(const Metrics& m, std::ostream& out) {
+    for (double value : {m.win_rate, m.exposure, m.max_drawdown, m.sharpe, m.sortino, m.cagr}) {
+        out << ",";
+        write_number(value, out, "");
+    }
+}
+
+static void write_run_json(const RunReport& report, std::ostream& out) {
+    out << "{\"ticker\":";
+    write_json_string(report.ticker, out);
+    out << ",\"current_price\":";
+    write_number(report.current_price, out, "null");
+    out << ",\"days\":" << report.days;
+
+    if (!report.timeframe.empty()) {
+        out << ",\"timeframe\":";
+        write_json_string(report.timeframe, out);
+    }
+
+    out << ",\"stocks\":" << report.stocks << ",\"indicator\":";
+
+    if (report.indicator) {
+        const IndicatorReport& indicator = *report.indicator;
+        out << "{\"signals\":[";
+
+        for (std::size_t i = 0; i < indicator.signals.size(); i++) {
+            const SignalReport& s = indicator.signals[i];
+
+            out << ((i > 0) ? "," : "") << "{\"strategy\":";
+            write_json_string(s.strategy, out);
+            out << ",\"short_term\":" << s.short_term << ",\"long_term\":" << s.long_term;
+
+            if (!s.crossover.empty()) {
+                out << ",\"signal_term\":" << s.signal_term << ",\"crossover\":";
+                write_json_string(s.crossover, out);
+            }
+
+            out << ",\"weight\":";
+            write_number(s.weight, out, "null");
+            out << ",\"signal\":" << ((s.buy) ? "\"BUY\"" : "\"SELL\"") << "}";
+        }
+
+        out << "],\"score\":";
+        write_number(indicator.score, out, "null");
+        out << ",\"recommendation\":";
+
+        if (indicator.recommendation.empty()) out << "null";
+        else write_json_string(indicator.recommendation, out);
+
+        out << "}";
+    } else {
+        out << "null";
+    }
+
+    out << ",\"backtest\":";
+
+    if (report.backtest) {
+        const BacktestReport& backtest = *report.backtest;
+
+        out << "{";
+
+        // only runs with costs, sizing, delay or shorts carry their execution model
+        if (!backtest.execution.frictionless()) {
+            const ExecutionModel& e = backtest.execution;
+
+            out << "\"execution\":{\"fee\":";
+            write_number(e.fee, out, "null");
+            out << ",\"slippage_bps\":";
+            write_number(e.slippage_bps, out, "null");
+            out << ",\"equity_percent\":";
+            write_number(e.equity_percent, out, "null");
+            out << ",\"capital\":";
+            write_number(e.capital, out, "null");
+            out << ",\"delay\":" << e.delay << ",\"shorts\":" << (e.shorts ? "true" : "false") << "},";
+        }
+
+        out << "\"strategies\":[";
+
+        for (std::size_t i = 0; i < backtest.strategies.size(); i++) {
+            out << ((i > 0) ? "," : "") << "{\"strategy\":";
+            write_json_string(backtest.strategies[i].strategy, out);
+            out << ",";
+            write_json_result(backtest.strategies[i].result, out);
+
+            if (backtest.strategies[i].metrics) {
+                out << ",";
+                write_json_metrics(*backtest.strategies[i].metrics, out);
+                out << ",";
+                write_json_trades(backtest.strategies[i].trades, out);
+            }
+
+            out << "}";
+        }
+
+        out << "],\"buy_and_hold\":{\"first_price\":";
+        write_number(backtest.first_price, out, "null");
+        out << ",\"last_price\":";
+        write_number(backtest.last_price, out, "null");
+        out << ",";
+        write_json_result(backtest.buy_and_hold, out);
+
+        if (backtest.buy_and_hold_metrics) {
+            out << ",";
+            write_json_metrics(*backtest.buy_and_hold_metrics, out);
+        }
+
+        out << "}}";
+    } else {
+        out << "null";
+    }
+
+    out << "}\n";
+}
+
+// one row per strategy: its latest signal and / or its backtest result
+static void write_run_csv(const RunReport& report, std::ostream& out) {
+    std::vector<std::string> strategies;
+
+    if (report.backtest) {
+        for (const StrategyReport& s : report.backtest->strategies) strategies.push_back(s.strategy);
+    } else if (report.indicator) {
+        for (const SignalReport& s : report.indicator->signals) strategies.push_back(s.strategy);
+    }
+
+    bool metrics = report.backtest && report.backtest->buy_and_hold_metrics;
+
+    out << "ticker,strategy,short_term,long_term,signal,transactions,profit,percent";
+
+    if (metrics) out << ",win_rate,exposure,max_drawdown,sharpe,sortino,cagr";
+
+    out << "\n";
+
+    for (std::size_t i = 0; i < strategies.size(); i++) {
+        // backtests list the strategies in signal order, then their combination and vote (which have none)
+        const SignalReport* signal {nullptr};
+
+        if (report.indicator && i < report.indicator->signals.size()) signal = &report.indicator->signals[i];
+
+        write_csv_field(report.ticker, out);
+        out << ",";
+        write_csv_field(strategies[i], out);
+        out << ",";
+
+        if (signal) out << signal->short_term << "," << signal->long_term << "," << ((signal->buy) ? "BUY" : "SELL") << ",";
+        else out << ",,,";
+
+        if (report.backtest) write_csv_result(report.backtest->strategies[i].result, out);
+        else out << ",,";
+
+        if (metrics) write_csv_metrics(*report.backtest->strategies[i].metrics, out);
+
+        out << "\n";
+    }
+
+    if (report.backtest) {
+        write_csv_field(report.ticker, out);
+        out << ",Buy and hold,,,,";
+        write_csv_result(report.backtest->buy_and_hold, out);
+
+        if (metrics) write_csv_metrics(*report.backtest->buy_and_hold_metrics, out);
+
+        out << "\n";
+    }
+}
+
+std::string format_run(const RunReport& report, OutputFormat format) {
+    std::ostringstream out;
+
+    if (format == OutputFormat::json) write_run_json(report, out);
+    else if (format == OutputFormat::csv) write_run_csv(report, out);
+    else write_run_text(report, out);
+
+    return out.str();
+}
+
+
+static void write_batch_json(const std::vector<BatchReport>& reports, std::ostream& out) {
+    out << "[";
+
+    for (std::size_t i = 0; i < reports.size(); i++) {
+        const BatchReport& r = reports[i];
+        bool ok = r.error.empty();
+
+        out << ((i > 0) ? ",\n " : "\n ") << "{\"ticker\":";
+        write_json_string(r.ticker, out);
+        out << ",\"period\":";
+        write_json_string(r.period, out);
+        out << ",\"path\":";
+        write_json_string(r.path, out);
+        out << ",\"days\":" << r.days;
+
+        const char* names[] {"sma", "macd", "buy_and_hold"};
+        const BacktestResult* results[] {&r.sma, &r.macd, &r.bnh};
+        bool enabled[] {r.sma_on, r.macd_on, true};
+
+        for (int k = 0; k < 3; k++) {
+            out << ",\"" << names[k] << "\":";
+
+            if (ok && enabled[k]) {
+                out << "{";
+                write_json_result(*results[k], out);
+                out << "}";
+            } else {
+                out << "null";
+            }
+        }
+
+        out << ",\"error\":";
+
+        if (ok) out << "null";
+        else write_json_string(r.error, out);
+
+        out << "}";
+    }
+
+    out << "\n]\n";
+}
+
+static void write_batch_csv(const std::vector<BatchReport>& reports, std::ostream& out) {
+    out << "ticker,period,path,days,"
+        << "sma_transactions,sma_profit,sma_percent,"
+        << "macd_transactions,macd_profit,macd_percent,"
+        << "bnh_transactions,bnh_profit,bnh_percent,error\n";
+
+    for (const BatchReport& r : reports) {
+        bool ok = r.error.empty();
+
+        write_csv_field(r.ticker, out);
+        out << ",";
+        write_csv_field(r.period, out);
+        out << ",";
+        write_csv_field(r.path, out);
+        out << "," << r.days << ",";
+
+        if (ok && r.sma_on) write_csv_result(r.sma, out);
+        else out << ",,";
+
+        out << ",";
+
+        if (ok && r.macd_on) write_csv_result(r.macd, out);
+        else out << ",,";
+
+        out << ",";
+
+        if (ok) write_csv_result(r.bnh, out);
+        else out << ",,";
+
+        out << ",";
+        write_csv_field(r.error, out);
+        out << "\n";
+    }
+}
+
+std::string format_batch(const std::vector<BatchReport>& reports, OutputFormat format) {
+    std::ostringstream out;
+
+    if (format == OutputFormat::json) write_batch_json(reports, out);
+    else if (format == OutputFormat::csv) write_batch_csv(reports, out);
+    else print_batch(reports, out);
+
+    return out.str();
+}
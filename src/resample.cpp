@@ -0,0 +1,122 @@
+#include "../include/resample.h"
+#include "../include/profile.h"
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+
+Timeframe parse_timeframe(std::string_view name) {
+    if (name == "daily") return {Timeframe::Unit::day, 1};
+    if (name == "weekly") return {Timeframe::Unit::week, 1};
+    if (name == "monthly") return {Timeframe::Unit::month, 1};
+
+    int count {0};
+    auto [end, ec] = std::from_chars(name.data(), name.data() + name.size(), count);
+    std::string_view unit {name.substr(end - name.data())};
+
+    if (ec == std::errc() && count > 0) {
+        if (unit == "min") return {Timeframe::Unit::minute, count};
+        if (unit == "h" && count <= INT_MAX / 60) return {Timeframe::Unit::minute, count * 60};
+    }
+
+    throw std::invalid_argument("Unknown timeframe '" + std::string(name) + "' (expected daily, weekly, monthly, <N>min or <N>h)");
+}
+
+std::string timeframe_name(const Timeframe& tf) {
+    switch (tf.unit) {
+        case Timeframe::Unit::day: return "daily";
+        case Timeframe::Unit::week: return "weekly";
+        case Timeframe::Unit::month: return "monthly";
+        default: return (tf.count % 60 == 0) ? std::to_string(tf.count / 60) + "h" : std::to_string(tf.count) + "min";
+    }
+}
+
+// rounds toward negative infinity, so timestamps before 1970 fall in the right bucket
+static std::int64_t floor_div(std::int64_t a, std::int64_t b) {
+    return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+// months since January 1970 of a day number (days since 1970-01-01), proleptic Gregorian
+static std::int64_t month_of_day(std::int64_t days) {
+    days += 719468;
+    std::int64_t era = floor_div(days, 146097);
+    std::int64_t doe = days - era * 146097;
+    std::int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    std::int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    std::int64_t mp = (5 * doy + 2) / 153;
+    std::int64_t month = (mp < 10) ? mp + 3 : mp - 9;
+    std::int64_t year = yoe + era * 400 + (month <= 2);
+
+    return (year - 1970) * 12 + month - 1;
+}
+
+std::int64_t timeframe_bucket(std::int64_t seconds, const Timeframe& tf) {
+    std::int64_t days = floor_div(seconds, 86400);
+
+    switch (tf.unit) {
+        case Timeframe::Unit::minute: return floor_div(seconds, 60 * static_cast<std::int64_t>(tf.count));
+        case Timeframe::Unit::day: return days;
+        // 1970-01-01 was a Thursday: shifting by 3 days starts weeks on Monday
+        case Timeframe::Unit::week: return floor_div(days + 3, 7);
+        default: return month_of_day(days);
+    }
+}
+
+
+ResampledBars resample(const BarsView& bars, const Timeframe& tf) {
+    int size = bars.size();
+
+    if (bars.timestamps.size() != bars.size()) throw std::invalid_argument("Resampling needs a Date column");
+
+    PROFILE_SCOPE("resample");
+
+    ResampledBars out;
+    BarData& r = out.bars;
+    bool ohlc {bars.has_ohlc()};
+    bool volume {bars.has_volume()};
+    std::int64_t current {0};
+
+    for (int i = 0; i < size; i++) {
+        std::int64_t bucket = timeframe_bucket(bars.timestamps[i], tf);
+
+        if (i > 0 && bucket < current) throw std::invalid_argument("Timestamps must be in ascending order to resample");
+
+        // a new bucket opens a bar; later bars of the bucket update it in place
+        if (i == 0 || bucket != current) {
+            if (i > 0) out.ends.push_back(i);
+
+            current = bucket;
+            r.close.push_back(bars.close[i]);
+            r.timestamps.push_back(bars.timestamps[i]);
+
+            if (ohlc) {
+                r.open.push_back(bars.open[i]);
+                r.high.push_back(bars.high[i]);
+                r.low.push_back(bars.low[i]);
+            }
+
+            if (volume) r.volume.push_back(bars.volume[i]);
+
+            continue;
+        }
+
+        r.close.back() = bars.close[i];
+
+        if (ohlc) {
+            r.high.back() = std::max(r.high.back(), bars.high[i]);
+            r.low.back() = std::min(r.low.back(), bars.low[i]);
+        }
+
+        if (volume) r.volume.back() += bars.volume[i];
+    }
+
+    if (size > 0) out.ends.push_back(size);
+
+    return out;
+}
@@ -0,0 +1,458 @@
+#include "../include/result_cache.h"
+#include "../include/profile.h"
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+
+namespace fs = std::filesystem;
+
+
+constexpr char RESULT_MAGIC[8] {'T', 'S', 'I', 'M', 'R', 'S', 'L', 'T'};
+constexpr char SOURCE_MAGIC[8] {'T', 'S', 'I', 'M', 'S', 'R', 'C', 'E'};
+constexpr std::uint32_t RESULT_VERSION {1};
+
+// entry file: header, the full key (program build + key), then the value
+struct ResultHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t data_hash;
+    std::uint64_t key_size;
+    std::uint64_t value_size;
+};
+
+// stamp file: header, then the source path it describes
+struct StampHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    SourceStamp stamp;
+    std::uint64_t path_size;
+};
+
+
+constexpr std::uint64_t PRIME_1 {0x9E3779B185EBCA87ull};
+constexpr std::uint64_t PRIME_2 {0xC2B2AE3D27D4EB4Full};
+constexpr std::uint64_t PRIME_3 {0x165667B19E3779F9ull};
+
+static std::uint64_t rotl(std::uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static std::uint64_t mix(std::uint64_t lane, std::uint64_t word) {
+    return rotl(lane + word * PRIME_2, 31) * PRIME_1;
+}
+
+static std::uint64_t load_word(const unsigned char* p) {
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+// 32-byte stripes feed four independent lanes (no dependency between consecutive words), then the
+// remaining words and bytes are folded in one at a time and the result is avalanched
+static std::uint64_t hash_bytes(const void* data, std::size_t size, std::uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+    std::uint64_t h {seed + PRIME_3};
+
+    if (size >= 32) {
+        std::uint64_t lanes[4] {seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1};
+
+        for (; p + 32 <= end; p += 32) {
+            for (int k = 0; k < 4; k++) lanes[k] = mix(lanes[k], load_word(p + 8 * k));
+        }
+
+        h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+    }
+
+    h += size;
+
+    for (; p + 8 <= end; p += 8) h = rotl(h ^ mix(0, load_word(p)), 27) * PRIME_1 + PRIME_3;
+    for (; p < end; p++) h = rotl(h ^ (*p * PRIME_3), 11) * PRIME_1;
+
+    h ^= h >> 33;
+    h *= PRIME_2;
+    h ^= h >> 29;
+    h *= PRIME_3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+std::uint64_t hash_bars(const BarsView& bars, std::size_t rows) {
+    rows = std::min(rows, bars.size());
+
+    bool timestamps = bars.timestamps.size() == bars.size();
+    std::uint64_t h {hash_bytes(bars.close.data(), rows * sizeof(double),
+                                (timestamps ? 1 : 0) | (bars.has_ohlc() ? 2 : 0) | (bars.has_volume() ? 4 : 0))};
+
+    if (timestamps) h = hash_bytes(bars.timestamps.data(), rows * sizeof(std::int64_t), h);
+
+    if (bars.has_ohlc()) {
+        h = hash_bytes(bars.open.data(), rows * sizeof(double), h);
+        h = hash_bytes(bars.high.data(), rows * sizeof(double), h);
+        h = hash_bytes(bars.low.data(), rows * sizeof(double), h);
+    }
+
+    if (bars.has_volume()) h = hash_bytes(bars.volume.data(), rows * sizeof(double), h);
+
+    return h;
+}
+
+
+std::optional<SourceStamp> stat_source(const std::string& path) {
+    std::error_code size_ec;
+    std::error_code time_ec;
+    SourceStamp stamp;
+
+    stamp.size = fs::file_size(path, size_ec);
+    stamp.mtime = fs::last_write_time(path, time_ec).time_since_epoch().count();
+
+    if (size_ec || time_ec) return std::nullopt;
+
+    return stamp;
+}
+
+static std::string hex(std::uint64_t value) {
+    std::ostringstream out;
+    out << std::hex;
+    out.width(16);
+    out.fill('0');
+    out << value;
+    return out.str();
+}
+
+static std::string read_whole(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+
+    if (!in.is_open()) return "";
+
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+
+// a rebuilt program may compute different results: its size and modification time are part of every key
+ResultCache::ResultCache(std::string directory) : dir(std::move(directory)) {
+    if (std::optional<SourceStamp> exe = stat_source("/proc/self/exe")) {
+        program = std::to_string(exe->size) + ":" + std::to_string(exe->mtime);
+    }
+}
+
+std::string ResultCache::entry_path(std::uint64_t data_hash, std::string_view key) const {
+    std::string full {program + "\n" + std::string(key)};
+
+    return dir + "/" + hex(hash_bytes(full.data(), full.size(), data_hash)) + ".result";
+}
+
+// write to a unique temporary file and rename it into place, so concurrent readers never see a partial entry
+void ResultCache::write_file(const std::string& path, std::string_view bytes) const {
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+    std::ostringstream tmp;
+    tmp << path << ".tmp." << getpid() << "." << std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+    {
+        std::ofstream out(tmp.str(), std::ios::binary | std::ios::trunc);
+
+        if (!out.is_open()) return;
+
+        out.write(bytes.data(), bytes.size());
+
+        if (!out) {
+            out.close();
+            fs::remove(tmp.str(), ec);
+            return;
+        }
+    }
+
+    fs::rename(tmp.str(), path, ec);
+
+    if (ec) fs::remove(tmp.str(), ec);
+}
+
+// the same file reached by different relative paths shares one stamp
+static std::string absolute_path(const std::string& path) {
+    std::error_code ec;
+    fs::path absolute {fs::absolute(path, ec)};
+
+    return (ec) ? path : absolute.lexically_normal().string();
+}
+
+static std::string stamp_path(const std::string& dir, const std::string& source) {
+    std::string absolute {absolute_path(source)};
+
+    return dir + "/source-" + hex(hash_bytes(absolute.data(), absolute.size(), 0)) + ".stamp";
+}
+
+std::optional<SourceStamp> ResultCache::source(const std::string& path) const {
+    std::string bytes {read_whole(stamp_path(dir, path))};
+    std::string absolute {absolute_path(path)};
+    StampHeader header;
+
+    if (bytes.size() != sizeof(header) + absolute.size()) return std::nullopt;
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, SOURCE_MAGIC, sizeof(SOURCE_MAGIC)) != 0 || header.version != RESULT_VERSION
+        || header.path_size != absolute.size() || bytes.compare(sizeof(header), std::string::npos, absolute) != 0) {
+        return std::nullopt;
+    }
+
+    return header.stamp;
+}
+
+void ResultCache::record(const std::string& path, const SourceStamp& stamp) const {
+    std::string absolute {absolute_path(path)};
+    StampHeader header {};
+
+    std::memcpy(header.magic, SOURCE_MAGIC, sizeof(SOURCE_MAGIC));
+    header.version = RESULT_VERSION;
+    header.stamp = stamp;
+    header.path_size = absolute.size();
+
+    std::string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytes += absolute;
+
+    write_file(stamp_path(dir, path), bytes);
+}
+
+std::optional<std::string> ResultCache::find(std::uint64_t data_hash, std::string_view key) const {
+    PROFILE_SCOPE("result cache");
+
+    std::string bytes {read_whole(entry_path(data_hash, key))};
+    std::string full {program + "\n" + std::string(key)};
+    ResultHeader header;
+
+    if (bytes.size() < sizeof(header)) return std::nullopt;
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    // the whole key is compared, so two keys with the same file name never mix up their values
+    if (std::memcmp(header.magic, RESULT_MAGIC, sizeof(RESULT_MAGIC)) != 0 || header.version != RESULT_VERSION
+        || header.data_hash != data_hash || header.key_size != full.size()
+        || bytes.size() != sizeof(header) + header.key_size + header.value_size
+        || bytes.compare(sizeof(header), full.size(), full) != 0) {
+        return std::nullopt;
+    }
+
+    return bytes.substr(sizeof(header) + full.size());
+}
+
+void ResultCache::store(std::uint64_t data_hash, std::string_view key, std::string_view value) const {
+    PROFILE_SCOPE("result cache");
+
+    std::string full {program + "\n" + std::string(key)};
+    ResultHeader header {};
+
+    std::memcpy(header.magic, RESULT_MAGIC, sizeof(RESULT_MAGIC));
+    header.version = RESULT_VERSION;
+    header.data_hash = data_hash;
+    header.key_size = full.size();
+    header.value_size = value.size();
+
+    std::string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytes += full;
+    bytes += value;
+
+    write_file(entry_path(data_hash, key), bytes);
+}
+
+
+template <typename T>
+static void put(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool take(std::string_view& in, T& value) {
+    if (in.size() < sizeof(value)) return false;
+
+    std::memcpy(&value, in.data(), sizeof(value));
+    in.remove_prefix(sizeof(value));
+
+    return true;
+}
+
+static void put_window(std::string& out, const RollingWindow& window) {
+    RollingWindow::State state {window.get_state()};
+
+    put(out, state.head);
+    put(out, state.count);
+    put(out, state.sum);
+    put(out, state.compensation);
+    out.append(reinterpret_cast<const char*>(state.buffer.data()), state.buffer.size() * sizeof(double));
+}
+
+static bool take_window(std::string_view& in, int window, RollingWindow::State& state) {
+    if (!take(in, state.head) || !take(in, state.count) || !take(in, state.sum) || !take(in, state.compensation)) return false;
+    if (in.size() < window * sizeof(double)) return false;
+
+    state.buffer.resize(window);
+    std::memcpy(state.buffer.data(), in.data(), window * sizeof(double));
+    in.remove_prefix(window * sizeof(double));
+
+    return true;
+}
+
+std::string save_state(const StreamingSMA& sma) {
+    std::string out;
+
+    put(out, sma.get_short_term());
+    put(out, sma.get_long_term());
+    put_window(out, sma.get_short_window());
+    put_window(out, sma.get_long_window());
+
+    return out;
+}
+
+std::string save_state(const StreamingMACD& macd) {
+    StreamingMACD::State state {macd.get_state()};
+    std::string out;
+
+    put(out, macd.get_short_term());
+    put(out, macd.get_long_term());
+    put(out, macd.get_signal_term());
+    put(out, static_cast<int>(macd.get_crossover()));
+    put(out, state.count);
+    put(out, state.short_ema);
+    put(out, state.long_ema);
+    put(out, state.macd);
+    put(out, state.signal_ema);
+    put(out, state.macd_count);
+
+    return out;
+}
+
+bool restore_state(std::string_view bytes, StreamingSMA& sma) {
+    int s {};
+    int l {};
+    RollingWindow::State short_state;
+    RollingWindow::State long_state;
+
+    if (!take(bytes, s) || !take(bytes, l) || s != sma.get_short_term() || l != sma.get_long_term()) return false;
+    if (!take_window(bytes, s, short_state) || !take_window(bytes, l, long_state) || !bytes.empty()) return false;
+
+    try {
+        StreamingSMA restored {sma};
+
+        restored.set_state(short_state, long_state);
+        sma = restored;
+    }
+    catch (const std::invalid_argument&) {
+        return false;
+    }
+
+    return true;
+}
+
+bool restore_state(std::string_view bytes, StreamingMACD& macd) {
+    int s {};
+    int l {};
+    int sig {};
+    int mode {};
+    StreamingMACD::State state {};
+
+    if (!take(bytes, s) || !take(bytes, l) || !take(bytes, sig) || !take(bytes, mode)) return false;
+    if (s != macd.get_short_term() || l != macd.get_long_term() || sig != macd.get_signal_term()
+        || mode != static_cast<int>(macd.get_crossover())) {
+        return false;
+    }
+
+    if (!take(bytes, state.count) || !take(bytes, state.short_ema) || !take(bytes, state.long_ema) || !take(bytes, state.macd)
+        || !take(bytes, state.signal_ema) || !take(bytes, state.macd_count) || !bytes.empty()) {
+        return false;
+    }
+
+    try {
+        macd.set_state(state);
+    }
+    catch (const std::invalid_argument&) {
+        return false;
+    }
+
+    return true;
+}
+
+
+std::optional<IndicatorReport> incremental_signals(const ResultCache& cache, const BarsView& bars,
+                                                   const std::optional<SourceStamp>& known, bool sma_on, bool macd_on,
+                                                   int signal_period, MACD::Crossover cross) {
+    PROFILE_SCOPE("incremental signals");
+
+    PriceView close {bars.close};
+    std::uint64_t hash {hash_bars(bars)};       // of the bars the states are computed on (resampled or not)
+    std::size_t rows = close.size();
+    std::string cross_name {(cross == MACD::Crossover::signal_line) ? "signal" : "zero"};
+    std::string sma_key {"state sma 50 200"};
+    std::string macd_key {"state macd 12 26 " + std::to_string(signal_period) + " " + cross_name};
+    std::optional<StreamingSMA> sma;
+    std::optional<StreamingMACD> macd;
+    std::size_t from {0};
+
+    if (sma_on) sma.emplace();
+    if (macd_on) macd.emplace(12, 26, signal_period, cross);
+
+    // the saved states describe the rows the cache saw last: they only apply if those rows are still
+    // the start of the series
+    if (known && known->rows <= rows && hash_bars(bars, known->rows) == known->hash) {
+        bool resumed {true};
+
+        if (sma) {
+            std::optional<std::string> state {cache.find(known->hash, sma_key)};
+            resumed = resumed && state && restore_state(*state, *sma);
+        }
+
+        if (macd) {
+            std::optional<std::string> state {cache.find(known->hash, macd_key)};
+            resumed = resumed && state && restore_state(*state, *macd);
+        }
+
+        if (resumed) {
+            from = known->rows;
+        } else {
+            if (sma_on) sma.emplace();
+            if (macd_on) macd.emplace(12, 26, signal_period, cross);
+        }
+    }
+
+    for (std::size_t i = from; i < rows; i++) {
+        if (sma) sma->push(close[i]);
+        if (macd) macd->push(close[i]);
+    }
+
+    if ((sma && !sma->ready()) || (macd && !macd->ready())) return std::nullopt;
+
+    IndicatorReport report;
+
+    if (sma) {
+        cache.store(hash, sma_key, save_state(*sma));
+        report.signals.push_back({"SMA", sma->get_short_term(), sma->get_long_term(), 0, "", sma->signal(), 1});
+    }
+
+    if (macd) {
+        cache.store(hash, macd_key, save_state(*macd));
+        report.signals.push_back({"MACD", macd->get_short_term(), macd->get_long_term(), signal_period, cross_name,
+                                  macd->signal(), 1});
+    }
+
+    tally_vote(report, 0, 0);
+
+    PROFILE_COUNT(Counter::indicator_calls, report.signals.size());
+
+    return report;
+}
@@ -0,0 +1,144 @@
+#include "../include/rolling.h"
+#include "../include/profile.h"
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+
+
+RollingWindow::RollingWindow(int w, bool c)
+    : buffer(w > 0 ? w : 0), window(w), compensated(c)
+{
+    if (w <= 0) throw std::invalid_argument("Rolling window size must be positive");
+}
+
+// add x to the running sum, tracking the rounding error when compensated
+void RollingWindow::accumulate(double x) {
+    if (!compensated) {
+        sum += x;
+        return;
+    }
+
+    double t {sum + x};
+
+    if (std::abs(sum) >= std::abs(x)) compensation += (sum - t) + x;
+    else compensation += (x - t) + sum;
+
+    sum = t;
+}
+
+void RollingWindow::push(double x) {
+    // evict the oldest value once the window is full
+    if (count == window) accumulate(-buffer[head]);
+    else count++;
+
+    buffer[head] = x;
+    accumulate(x);
+
+    if (++head == window) head = 0;
+}
+
+void RollingWindow::reset() {
+    head = 0;
+    count = 0;
+    sum = 0;
+    compensation = 0;
+}
+
+void RollingWindow::set_state(const State& state) {
+    if (static_cast<int>(state.buffer.size()) != window || state.head < 0 || state.head >= window
+        || state.count < 0 || state.count > window) {
+        throw std::invalid_argument("Rolling window state does not match the window size");
+    }
+
+    buffer = state.buffer;
+    head = state.head;
+    count = state.count;
+    sum = state.sum;
+    compensation = state.compensation;
+}
+
+double RollingWindow::mean() const {
+    if (count == 0) throw std::logic_error("Rolling window is empty");
+
+    return get_sum() / count;
+}
+
+std::vector<double> rolling_mean(PriceView p, int window, bool compensated) {
+    RollingWindow rolling(window, compensated);
+    std::vector<double> result(p.size() + 1);
+
+    rolling_mean_into(p, rolling, result.data());
+
+    return result;
+}
+
+void rolling_mean_into(PriceView p, RollingWindow& rolling, double* out) {
+    PROFILE_SCOPE("SMA window scan");
+
+    int size = p.size();
+
+    rolling.reset();
+    out[0] = 0;
+
+    for (int i = 0; i < size; i++) {
+        rolling.push(p[i]);
+
+        out[i + 1] = (rolling.full()) ? rolling.mean() : 0.0;
+    }
+}
+
+std::vector<double> rolling_stdev(PriceView p, int window, bool compensated) {
+    RollingWindow sum(window, compensated);
+    RollingWindow squares(window, compensated);
+    int size = p.size();
+    double shift = (size > 0) ? p[0] : 0.0;
+    std::vector<double> result(size + 1);
+
+    for (int i = 0; i < size; i++) {
+        double x {p[i] - shift};
+
+        sum.push(x);
+        squares.push(x * x);
+
+        if (sum.full()) {
+            double mean {sum.mean()};
+
+            // rounding can leave a tiny negative variance for a flat window
+            result[i + 1] = std::sqrt(std::max(0.0, squares.mean() - mean * mean));
+        }
+    }
+
+    return result;
+}
+
+// front of `candidates` is the extreme of the window; `better(a, b)` is true when a beats b
+template <typename Better>
+static std::vector<double> rolling_extreme(PriceView p, int window, Better better) {
+    if (window <= 0) throw std::invalid_argument("Rolling window size must be positive");
+
+    int size = p.size();
+    std::vector<double> result(size + 1);
+    std::deque<int> candidates;
+
+    for (int i = 0; i < size; i++) {
+        // a value beaten by a newer one can never be the extreme again
+        while (!candidates.empty() && !better(p[candidates.back()], p[i])) candidates.pop_back();
+
+        candidates.push_back(i);
+
+        if (candidates.front() <= i - window) candidates.pop_front();
+        if (i + 1 >= window) result[i + 1] = p[candidates.front()];
+    }
+
+    return result;
+}
+
+std::vector<double> rolling_min(PriceView p, int window) {
+    return rolling_extreme(p, window, [](double a, double b) { return a < b; });
+}
+
+std::vector<double> rolling_max(PriceView p, int window) {
+    return rolling_extreme(p, window, [](double a, double b) { return a > b; });
+}
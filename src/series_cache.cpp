@@ -0,0 +1,106 @@
+#include "../include/series_cache.h"
+#include "../include/rolling.h"
+#include "../include/ema.h"
+#include "../include/profile.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+
+SeriesCache::SeriesCache(const BarsView& b, bool c) : bars(b), compensated(c) {}
+
+SeriesCache::~SeriesCache() = default;
+
+PriceView SeriesCache::column(Source s) {
+    if (s == Source::close || ((s == Source::high || s == Source::low) && !bars.has_ohlc())) return bars.close;
+    if (s == Source::high) return bars.high;
+    if (s == Source::low) return bars.low;
+
+    auto [it, inserted] = series.try_emplace({Stat::source, s, 0});
+    std::vector<double>& out = it->second;
+
+    if (!inserted) return out;
+
+    PriceView close {bars.close};
+    int n = size();
+
+    out.assign(n, 0.0);
+
+    for (int i = 1; i < n; i++) {
+        double change {close[i] - close[i - 1]};
+
+        if (s == Source::gain) out[i] = std::max(change, 0.0);
+        else if (s == Source::loss) out[i] = std::max(-change, 0.0);
+        else if (!bars.has_ohlc()) out[i] = std::abs(change);
+        else out[i] = std::max({bars.high[i] - bars.low[i], std::abs(bars.high[i] - close[i - 1]),
+                                std::abs(bars.low[i] - close[i - 1])});
+    }
+
+    if (s == Source::true_range && bars.has_ohlc() && n > 0) out[0] = bars.high[0] - bars.low[0];
+
+    return out;
+}
+
+const std::vector<double>& SeriesCache::statistic(Stat stat, Source s, int window) {
+    // highs and lows of close-only bars are the closes: share their statistics
+    if (!bars.has_ohlc() && (s == Source::high || s == Source::low)) s = Source::close;
+
+    auto it = series.find({stat, s, window});
+
+    if (it != series.end()) return it->second;
+
+    PROFILE_SCOPE("indicator series");
+
+    // a derived source is cached like any statistic (map inserts keep earlier references valid)
+    PriceView p {column(s)};
+    std::vector<double> result;
+
+    switch (stat) {
+        case Stat::mean: result = rolling_mean(p, window, compensated); break;
+        case Stat::stdev: result = rolling_stdev(p, window, compensated); break;
+        case Stat::min: result = rolling_min(p, window); break;
+        case Stat::max: result = rolling_max(p, window); break;
+        default: result = ema_series(p, window); break;
+    }
+
+    return series.emplace(std::make_tuple(stat, s, window), std::move(result)).first->second;
+}
+
+const std::vector<double>& SeriesCache::mean(Source s, int window) {
+    return statistic(Stat::mean, s, window);
+}
+
+const std::vector<double>& SeriesCache::stdev(Source s, int window) {
+    return statistic(Stat::stdev, s, window);
+}
+
+const std::vector<double>& SeriesCache::min(Source s, int window) {
+    return statistic(Stat::min, s, window);
+}
+
+const std::vector<double>& SeriesCache::max(Source s, int window) {
+    return statistic(Stat::max, s, window);
+}
+
+const std::vector<double>& SeriesCache::ema(Source s, int span) {
+    return statistic(Stat::ema, s, span);
+}
+
+TimeframeSeries& SeriesCache::timeframe(const Timeframe& tf) {
+    std::unique_ptr<TimeframeSeries>& entry = timeframes[{tf.unit, tf.count}];
+
+    if (!entry) entry = std::make_unique<TimeframeSeries>(bars, tf, compensated);
+
+    return *entry;
+}
+
+
+// the cache views the resampled columns, which never move once built
+TimeframeSeries::TimeframeSeries(const BarsView& source, const Timeframe& t, bool compensated)
+    : tf(t),
+      resampled(resample(source, t)),
+      cache({resampled.bars.open, resampled.bars.high, resampled.bars.low, resampled.bars.close,
+             resampled.bars.volume, resampled.bars.timestamps}, compensated) {}
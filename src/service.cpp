@@ -0,0 +1,769 @@
+#include "../include/service.h"
+#include "../include/batch.h"
+#include "../include/profile.h"
+#include "../include/report.h"
+#include "../include/strategy_config.h"
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+
+// how often blocked socket reads and accepts check whether the service is stopping
+constexpr int POLL_MS {100};
+
+// a connection sending a longer line without a newline is dropped
+constexpr std::size_t MAX_REQUEST_BYTES {1 << 16};
+
+// requests read ahead of their responses per pool thread; past it, the reader waits for responses
+constexpr int IN_FLIGHT_PER_THREAD {4};
+
+
+// ---- request parsing ----
+
+// a scalar JSON value: strings unescaped, everything else as written
+struct JsonValue {
+    std::string text;
+    bool is_string {};
+};
+
+static void skip_space(std::string_view s, std::size_t& i) {
+    while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r' || s[i] == '\n')) i++;
+}
+
+static std::string parse_string(std::string_view s, std::size_t& i) {
+    std::string text;
+
+    for (i++; i < s.size() && s[i] != '"'; i++) {
+        if (s[i] != '\\') {
+            text += s[i];
+            continue;
+        }
+
+        if (++i == s.size()) break;
+
+        switch (s[i]) {
+            case '"': case '\\': case '/': text += s[i]; break;
+            case 'b': text += '\b'; break;
+            case 'f': text += '\f'; break;
+            case 'n': text += '\n'; break;
+            case 'r': text += '\r'; break;
+            case 't': text += '\t'; break;
+            case 'u': {
+                // tickers, kinds and parameters are ASCII
+                unsigned code {};
+                auto [end, ec] = std::from_chars(s.data() + i + 1, s.data() + std::min(i + 5, s.size()), code, 16);
+
+                if (ec != std::errc() || end != s.data() + i + 5 || code >= 0x80) {
+                    throw std::invalid_argument("only ASCII \\u escapes are supported");
+                }
+
+                text += static_cast<char>(code);
+                i += 4;
+                break;
+            }
+            default: throw std::invalid_argument("invalid escape in string");
+        }
+    }
+
+    if (i == s.size()) throw std::invalid_argument("unterminated string");
+
+    i++;
+
+    return text;
+}
+
+static JsonValue parse_value(std::string_view s, std::size_t& i) {
+    if (i == s.size()) throw std::invalid_argument("missing value");
+    if (s[i] == '"') return {parse_string(s, i), true};
+    if (s[i] == '{' || s[i] == '[') throw std::invalid_argument("nested values are not supported");
+
+    std::size_t begin {i};
+
+    while (i < s.size() && s[i] != ',' && s[i] != '}' && s[i] != ' ' && s[i] != '\t' && s[i] != '\r' && s[i] != '\n') i++;
+
+    std::string token {s.substr(begin, i - begin)};
+    double number {};
+    auto [end, ec] = std::from_chars(token.data(), token.data() + token.size(), number);
+
+    if (token != "true" && token != "false" && token != "null"
+        && (token.empty() || ec != std::errc() || end != token.data() + token.size())) {
+        throw std::invalid_argument("invalid value '" + token + "'");
+    }
+
+    return {token, false};
+}
+
+static void write_json_string(std::string_view text, std::string& out) {
+    out += '"';
+
+    for (char c : text) {
+        if (c == '"' || c == '\\') (out += '\\') += c;
+        else if (c == '\n') out += "\\n";
+        else if (static_cast<unsigned char>(c) < 0x20) out += ' ';
+        else out += c;
+    }
+
+    out += '"';
+}
+
+static int to_int(const std::string& key, const JsonValue& value) {
+    int result {};
+    auto [end, ec] = std::from_chars(value.text.data(), value.text.data() + value.text.size(), result);
+
+    if (value.is_string || ec != std::errc() || end != value.text.data() + value.text.size()) {
+        throw std::invalid_argument("'" + key + "' must be an integer");
+    }
+
+    return result;
+}
+
+static const std::string& to_text(const std::string& key, const JsonValue& value) {
+    if (!value.is_string) throw std::invalid_argument("'" + key + "' must be a string");
+
+    return value.text;
+}
+
+// the fields of a flat JSON object, in order
+static std::vector<std::pair<std::string, JsonValue>> parse_object(std::string_view line) {
+    std::vector<std::pair<std::string, JsonValue>> fields;
+    std::size_t i {0};
+
+    skip_space(line, i);
+
+    if (i == line.size() || line[i] != '{') throw std::invalid_argument("a request must be a JSON object");
+
+    i++;
+    skip_space(line, i);
+
+    while (i < line.size() && line[i] != '}') {
+        if (!fields.empty()) {
+            if (line[i] != ',') throw std::invalid_argument("expected ',' between fields");
+
+            i++;
+            skip_space(line, i);
+        }
+
+        if (i == line.size() || line[i] != '"') throw std::invalid_argument("expected a field name");
+
+        std::string key {parse_string(line, i)};
+
+        skip_space(line, i);
+
+        if (i == line.size() || line[i] != ':') throw std::invalid_argument("expected ':' after '" + key + "'");
+
+        i++;
+        skip_space(line, i);
+
+        JsonValue value {parse_value(line, i)};
+
+        skip_space(line, i);
+
+        for (const auto& field : fields) {
+            if (field.first == key) throw std::invalid_argument("duplicate field '" + key + "'");
+        }
+
+        fields.push_back({key, value});
+    }
+
+    if (i == line.size()) throw std::invalid_argument("unterminated object");
+
+    i++;
+    skip_space(line, i);
+
+    if (i != line.size()) throw std::invalid_argument("unexpected text after the object");
+
+    return fields;
+}
+
+void parse_request(std::string_view line, ServiceRequest& request) {
+    std::vector<std::pair<std::string, JsonValue>> fields {parse_object(line)};
+
+    // the id first, so errors in the other fields are still answered to it
+    for (const auto& [key, value] : fields) {
+        if (key != "id") continue;
+
+        request.id.clear();
+
+        if (value.is_string) write_json_string(value.text, request.id);
+        else request.id = value.text;
+    }
+
+    for (const auto& [key, value] : fields) {
+        if (key == "id") {
+            continue;
+        } else if (key == "stats") {
+            if (value.is_string || (value.text != "true" && value.text != "false")) {
+                throw std::invalid_argument("'stats' must be true or false");
+            }
+
+            request.stats = (value.text == "true");
+        } else if (key == "ticker") {
+            request.ticker = to_text(key, value);
+        } else if (key == "strategy") {
+            request.strategy = to_text(key, value);
+
+            if (request.strategy != "both" && !is_strategy_kind(request.strategy)) {
+                throw std::invalid_argument("unknown strategy '" + request.strategy + "'");
+            }
+        } else if (key == "mode") {
+            const std::string& mode = to_text(key, value);
+
+            if (mode != "indicator" && mode != "backtest" && mode != "both") {
+                throw std::invalid_argument("'mode' must be indicator, backtest or both");
+            }
+
+            request.indicator = (mode != "backtest");
+            request.backtest = (mode != "indicator");
+        } else if (key == "stocks") {
+            request.stocks = to_int(key, value);
+
+            if (request.stocks <= 0) throw std::invalid_argument("Invalid number of stocks");
+        } else {
+            if (!value.is_string && (value.text == "true" || value.text == "false" || value.text == "null")) {
+                throw std::invalid_argument("'" + key + "' must be a number or a string");
+            }
+
+            request.params.push_back({key, value.text});
+        }
+    }
+
+    if (!request.stats && request.ticker.empty()) throw std::invalid_argument("missing 'ticker'");
+
+    if (request.strategy == "both" && !request.params.empty()) {
+        throw std::invalid_argument("parameter '" + request.params[0].first + "' needs a single strategy");
+    }
+}
+
+
+// ---- service ----
+
+// i.e. "sma short=20 long=50": strategies with the same key are built once per ticker
+static std::string strategy_key(const StrategySpec& spec) {
+    std::string key {spec.kind};
+
+    for (const auto& [name, value] : spec.params) key += " " + name + "=" + value;
+
+    return key;
+}
+
+// the period part of a 'start to end' file name sorts by its end date, then the longer history first
+static bool newer_export(const std::string& period, const std::string& than) {
+    std::string end {(period.size() > 14) ? period.substr(14) : period};
+    std::string than_end {(than.size() > 14) ? than.substr(14) : than};
+
+    if (end != than_end) return end > than_end;
+
+    return period < than;
+}
+
+BacktestService::BacktestService(const std::vector<std::string>& files, bool c, const ExecutionModel& e)
+    : use_cache(c), execution(e)
+{
+    std::map<std::string, std::string> periods;
+
+    // a ticker exported more than once is served from its latest file
+    for (const std::string& file : files) {
+        std::string ticker;
+        std::string period;
+
+        parse_data_file_name(file, ticker, period);
+
+        auto found = periods.find(ticker);
+
+        if (found != periods.end() && !newer_export(period, found->second)) continue;
+
+        periods[ticker] = period;
+
+        if (!tickers.count(ticker)) tickers[ticker] = std::make_unique<Ticker>();
+
+        tickers[ticker]->path = file;
+    }
+}
+
+std::vector<std::string> BacktestService::get_tickers() const {
+    std::vector<std::string> names;
+
+    for (const auto& entry : tickers) names.push_back(entry.first);
+
+    return names;
+}
+
+std::size_t BacktestService::cached_strategies(const std::string& name) const {
+    auto found = tickers.find(name);
+
+    if (found == tickers.end()) return 0;
+
+    std::lock_guard<std::mutex> lock(found->second->mutex);
+
+    return found->second->strategies.size();
+}
+
+// a strategy on the ticker's current cache, which is retired once it has served MAX_STRATEGIES builds
+StrategyEntry BacktestService::build(Ticker& ticker, const StrategySpec& spec) {
+    if (!ticker.cache || ticker.built == MAX_STRATEGIES) {
+        ticker.cache = std::make_shared<SeriesCache>(ticker.series->bars());
+        ticker.built = 0;
+    }
+
+    // the strategy owns the cache it was built on (a timeframe strategy views the cache's resampled bars)
+    struct Built {
+        std::shared_ptr<SeriesCache> cache;
+        std::shared_ptr<const Strategy> strategy;
+    };
+
+    StrategyEntry entry {make_strategy(spec, *ticker.cache)};
+    auto built = std::make_shared<Built>(Built {ticker.cache, std::move(entry.strategy)});
+
+    entry.strategy = std::shared_ptr<const Strategy>(built, built->strategy.get());
+    ticker.built++;
+
+    return entry;
+}
+
+// drop the least recently used strategy past MAX_STRATEGIES; requests running it keep their copy
+void BacktestService::evict(Ticker& ticker) {
+    if (ticker.strategies.size() <= MAX_STRATEGIES) return;
+
+    auto oldest = std::min_element(ticker.strategies.begin(), ticker.strategies.end(),
+                                   [](const auto& a, const auto& b) { return a.second.used < b.second.used; });
+
+    ticker.strategies.erase(oldest);
+}
+
+std::string BacktestService::run(const ServiceRequest& request) {
+    auto found = tickers.find(request.ticker);
+
+    if (found == tickers.end()) throw std::invalid_argument("unknown ticker '" + request.ticker + "'");
+
+    Ticker& ticker = *found->second;
+    std::vector<StrategySpec> specs;
+
+    if (request.strategy == "both") {
+        specs.push_back({"sma", {}, "", 1});
+        specs.push_back({"macd", {}, "", 1});
+    } else {
+        specs.push_back({request.strategy, request.params, "", 1});
+    }
+
+    std::vector<StrategyEntry> entries;
+    PriceView price;
+
+    // loading and building share the ticker's cache, which is not thread-safe
+    {
+        std::lock_guard<std::mutex> lock(ticker.mutex);
+
+        if (!ticker.series) {
+            PriceSeries series {load_prices(ticker.path, use_cache)};
+
+            if (series.prices().empty()) throw std::runtime_error("no data in '" + ticker.path + "'");
+
+            ticker.series.emplace(std::move(series));
+        }
+
+        for (const StrategySpec& spec : specs) {
+            std::string key {strategy_key(spec)};
+            auto found = ticker.strategies.find(key);
+
+            if (found == ticker.strategies.end()) found = ticker.strategies.emplace(key, Cached {build(ticker, spec), 0}).first;
+
+            found->second.used = ++ticker.lookups;
+            entries.push_back(found->second.entry);
+            evict(ticker);
+        }
+
+        price = ticker.series->prices();
+    }
+
+    Simulator sim(std::move(entries), price);
+    sim.set_execution(execution);
+
+    RunReport report;
+    report.ticker = request.ticker;
+    report.current_price = price.at(price.size() - 1);
+    report.days = price.size();
+    report.stocks = request.stocks;
+
+    if (request.indicator) report.indicator = sim.indicator_report();
+    if (request.backtest) report.backtest = sim.backtest_report(request.stocks);
+
+    std::string json {format_run(report, OutputFormat::json)};
+
+    if (!json.empty() && json.back() == '\n') json.pop_back();
+
+    return json;
+}
+
+static void append_number(double value, std::string& out) {
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), (std::isfinite(value)) ? value : 0);
+
+    out.append(buffer, end - buffer);
+}
+
+std::string BacktestService::handle(std::string_view line) {
+    PROFILE_SCOPE("service request");
+
+    ServiceRequest request;
+    const std::string& id = request.id;
+    std::string response;
+
+    try {
+        parse_request(line, request);
+
+        if (request.stats) {
+            ServiceSummary s {get_summary()};
+
+            response = "{\"id\":" + id + ",\"ok\":true,\"stats\":{\"requests\":" + std::to_string(s.requests)
+                     + ",\"errors\":" + std::to_string(s.errors) + ",\"latency_us\":{\"mean\":";
+            append_number(s.latency.mean_us(), response);
+            response += ",\"p50\":";
+            append_number(s.latency.percentile_us(0.50), response);
+            response += ",\"p90\":";
+            append_number(s.latency.percentile_us(0.90), response);
+            response += ",\"p99\":";
+            append_number(s.latency.percentile_us(0.99), response);
+            response += ",\"max\":";
+            append_number(s.latency.max_us(), response);
+            response += "}}}\n";
+        } else {
+            response = "{\"id\":" + id + ",\"ok\":true,\"result\":" + run(request) + "}\n";
+        }
+    }
+    catch (const std::exception& e) {
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            summary.errors++;
+        }
+
+        response = "{\"id\":" + id + ",\"ok\":false,\"error\":";
+        write_json_string(e.what(), response);
+        response += "}\n";
+    }
+
+    return response;
+}
+
+void BacktestService::record(double ns) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+
+    summary.requests++;
+    summary.latency.record(ns);
+}
+
+ServiceSummary BacktestService::get_summary() const {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+
+    return summary;
+}
+
+
+// ---- transports ----
+
+// an answered request, with the time its line was read
+struct Response {
+    std::string bytes;
+    std::chrono::steady_clock::time_point start;
+};
+
+// answer `line` on the pool and hand the response to `deliver`
+static void submit_request(BacktestService& service, ThreadPool& pool, std::string line,
+                           std::function<void(Response)> deliver) {
+    auto start = std::chrono::steady_clock::now();
+
+    pool.submit([&service, line = std::move(line), deliver = std::move(deliver), start]() {
+        deliver({service.handle(line), start});
+    });
+}
+
+// count a response once it is written: the latency runs from reading its line to the end of the write
+static void record_written(BacktestService& service, const Response& response) {
+    service.record(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - response.start).count());
+}
+
+// requests read ahead of their responses: a reader stops reading at this many
+static int in_flight_limit(const ThreadPool& pool) {
+    return IN_FLIGHT_PER_THREAD * pool.get_size();
+}
+
+static bool blank(std::string_view line) {
+    return line.find_first_not_of(" \t\r") == std::string_view::npos;
+}
+
+void serve_stream(BacktestService& service, std::istream& in, std::ostream& out, ThreadPool& pool) {
+    std::mutex mutex;                   // one response written at a time
+    std::condition_variable written;
+    int in_flight {0};
+    int limit {in_flight_limit(pool)};
+    std::string line;
+
+    auto deliver = [&](Response response) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        out.write(response.bytes.data(), response.bytes.size());
+        out.flush();
+        record_written(service, response);
+
+        // notified under the lock: serve_stream may return as soon as it sees the count
+        in_flight--;
+        written.notify_all();
+    };
+
+    while (std::getline(in, line)) {
+        if (blank(line)) continue;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            written.wait(lock, [&]() { return in_flight < limit; });
+            in_flight++;
+        }
+
+        submit_request(service, pool, std::move(line), deliver);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    written.wait(lock, [&]() { return in_flight == 0; });
+}
+
+
+// a client connection, closed once its reader and every response to it are done
+// pool workers only queue responses and wake the reader, which writes them without blocking, so a
+// client that does not read its responses stalls nothing but its own connection
+struct Connection {
+    int fd;
+    int wake;                   // eventfd, signalled when a response is queued
+    std::mutex mutex;
+    std::deque<Response> outbox;
+
+    explicit Connection(int f) : fd(f), wake(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {}
+
+    ~Connection() {
+        ::close(fd);
+
+        if (wake >= 0) ::close(wake);
+    }
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    void queue(Response response) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            outbox.push_back(std::move(response));
+        }
+
+        ::eventfd_write(wake, 1);
+    }
+};
+
+static void serve_connection(BacktestService& service, int fd, ThreadPool& pool, const std::atomic<bool>& stop) {
+    std::shared_ptr<Connection> connection {std::make_shared<Connection>(fd)};
+
+    if (connection->wake < 0) return;
+
+    auto deliver = [connection](Response response) { connection->queue(std::move(response)); };
+    std::deque<Response> sending;       // taken from the outbox, the first one `sent` bytes in
+    std::size_t sent {0};
+    int in_flight {0};                  // requests read whose response is not written yet
+    int limit {in_flight_limit(pool)};
+    bool open {true};                   // the client may still send requests
+    std::string buffer;
+    char chunk[4096];
+
+    // submit the complete lines of the buffer while under the limit, and its rest once the client is done
+    auto take_requests = [&]() {
+        std::size_t begin {0};
+
+        for (std::size_t end; in_flight < limit && (end = buffer.find('\n', begin)) != std::string::npos; begin = end + 1) {
+            std::string line {buffer.substr(begin, end - begin)};
+
+            if (blank(line)) continue;
+
+            submit_request(service, pool, std::move(line), deliver);
+            in_flight++;
+        }
+
+        buffer.erase(0, begin);
+
+        if (buffer.find('\n') != std::string::npos) return;
+
+        if (open && buffer.size() > MAX_REQUEST_BYTES) {
+            open = false;
+            buffer.clear();
+        }
+
+        // a last request without its newline
+        if (!open && in_flight < limit && !buffer.empty()) {
+            if (!blank(buffer)) {
+                submit_request(service, pool, std::move(buffer), deliver);
+                in_flight++;
+            }
+
+            buffer.clear();
+        }
+    };
+
+    while (true) {
+        if (stop && open) {
+            open = false;
+            buffer.clear();
+        }
+
+        take_requests();
+
+        // the wakeup is consumed before the outbox is taken, so a response queued after it wakes the next poll
+        eventfd_t woken;
+        ::eventfd_read(connection->wake, &woken);
+
+        {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+
+            for (Response& response : connection->outbox) sending.push_back(std::move(response));
+
+            connection->outbox.clear();
+        }
+
+        while (!sending.empty()) {
+            const std::string& bytes = sending.front().bytes;
+            ssize_t n = ::send(fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+
+            // a client that went away just misses its responses
+            if (n <= 0) return;
+
+            sent += n;
+
+            if (sent == bytes.size()) {
+                record_written(service, sending.front());
+                sending.pop_front();
+                sent = 0;
+                in_flight--;
+            }
+        }
+
+        if (!open && buffer.empty() && in_flight == 0) return;
+
+        short events = ((open && in_flight < limit) ? POLLIN : 0) | (sending.empty() ? 0 : POLLOUT);
+        pollfd waiting[2] {{fd, events, 0}, {connection->wake, POLLIN, 0}};
+        int ready = ::poll(waiting, 2, POLL_MS);
+
+        if (ready < 0 && errno != EINTR) return;
+
+        // a stopping service does not wait on a client that takes none of its responses
+        if (ready == 0 && stop && !sending.empty()) return;
+        if (ready <= 0) continue;
+
+        if ((waiting[0].revents & (POLLERR | POLLHUP | POLLNVAL)) && !(waiting[0].revents & POLLIN)) return;
+        if (!(waiting[0].revents & POLLIN)) continue;
+
+        ssize_t n = ::read(fd, chunk, sizeof(chunk));
+
+        if (n < 0 && errno == EINTR) continue;
+
+        if (n > 0) {
+            buffer.append(chunk, n);
+        } else {
+            // a read error drops the unfinished request
+            if (n < 0) buffer.clear();
+
+            open = false;
+        }
+    }
+}
+
+void serve_socket(BacktestService& service, const std::string& path, ThreadPool& pool, const std::atomic<bool>& stop) {
+    sockaddr_un address {};
+
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) throw std::runtime_error("Invalid socket path: '" + path + "'");
+
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (listener < 0) throw std::runtime_error("Failed to create socket: " + std::string(std::strerror(errno)));
+
+    // only a socket left by an earlier run is replaced, never another file
+    struct stat existing {};
+
+    if (::lstat(path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) ::unlink(path.c_str());
+
+    if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener, SOMAXCONN) != 0) {
+        std::string reason {std::strerror(errno)};
+
+        ::close(listener);
+        throw std::runtime_error("Failed to listen on '" + path + "': " + reason);
+    }
+
+    struct Reader {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+
+    std::vector<Reader> readers;
+
+    while (!stop) {
+        pollfd waiting {listener, POLLIN, 0};
+
+        if (::poll(&waiting, 1, POLL_MS) <= 0) continue;
+
+        int fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+
+        if (fd < 0) continue;
+
+        // readers of closed connections are joined as new ones arrive, so a long-running service
+        // holds one thread per open connection
+        for (std::size_t i = 0; i < readers.size();) {
+            if (*readers[i].done) {
+                readers[i].thread.join();
+                readers[i] = std::move(readers.back());
+                readers.pop_back();
+            } else {
+                i++;
+            }
+        }
+
+        auto done = std::make_shared<std::atomic<bool>>(false);
+
+        readers.push_back({std::thread([&service, fd, &pool, &stop, done]() {
+            serve_connection(service, fd, pool, stop);
+            *done = true;
+        }), done});
+    }
+
+    for (Reader& reader : readers) reader.thread.join();
+
+    pool.wait();
+
+    ::close(listener);
+    ::unlink(path.c_str());
+}
+
+void print_service_summary(const ServiceSummary& summary, std::ostream& out) {
+    out << "\n [ Service Summary ]" << "\n\n"
+        << " Requests answered: " << summary.requests << "\n"
+        << " Errors: " << summary.errors << "\n"
+        << " Request latency (us): mean " << summary.latency.mean_us()
+        << ", p50 " << summary.latency.percentile_us(0.50)
+        << ", p90 " << summary.latency.percentile_us(0.90)
+        << ", p99 " << summary.latency.percentile_us(0.99)
+        << ", max " << summary.latency.max_us() << "\n";
+}
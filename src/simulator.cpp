@@ -1,164 +1,217 @@
 #include "../include/simulator.h"
+#include "../include/profile.h"
+#include "../include/backtest.h"
 #include <stdexcept>
 #include <optional>
 #include <iostream>
-#include <cmath>
 #include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 
-Simulator::Simulator(const SMA& s, const std::vector<double>& p) 
-    : sma(s), macd(std::nullopt), price(p), size(p.size()), start_day(s.get_long_term()) {}
+void check_vote_rule(const VoteRule& rule) {
+    if (!(-1 <= rule.sell && rule.sell <= rule.buy && rule.buy <= 1)) {
+        throw std::invalid_argument("Vote thresholds must satisfy -1 <= sell <= buy <= 1");
+    }
+}
 
-Simulator::Simulator(const MACD& m, const std::vector<double>& p) 
-    : sma(std::nullopt), macd(m), price(p), size(p.size()), start_day(m.get_long_term()) {}
 
-Simulator::Simulator(const SMA& s, const MACD& m, const std::vector<double>& p) 
-    : sma(s), macd(m), price(p), size(p.size()),
-      start_day(std::max(s.get_long_term(), m.get_long_term())) {}
+Simulator::Simulator(std::vector<StrategyEntry> strategies, PriceView p)
+    : price(p), size(p.size()) {
+    if (strategies.empty()) throw std::invalid_argument("Simulator needs at least one strategy");
 
-void Simulator::break_line() const {
-    std::cout << "------------------------------" << "\n";
+    for (StrategyEntry& e : strategies) add_strategy(std::move(e.name), std::move(e.strategy), e.weight);
 }
 
-void Simulator::indicator_sma(bool signal) const {
-    std::cout << " Strategy: SMA (" << sma->get_short_term() 
-              << "/" << sma->get_long_term() << ")" << "\n"
-              << " Signal: ";
+Simulator::Simulator(const SMA& s, PriceView p)
+    : Simulator({{"SMA", std::make_shared<SMA>(s), 1}}, p) {}
+
+Simulator::Simulator(const MACD& m, PriceView p)
+    : Simulator({{"MACD", std::make_shared<MACD>(m), 1}}, p) {}
 
-    // conditional signal and coloring
-    std::cout << ((signal) ? "\033[32mBUY\033[0m" : "\033[31mSELL\033[0m") << "\n";
+Simulator::Simulator(const SMA& s, const MACD& m, PriceView p)
+    : Simulator({{"SMA", std::make_shared<SMA>(s), 1}, {"MACD", std::make_shared<MACD>(m), 1}}, p) {}
 
-    break_line();
+void Simulator::add_strategy(std::string name, std::shared_ptr<const Strategy> strategy, double weight) {
+    if (!strategy) throw std::invalid_argument("Strategy cannot be empty");
+    if (!(weight > 0)) throw std::invalid_argument("Strategy weight must be positive");
+
+    start_day = std::max(start_day, strategy->first_signal_day());
+    total_weight += weight;
+    entries.push_back({std::move(name), std::move(strategy), weight});
 }
 
-void Simulator::indicator_macd(bool signal) const {
-    std::cout << " Strategy: MACD (" << macd->get_short_term() 
-              << "/" << macd->get_long_term() << ")" << "\n"
-              << " Signal: ";
+void Simulator::set_vote(const VoteRule& rule) {
+    check_vote_rule(rule);
+
+    vote = rule;
+    vote_backtest = true;
+}
 
-    // consditional signal and coloring
-    std::cout << ((signal) ? "\033[32mBUY\033[0m" : "\033[31mSELL\033[0m") << "\n";
+void Simulator::set_combination(Combine mode) {
+    if (entries.size() < 2) throw std::invalid_argument("Combining strategies needs at least two of them");
 
-    break_line();
+    combination = mode;
 }
 
-// give live-data indicator for buy/sell
-void Simulator::indicator() const {
-    if (!sma && !macd) return;
+void Simulator::set_open_fill(PriceView open) {
+    if (open.size() != price.size()) throw std::invalid_argument("Filling at the open needs an Open column for every day");
 
-    int recommendation {};
+    open_price = open;
+}
 
-    std::cout << " [ Trading Signal ]" << "\n\n";
+void Simulator::set_execution(const ExecutionModel& model) {
+    check_execution_model(model);
 
-    if (sma) {
-        bool sma_signal {sma->indicator()};
+    execution = model;
+}
 
-        indicator_sma(sma_signal);
+void Simulator::set_metrics(bool on) {
+    with_metrics = on;
+}
 
-        if (sma_signal) recommendation++;
-        else recommendation--;
-    }    
+// live-data buy/sell signal of every strategy, and their weighted vote
+IndicatorReport Simulator::indicator_report() const {
+    PROFILE_SCOPE("indicator");
 
-    if (macd) {
-        bool macd_signal {macd->indicator()};
+    IndicatorReport report;
 
-        indicator_macd(macd_signal);
+    for (const StrategyEntry& e : entries) {
+        SignalReport signal {e.name, e.strategy->get_short_term(), e.strategy->get_long_term(), 0, "",
+                             e.strategy->indicator(), e.weight};
 
-        if (macd_signal) recommendation++;
-        else recommendation--;
+        if (const MACD* macd = dynamic_cast<const MACD*>(e.strategy.get())) {
+            signal.signal_term = macd->get_signal_term();
+            signal.crossover = (macd->get_crossover() == MACD::Crossover::signal_line) ? "signal" : "zero";
+        }
+
+        report.signals.push_back(signal);
     }
 
-    // give final recommendation
-    if (recommendation > 1) std::cout << " Recommendation: \033[32mSTRONG BUY\033[0m" << "\n";
-    if (recommendation < -1) std::cout << " Recommendation: \033[31mSTRONG SELL\033[0m" << "\n";
-    if (recommendation == 0) std::cout << " Recommendation: MIXED SIGNAL" << "\n";
+    tally_vote(report, vote.buy, vote.sell);
+
+    PROFILE_COUNT(Counter::indicator_calls, report.signals.size());
+
+    return report;
 }
 
-// conditional naming and coloring
-void Simulator::print_profit(double profit, double percent) const {
-    if (profit > 0) {
-        std::cout << "\033[32m Profit: +$" << profit << "\n"
-                  << " Percentage: +" << percent << "%\033[0m\n";
-    } else if (profit < 0) {
-        std::cout << "\033[31m Losses: -$" << std::abs(profit) << "\n"
-                  << " Percentage: -" << std::abs(percent) << "%\033[0m\n";
-    } else {
-        std::cout << " Profit: ---" << "\n" << " Percentage: ---" << "\n";
+// historical backtest of every strategy (and their combination and vote), compared to buy and hold
+BacktestReport Simulator::backtest_report(int stocks) const {
+    if (stocks <= 0) throw std::invalid_argument("Error: Invalid number of stocks");
+
+    PROFILE_SCOPE("backtest");
+
+    BacktestReport report;
+
+    // with open fills every strategy starts a day later, so lagged decisions are valid too
+    PriceView fill {(open_price) ? *open_price : price};
+    int first = start_day + ((open_price) ? 1 : 0);
+    int count = entries.size();
+
+    report.stocks = stocks;
+    report.execution = execution;
+    report.first_price = fill[std::min<std::size_t>(execution.delay, fill.size() - 1)];
+    report.last_price = fill.back();
+
+    // one arena for every strategy of the report
+    MetricsArena arena;
+
+    auto run = [&](std::string name, auto signal) {
+        StrategyReport s {name, backtest_vectorized(fill, first, stocks, signal, execution), std::nullopt, {}};
+
+        if (with_metrics) {
+            s.metrics = signal_metrics(fill, first, stocks, signal, execution, arena);
+            s.trades = arena.ledger;
+        }
+
+        return s;
+    };
+
+    // each strategy's decisions as a 0/1 byte per day, from one virtual fill (SIMD for SMA and MACD)
+    // decisions needing a day's close move to the next day when trades fill at the open
+    std::vector<std::vector<std::uint8_t>> decisions(count, std::vector<std::uint8_t>(size));
+
+    for (int k = 0; k < count; k++) {
+        const Strategy& s = *entries[k].strategy;
+
+        if (open_price && s.needs_day_close()) s.fill(first - 1, size - 1, decisions[k].data() + 1);
+        else s.fill(first, size, decisions[k].data());
+
+        report.strategies.push_back(run(entries[k].name, StateSignal {decisions[k].data()}));
     }
-}
 
-// simulating a trading strategy
-void Simulator::backtest_strategy(bool is_sma, int stocks) const {
-    int transactions {};
-    double profit {};
-    double percent {};
-    bool bought {false};
-    double buy_price {};
-    double sell_price {};
-    double initial_buy {};
-    bool is_initial_buy {false};
-    bool decision {};
-
-    for (int i = start_day; i < size; i++) {
-        decision = (is_sma) ? sma->indicator(i) : macd->indicator(i);
-
-        // detect buy move
-        if (decision && !bought) {
-            transactions++;
-            buy_price = price.at(i);
-            bought = true;
-
-            if (!is_initial_buy) {
-                is_initial_buy = true;
-                initial_buy = buy_price;
-            }
+    // SMA and MACD on their own combine at compile time (compose.h) from their unchecked signals; any
+    // other set of strategies folds its decisions day by day, in the same pass as the weighted vote
+    const SMA* sma {(count == 2) ? dynamic_cast<const SMA*>(entries[0].strategy.get()) : nullptr};
+    const MACD* macd {(count == 2) ? dynamic_cast<const MACD*>(entries[1].strategy.get()) : nullptr};
+    bool compiled {sma && macd};
+    bool folded {(combination && !compiled) || vote_backtest};
+    std::vector<std::uint8_t> combined((combination && !compiled) ? size : 0);
+    std::vector<std::uint8_t> voted((vote_backtest) ? size : 0);
+    bool holding {false};
+
+    for (int d = first; d < size && folded; d++) {
+        int buys {0};
+        double score {0};
+
+        for (int k = 0; k < count; k++) {
+            bool buy = decisions[k][d];
+
+            buys += buy;
+            score += (buy) ? entries[k].weight : -entries[k].weight;
         }
 
-        // detect sell move
-        if ((!decision && bought) || ((i == size - 1) && bought)) {
-            transactions++;
-            sell_price = price.at(i);
-            profit += (sell_price - buy_price) * stocks;
-            bought = false;
+        if (!combined.empty()) {
+            if (combination == Combine::all) combined[d] = (buys == count);
+            else if (combination == Combine::any) combined[d] = (buys > 0);
+            else combined[d] = (2 * buys > count);
         }
-    }
 
-    percent = ((profit / stocks) / initial_buy) * 100;
+        if (!voted.empty()) {
+            score /= total_weight;
 
-    std::cout << " Strategy: " << ((is_sma) ? "SMA" : "MACD") << "\n"
-              << " No. of transactions: " << transactions << "\n";
+            if (score > vote.buy) holding = true;
+            else if (score < vote.sell) holding = false;
 
-    print_profit(profit, percent);
+            voted[d] = holding;
+        }
+    }
 
-    break_line();
-}
+    if (combination) {
+        std::string name {entries[0].name};
 
-// simulating buy and hold strategy
-void Simulator::backtest_bnh(int stocks) const {
-    double buy_price {price.at(0)};
-    double sell_price {price.at(price.size() - 1)};
-    double profit {(sell_price - buy_price) * stocks};
-    double percent {((profit / stocks) / buy_price) * 100};
+        for (int k = 1; k < count; k++) name += std::string(" ") + combine_name(*combination) + " " + entries[k].name;
 
-    std::cout << " Strategy: Buy and hold" << "\n"
-              << " Starting buy price: " << buy_price << "\n"
-              << " Final sell price: " << sell_price << "\n";
+        auto combined_run = [&](auto signal) { return run(name, signal); };
 
-    print_profit(profit, percent);
-}
+        // MACD reads the day's close, so with open fills it acts a day later
+        if (compiled && open_price) {
+            report.strategies.push_back(with_combination(*combination, combined_run, sma->signal(), lagged(macd->signal())));
+        } else if (compiled) {
+            report.strategies.push_back(with_combination(*combination, combined_run, sma->signal(), macd->signal()));
+        } else {
+            report.strategies.push_back(run(name, StateSignal {combined.data()}));
+        }
+    }
 
-// simulating historical backtest and compare to buy and hold
-void Simulator::backtest(int stocks) const {
-    if (stocks <= 0) throw std::invalid_argument("Error: Invalid number of stocks");
-    
-    if (!sma && !macd) return;
+    if (vote_backtest) report.strategies.push_back(run("Vote", StateSignal {voted.data()}));
 
-    std::cout << " [ Backtest Results ]" << "\n\n";
+    report.buy_and_hold = backtest_buy_and_hold(fill, stocks, execution);
 
-    if (sma) backtest_strategy(true, stocks);
+    if (with_metrics) report.buy_and_hold_metrics = buy_and_hold_metrics(fill, stocks, execution, arena);
 
-    if (macd) backtest_strategy(false, stocks);
+    return report;
+}
 
-    backtest_bnh(stocks);
+// give live-data indicator for buy/sell
+void Simulator::indicator() const {
+    write_indicator_text(indicator_report(), std::cout);
 }
 
+// simulating historical backtest and compare to buy and hold
+void Simulator::backtest(int stocks) const {
+    write_backtest_text(backtest_report(stocks), std::cout);
+}
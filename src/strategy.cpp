@@ -1,11 +1,25 @@
 #include "../include/strategy.h"
+#include <cstdint>
 #include <vector>
 #include <stdexcept>
 
 
-Strategy::Strategy(const std::vector<double> &p, int s, int l) 
-    : price(p), short_term(s), long_term(l), size(p.size()) {
+Strategy::Strategy(PriceView p, int s, int l)
+    : Strategy(close_only(p), s, l) {}
+
+Strategy::Strategy(const BarsView& b, int s, int l)
+    : bars(b), price(b.close), short_term(s), long_term(l), size(b.size()) {
     if (l <= 0 || s <= 0) throw std::invalid_argument("Long-term and short-term periods must be positive");
     if (l <= s) throw std::invalid_argument("Long-term period must be larger than short-term period");
     if (l > size) throw std::invalid_argument("Long-term period cannot be larger than data size");
 }
+
+Strategy::Strategy(const BarsView& b, int period)
+    : bars(b), price(b.close), short_term(period), long_term(period), size(b.size()) {
+    if (period <= 0) throw std::invalid_argument("Indicator period must be positive");
+    if (period > size) throw std::invalid_argument("Indicator period cannot be larger than data size");
+}
+
+void Strategy::fill(int begin, int end, std::uint8_t* out) const {
+    for (int day = begin; day < end; day++) out[day] = indicator(day);
+}
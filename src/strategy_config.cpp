@@ -0,0 +1,329 @@
+#include "../include/strategy_config.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include "../include/RSI.h"
+#include "../include/Bollinger.h"
+#include "../include/EMACross.h"
+#include "../include/ATR.h"
+#include "../include/HigherTimeframe.h"
+#include "../include/resample.h"
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <initializer_list>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+bool is_strategy_kind(std::string_view kind) {
+    return kind == "sma" || kind == "macd" || kind == "rsi" || kind == "bollinger" || kind == "ema" || kind == "atr";
+}
+
+static double to_number(const std::string& key, const std::string& value) {
+    std::size_t used {0};
+    double x {0};
+
+    try {
+        x = std::stod(value, &used);
+    }
+    catch (const std::exception& e) {
+        used = 0;
+    }
+
+    if (used == 0 || used != value.size()) throw std::invalid_argument("'" + key + "=" + value + "' is not a valid number");
+
+    return x;
+}
+
+static int to_int(const std::string& key, const std::string& value) {
+    double x {to_number(key, value)};
+
+    if (!(x >= INT_MIN && x <= INT_MAX) || x != std::floor(x)) throw std::invalid_argument("'" + key + "=" + value + "' is not a valid integer");
+
+    return static_cast<int>(x);
+}
+
+
+SimulationConfig parse_config(std::istream& in) {
+    SimulationConfig config;
+    std::string line;
+    int number {0};
+    bool voted {false};
+
+    while (std::getline(in, line)) {
+        number++;
+
+        std::size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        std::istringstream words(line);
+        std::string kind;
+
+        if (!(words >> kind)) continue;
+
+        try {
+            std::vector<std::pair<std::string, std::string>> pairs;
+            std::string word;
+
+            while (words >> word) {
+                std::size_t equals = word.find('=');
+
+                if (equals == std::string::npos || equals == 0 || equals + 1 == word.size()) {
+                    throw std::invalid_argument("expected key=value, got '" + word + "'");
+                }
+
+                pairs.emplace_back(word.substr(0, equals), word.substr(equals + 1));
+            }
+
+            if (kind == "vote") {
+                if (voted) throw std::invalid_argument("only one vote line is allowed");
+
+                voted = true;
+
+                for (const auto& [key, value] : pairs) {
+                    if (key == "buy") config.vote.buy = to_number(key, value);
+                    else if (key == "sell") config.vote.sell = to_number(key, value);
+                    else throw std::invalid_argument("unknown vote parameter '" + key + "' (expected buy or sell)");
+                }
+
+                check_vote_rule(config.vote);
+                continue;
+            }
+
+            if (!is_strategy_kind(kind)) {
+                throw std::invalid_argument("unknown strategy '" + kind + "' (expected sma, macd, rsi, bollinger, ema or atr)");
+            }
+
+            StrategySpec spec;
+            spec.kind = kind;
+            spec.line = number;
+
+            for (const auto& [key, value] : pairs) {
+                if (key == "weight") spec.weight = to_number(key, value);
+                else if (key == "name") spec.name = value;
+                else spec.params.emplace_back(key, value);
+            }
+
+            if (!(spec.weight > 0)) throw std::invalid_argument("weight must be positive");
+
+            config.strategies.push_back(spec);
+        }
+        catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("line " + std::to_string(number) + ": " + e.what());
+        }
+    }
+
+    if (config.strategies.empty()) throw std::invalid_argument("the config has no strategies");
+
+    return config;
+}
+
+SimulationConfig load_config(const std::string& path) {
+    std::ifstream file(path);
+
+    if (!file.is_open()) throw std::runtime_error("Failed to open file: '" + path + "'");
+
+    return parse_config(file);
+}
+
+
+// parameter lookup for one spec: every parameter must be read, so misspelled keys are reported
+class Params {
+private:
+    const StrategySpec& spec;
+    std::vector<bool> used;
+
+    const std::string* find(const std::string& key) {
+        for (std::size_t i = 0; i < spec.params.size(); i++) {
+            if (spec.params[i].first == key) {
+                used[i] = true;
+                return &spec.params[i].second;
+            }
+        }
+
+        return nullptr;
+    }
+
+public:
+    explicit Params(const StrategySpec& s) : spec(s), used(s.params.size()) {}
+
+    int integer(const std::string& key, int fallback) {
+        const std::string* value = find(key);
+        return (value) ? to_int(key, *value) : fallback;
+    }
+
+    double number(const std::string& key, double fallback) {
+        const std::string* value = find(key);
+        return (value) ? to_number(key, *value) : fallback;
+    }
+
+    std::string text(const std::string& key, const std::string& fallback) {
+        const std::string* value = find(key);
+        return (value) ? *value : fallback;
+    }
+
+    void check_all_used() const {
+        for (std::size_t i = 0; i < used.size(); i++) {
+            if (!used[i]) throw std::invalid_argument("unknown parameter '" + spec.params[i].first + "' for " + spec.kind);
+        }
+    }
+};
+
+// " 10/40": the parameters a strategy runs with, defaults included
+static std::string parameter_text(std::initializer_list<double> values) {
+    std::ostringstream out;
+    char separator {' '};
+
+    for (double x : values) {
+        out << separator << x;
+        separator = '/';
+    }
+
+    return out.str();
+}
+
+// with `qualified` the default name carries the parameters, i.e. "SMA 10/40"
+static StrategyEntry build_strategy(const StrategySpec& spec, SeriesCache& daily, bool qualified) {
+    Params p(spec);
+    StrategyEntry entry;
+    std::string params;
+    std::string frame {p.text("timeframe", "")};
+    std::optional<Timeframe> tf;
+
+    // a strategy on a coarser timeframe is built on its shared resampled cache, then asked day by day
+    if (!frame.empty()) tf = parse_timeframe(frame);
+
+    SeriesCache& cache = (tf) ? daily.timeframe(*tf).cache : daily;
+
+    if (spec.kind == "sma") {
+        int s {p.integer("short", 50)};
+        int l {p.integer("long", 200)};
+
+        p.check_all_used();
+        entry = {"SMA", std::make_shared<SMA>(cache, s, l), spec.weight};
+        params = parameter_text({double(s), double(l)});
+    } else if (spec.kind == "macd") {
+        int s {p.integer("short", 12)};
+        int l {p.integer("long", 26)};
+        int sig {p.integer("signal", 9)};
+        std::string cross {p.text("cross", "zero")};
+
+        p.check_all_used();
+
+        if (cross != "zero" && cross != "signal") throw std::invalid_argument("MACD cross must be zero or signal");
+
+        MACD::Crossover mode {(cross == "signal") ? MACD::Crossover::signal_line : MACD::Crossover::zero_line};
+        entry = {"MACD", std::make_shared<MACD>(cache, s, l, sig, mode), spec.weight};
+        params = parameter_text({double(s), double(l), double(sig)});
+
+        if (mode == MACD::Crossover::signal_line) params += " signal";
+    } else if (spec.kind == "rsi") {
+        int period {p.integer("period", 14)};
+        double low {p.number("oversold", 30)};
+        double high {p.number("overbought", 70)};
+
+        p.check_all_used();
+        entry = {"RSI", std::make_shared<RSI>(cache, period, low, high), spec.weight};
+        params = parameter_text({double(period), low, high});
+    } else if (spec.kind == "bollinger") {
+        int period {p.integer("period", 20)};
+        double width {p.number("width", 2)};
+
+        p.check_all_used();
+        entry = {"Bollinger", std::make_shared<Bollinger>(cache, period, width), spec.weight};
+        params = parameter_text({double(period), width});
+    } else if (spec.kind == "ema") {
+        int s {p.integer("short", 12)};
+        int l {p.integer("long", 26)};
+
+        p.check_all_used();
+        entry = {"EMA cross", std::make_shared<EMACross>(cache, s, l), spec.weight};
+        params = parameter_text({double(s), double(l)});
+    } else if (spec.kind == "atr") {
+        int period {p.integer("period", 14)};
+        double multiple {p.number("multiple", 3)};
+        int breakout {p.integer("breakout", 20)};
+
+        p.check_all_used();
+        entry = {"ATR", std::make_shared<ATR>(cache, period, multiple, breakout), spec.weight};
+        params = parameter_text({double(period), multiple, double(breakout)});
+    } else {
+        throw std::invalid_argument("Unknown strategy '" + spec.kind + "'");
+    }
+
+    if (qualified) entry.name += params;
+
+    if (tf) {
+        std::string label {timeframe_name(*tf)};
+
+        label[0] = std::toupper(static_cast<unsigned char>(label[0]));
+        entry.strategy = std::make_shared<HigherTimeframe>(daily, *tf, entry.strategy);
+        entry.name = label + " " + entry.name;
+    }
+
+    if (!spec.name.empty()) entry.name = spec.name;
+
+    return entry;
+}
+
+static StrategyEntry make_strategy(const StrategySpec& spec, SeriesCache& cache, bool qualified) {
+    if (spec.line == 0) return build_strategy(spec, cache, qualified);
+
+    try {
+        return build_strategy(spec, cache, qualified);
+    }
+    catch (const std::invalid_argument& e) {
+        throw std::invalid_argument("line " + std::to_string(spec.line) + ": " + e.what());
+    }
+}
+
+StrategyEntry make_strategy(const StrategySpec& spec, SeriesCache& cache) {
+    return make_strategy(spec, cache, false);
+}
+
+std::vector<StrategyEntry> make_strategies(const SimulationConfig& config, SeriesCache& cache) {
+    const std::vector<StrategySpec>& specs {config.strategies};
+    std::vector<StrategyEntry> entries;
+
+    // the same kind on the same timeframe twice, both unnamed: tell them apart by their parameters
+    auto frame = [](const StrategySpec& spec) {
+        for (const auto& [key, value] : spec.params) {
+            if (key == "timeframe") return value;
+        }
+
+        return std::string {};
+    };
+
+    for (std::size_t i = 0; i < specs.size(); i++) {
+        bool qualified {false};
+
+        for (std::size_t j = 0; j < specs.size() && specs[i].name.empty(); j++) {
+            qualified = qualified || (j != i && specs[j].name.empty() && specs[j].kind == specs[i].kind
+                                      && frame(specs[j]) == frame(specs[i]));
+        }
+
+        entries.push_back(make_strategy(specs[i], cache, qualified));
+
+        // reports, CSV rows and combinations name strategies, so a name can only be used once
+        for (std::size_t j = 0; j < i; j++) {
+            if (entries[j].name != entries[i].name) continue;
+
+            std::string where {(specs[i].line > 0) ? "line " + std::to_string(specs[i].line) + ": " : ""};
+            std::string first {(specs[j].line > 0) ? " on line " + std::to_string(specs[j].line) : ""};
+
+            throw std::invalid_argument(where + "strategy name '" + entries[i].name + "' is already used" + first
+                                        + " (set a different name=)");
+        }
+    }
+
+    return entries;
+}
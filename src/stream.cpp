@@ -0,0 +1,205 @@
+#include "../include/stream.h"
+#include "../include/util.h"
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+
+StreamingSMA::StreamingSMA(int s, int l, bool compensated)
+    : short_window(s, compensated), long_window(l, compensated)
+{
+    if (l <= s) throw std::invalid_argument("Long-term period must be larger than short-term period");
+}
+
+void StreamingSMA::push(double price) {
+    short_window.push(price);
+    long_window.push(price);
+}
+
+bool StreamingSMA::signal() const {
+    return short_window.mean() > long_window.mean();
+}
+
+void StreamingSMA::set_state(const RollingWindow::State& s, const RollingWindow::State& l) {
+    short_window.set_state(s);
+    long_window.set_state(l);
+}
+
+
+StreamingMACD::StreamingMACD(int s, int l, int sig, MACD::Crossover m)
+    : short_term(s), long_term(l), signal_term(sig), mode(m),
+      short_k(2.0 / (s + 1)), long_k(2.0 / (l + 1)), signal_k(2.0 / (sig + 1))
+{
+    if (l <= 0 || s <= 0 || sig <= 0) throw std::invalid_argument("MACD periods must be positive");
+    if (l <= s) throw std::invalid_argument("Long-term period must be larger than short-term period");
+}
+
+// each EMA accumulates its seed sum until its period is reached, then switches to the recursion
+// (same operations in the same order as the batch MACD, so both agree exactly)
+void StreamingMACD::push(double price) {
+    count++;
+
+    if (count < short_term) short_ema += price;
+    else if (count == short_term) short_ema = (short_ema + price) / short_term;
+    else short_ema = (price * short_k) + (short_ema * (1 - short_k));
+
+    if (count < long_term) long_ema += price;
+    else if (count == long_term) long_ema = (long_ema + price) / long_term;
+    else long_ema = (price * long_k) + (long_ema * (1 - long_k));
+
+    if (count < long_term) return;
+
+    macd = short_ema - long_ema;
+    macd_count++;
+
+    if (macd_count < signal_term) signal_ema += macd;
+    else if (macd_count == signal_term) signal_ema = (signal_ema + macd) / signal_term;
+    else signal_ema = (macd * signal_k) + (signal_ema * (1 - signal_k));
+}
+
+bool StreamingMACD::ready() const {
+    // MACD::indicator needs day >= long_term, i.e. long_term + 1 prices
+    if (count <= long_term) return false;
+
+    return mode == MACD::Crossover::zero_line || macd_count >= signal_term;
+}
+
+void StreamingMACD::set_state(const State& state) {
+    if (state.count < 0 || state.macd_count < 0) throw std::invalid_argument("MACD state counts cannot be negative");
+
+    count = state.count;
+    short_ema = state.short_ema;
+    long_ema = state.long_ema;
+    macd = state.macd;
+    signal_ema = state.signal_ema;
+    macd_count = state.macd_count;
+}
+
+bool StreamingMACD::signal() const {
+    if (mode == MACD::Crossover::signal_line) return (macd - signal_ema) > 0;
+
+    return macd > 0;
+}
+
+
+// read the next complete line; in follow mode wait for more data instead of stopping at EOF
+static bool next_line(std::istream& in, std::string& line, const StreamOptions& options) {
+    std::string partial;
+
+    while (true) {
+        std::string chunk;
+
+        if (std::getline(in, chunk)) {
+            if (in.eof() && options.follow) {
+                // line not terminated yet: keep it and wait for the rest
+                partial += chunk;
+                in.clear();
+                std::this_thread::sleep_for(std::chrono::milliseconds(options.poll_ms));
+                continue;
+            }
+
+            line = partial + chunk;
+            return true;
+        }
+
+        if (!options.follow) {
+            if (partial.empty()) return false;
+
+            line = partial;
+            return true;
+        }
+
+        in.clear();
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.poll_ms));
+    }
+}
+
+static void report(std::ostream& out, std::int64_t tick, double price, const char* strategy,
+                   int s, int l, bool signal, double latency_ns) {
+    out << " [tick " << tick << "] " << strategy << " (" << s << "/" << l << "): "
+        << ((signal) ? "\033[32mBUY\033[0m" : "\033[31mSELL\033[0m")
+        << " at " << price << " (" << latency_ns / 1000 << " us)" << std::endl;
+}
+
+StreamSummary run_stream(std::istream& in, std::ostream& out, std::ostream& err, const StreamOptions& options) {
+    StreamSummary summary;
+    std::optional<StreamingSMA> sma;
+    std::optional<StreamingMACD> macd;
+    std::optional<bool> sma_last;
+    std::optional<bool> macd_last;
+
+    if (options.sma_on) sma.emplace();
+    if (options.macd_on) macd.emplace(12, 26, options.signal_period, options.macd_cross);
+
+    std::string line;
+
+    while (next_line(in, line, options)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.find_first_not_of(" \t") == std::string::npos) continue;
+
+        double price {};
+
+        if (!parse_price(line, price)) {
+            summary.rejected++;
+            err << "Warning: skipping invalid price '" << line << "'\n";
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        // the timed section is the whole per-tick update: both indicators and the transition checks
+        bool sma_flip {false};
+        bool macd_flip {false};
+
+        if (sma) {
+            sma->push(price);
+
+            if (sma->ready() && sma_last != sma->signal()) {
+                sma_last = sma->signal();
+                sma_flip = true;
+            }
+        }
+
+        if (macd) {
+            macd->push(price);
+
+            if (macd->ready() && macd_last != macd->signal()) {
+                macd_last = macd->signal();
+                macd_flip = true;
+            }
+        }
+
+        double latency_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        summary.ticks++;
+        summary.latency.record(latency_ns);
+
+        if (sma_flip) {
+            summary.transitions++;
+            report(out, summary.ticks, price, "SMA", sma->get_short_term(), sma->get_long_term(), *sma_last, latency_ns);
+        }
+
+        if (macd_flip) {
+            summary.transitions++;
+            report(out, summary.ticks, price, "MACD", macd->get_short_term(), macd->get_long_term(), *macd_last, latency_ns);
+        }
+    }
+
+    return summary;
+}
+
+void print_stream_summary(const StreamSummary& summary, std::ostream& out) {
+    out << "\n [ Stream Summary ]" << "\n\n"
+        << " Ticks processed: " << summary.ticks << "\n"
+        << " Invalid lines skipped: " << summary.rejected << "\n"
+        << " Signal changes: " << summary.transitions << "\n"
+        << " Update latency (us): mean " << summary.latency.mean_us()
+        << ", p50 " << summary.latency.percentile_us(0.50)
+        << ", p99 " << summary.latency.percentile_us(0.99)
+        << ", max " << summary.latency.max_us() << "\n";
+}
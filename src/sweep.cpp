@@ -0,0 +1,201 @@
+#include "../include/sweep.h"
+#include "../include/profile.h"
+#include "../include/rolling.h"
+#include "../include/ema.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+static int parse_period(std::string_view text) {
+    int value {};
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if (ec != std::errc() || end != text.data() + text.size()) {
+        throw std::invalid_argument("'" + std::string(text) + "' is not a valid period");
+    }
+
+    return value;
+}
+
+// parse "from:to" or "from:to:step"
+SweepRange parse_range(std::string_view text) {
+    SweepRange range;
+    std::size_t first = text.find(':');
+
+    if (first == std::string_view::npos) throw std::invalid_argument("range must be in format 'from:to[:step]'");
+
+    std::size_t second = text.find(':', first + 1);
+
+    range.from = parse_period(text.substr(0, first));
+
+    if (second == std::string_view::npos) {
+        range.to = parse_period(text.substr(first + 1));
+    } else {
+        range.to = parse_period(text.substr(first + 1, second - first - 1));
+        range.step = parse_period(text.substr(second + 1));
+    }
+
+    if (range.from <= 0 || range.step <= 0) throw std::invalid_argument("range periods and step must be positive");
+    if (range.from > range.to) throw std::invalid_argument("range start cannot exceed range end");
+
+    return range;
+}
+
+static std::vector<int> expand(SweepRange range, int max_period) {
+    std::vector<int> periods;
+
+    for (int p = range.from; p <= range.to && p <= max_period; p += range.step) periods.push_back(p);
+
+    return periods;
+}
+
+SweepGrid::SweepGrid(PriceView price, SweepRange short_range, SweepRange long_range,
+                     bool sma_on, bool macd_on, ThreadPool& pool) : size(price.size()) {
+    PROFILE_SCOPE("sweep grid");
+
+    std::vector<int> short_periods {expand(short_range, size)};
+    std::vector<int> long_periods {expand(long_range, size)};
+
+    // every period used by either range, mapped to a slot in the shared series tables
+    std::vector<int> periods {short_periods};
+    periods.insert(periods.end(), long_periods.begin(), long_periods.end());
+    std::sort(periods.begin(), periods.end());
+    periods.erase(std::unique(periods.begin(), periods.end()), periods.end());
+
+    slot.assign(size + 1, -1);
+    for (int i = 0; i < static_cast<int>(periods.size()); i++) slot[periods[i]] = i;
+
+    // precompute each moving-average series once
+    int count = periods.size();
+
+    if (sma_on) {
+        averages.resize(count);
+        parallel_for(pool, 0, count, [&](int i) { averages[i] = rolling_mean(price, periods[i]); });
+    }
+
+    // every EMA span in one SIMD pass over the prices (row i belongs to periods[i])
+    if (macd_on) emas = batch_ema(price, periods);
+
+    for (int s : short_periods) {
+        for (int l : long_periods) {
+            if (s >= l) continue;
+
+            if (sma_on) configs.push_back({"SMA", s, l, {}, {}});
+            if (macd_on) configs.push_back({"MACD", s, l, {}, {}});
+        }
+    }
+}
+
+void SweepGrid::fill(const SweepResult& config, int begin, int end, std::uint8_t* out) const {
+    if (config.strategy == "SMA") {
+        const std::vector<double>& short_avg = averages[slot[config.short_term]];
+        const std::vector<double>& long_avg = averages[slot[config.long_term]];
+
+        greater_mask(short_avg.data(), long_avg.data(), begin, end, out);
+    } else {
+        const double* short_ema = emas.data() + static_cast<std::size_t>(slot[config.short_term]) * size;
+        const double* long_ema = emas.data() + static_cast<std::size_t>(slot[config.long_term]) * size;
+
+        // short - long > 0 exactly when short > long for finite values
+        greater_mask(short_ema, long_ema, begin, end, out);
+    }
+}
+
+std::vector<SweepResult> sweep(PriceView price, SweepRange short_range, SweepRange long_range,
+                               int stocks, bool sma_on, bool macd_on, ThreadPool& pool,
+                               const ExecutionModel& execution, bool metrics) {
+    if (stocks <= 0) throw std::invalid_argument("Error: Invalid number of stocks");
+
+    PROFILE_SCOPE("sweep");
+
+    int size = price.size();
+    SweepGrid grid(price, short_range, long_range, sma_on, macd_on, pool);
+    std::vector<SweepResult> results {grid.configurations()};
+
+    // one task per configuration; the pool balances short and long runs by stealing
+    // each task backtests in two phases (SIMD signal mask, then transitions only)
+    parallel_for(pool, 0, results.size(), [&](int i) {
+        // scratch of the worker thread, reused by every configuration it runs
+        thread_local MetricsArena arena;
+        SweepResult& r = results[i];
+
+        arena.mask.resize(size);
+        grid.fill(r, r.long_term, size, arena.mask.data());
+        r.result = backtest_mask(price, r.long_term, stocks, arena.mask.data(), execution);
+
+        if (metrics) r.metrics = compute_metrics(price, r.long_term, stocks, arena.mask.data(), execution, arena);
+    });
+
+    std::stable_sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+        return a.result.profit > b.result.profit;
+    });
+
+    return results;
+}
+
+// "12.53%" (4 significant digits) as one field for setw
+static std::string percent_text(double value) {
+    std::ostringstream out;
+
+    out << std::setprecision(4) << value << "%";
+
+    return out.str();
+}
+
+void print_sweep(const std::vector<SweepResult>& results, int top) {
+    int shown = std::min<int>(top, results.size());
+    bool metrics = !results.empty() && results[0].metrics;
+
+    std::cout << " [ Parameter Sweep ]" << "\n\n"
+              << " Configurations tested: " << results.size() << "\n\n"
+              << std::left
+              << " " << std::setw(6) << "Rank"
+              << std::setw(10) << "Strategy"
+              << std::setw(8) << "Short"
+              << std::setw(8) << "Long"
+              << std::setw(8) << "Trades"
+              << std::setw(16) << "Profit";
+
+    if (metrics) {
+        std::cout << std::setw(12) << "Percent"
+                  << std::setw(10) << "Win rate"
+                  << std::setw(10) << "Max DD"
+                  << "Sharpe";
+    } else {
+        std::cout << "Percent";
+    }
+
+    std::cout << "\n";
+
+    for (int i = 0; i < shown; i++) {
+        const SweepResult& r = results[i];
+        double percent = (std::isnan(r.result.percent)) ? 0 : r.result.percent;
+
+        std::cout << " " << std::setw(6) << i + 1
+                  << std::setw(10) << r.strategy
+                  << std::setw(8) << r.short_term
+                  << std::setw(8) << r.long_term
+                  << std::setw(8) << r.result.transactions
+                  << std::setw(16) << r.result.profit;
+
+        if (metrics) {
+            std::cout << std::setw(12) << percent_text(percent)
+                      << std::setw(10) << percent_text(r.metrics->win_rate)
+                      << std::setw(10) << percent_text(r.metrics->max_drawdown)
+                      << r.metrics->sharpe << "\n";
+        } else {
+            std::cout << percent << "%\n";
+        }
+    }
+
+    std::cout << std::right;
+}
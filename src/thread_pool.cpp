@@ -0,0 +1,176 @@
+#include "../include/thread_pool.h"
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+
+// index of the pool worker running on this thread (-1 for outside threads)
+static thread_local int worker_index {-1};
+static thread_local const ThreadPool* worker_pool {nullptr};
+
+
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0) threads = std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+
+    for (int i = 0; i < threads; i++) queues.push_back(std::make_unique<WorkQueue>());
+    for (int i = 0; i < threads; i++) workers.emplace_back(&ThreadPool::run, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for (std::thread& worker : workers) worker.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // tasks spawned by a worker stay local, outside submissions are spread round-robin
+    int index = (worker_pool == this) ? worker_index : next_queue++ % queues.size();
+
+    pending++;
+
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        queued++;
+    }
+
+    wake.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(state_mutex);
+    idle.wait(lock, [this]() { return pending == 0; });
+
+    if (error) {
+        std::exception_ptr e {error};
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+bool ThreadPool::try_pop(int index, std::function<void()>& task) {
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+
+    if (queues[index]->tasks.empty()) return false;
+
+    task = std::move(queues[index]->tasks.back());
+    queues[index]->tasks.pop_back();
+
+    return true;
+}
+
+bool ThreadPool::try_steal(int index, std::function<void()>& task) {
+    int count = queues.size();
+
+    for (int offset = 1; offset < count; offset++) {
+        WorkQueue& victim = *queues[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (victim.tasks.empty()) continue;
+
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::finish_task() {
+    if (--pending == 0) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        idle.notify_all();
+    }
+}
+
+// run a popped task, keeping the first failure for wait()
+void ThreadPool::execute(std::function<void()>& task) {
+    queued--;
+
+    try {
+        task();
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (!error) error = std::current_exception();
+    }
+
+    task = nullptr;
+    finish_task();
+}
+
+bool ThreadPool::on_worker() const {
+    return worker_pool == this;
+}
+
+bool ThreadPool::run_pending() {
+    if (!on_worker()) return false;
+
+    std::function<void()> task;
+
+    if (!try_pop(worker_index, task) && !try_steal(worker_index, task)) return false;
+
+    execute(task);
+
+    return true;
+}
+
+void ThreadPool::run(int index) {
+    worker_index = index;
+    worker_pool = this;
+
+    std::function<void()> task;
+
+    while (true) {
+        if (try_pop(index, task) || try_steal(index, task)) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(state_mutex);
+        wake.wait(lock, [this]() { return stopping || queued > 0; });
+
+        if (stopping && queued == 0) return;
+    }
+}
+
+
+void TaskLatch::count_down(std::exception_ptr failure) {
+    // notified under the lock: the waiter may destroy the latch as soon as it is released
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (failure && !error) error = failure;
+    if (--left == 0) done.notify_all();
+}
+
+void TaskLatch::wait(ThreadPool& pool) {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // a worker keeps running queued tasks (those of the batch among them) until the rest are running
+    // elsewhere; then, like an outside thread, it sleeps until the batch is done
+    while (left > 0 && pool.on_worker()) {
+        lock.unlock();
+        bool helped {pool.run_pending()};
+        lock.lock();
+
+        if (!helped) done.wait_for(lock, std::chrono::milliseconds(1), [this]() { return left == 0; });
+    }
+
+    done.wait(lock, [this]() { return left == 0; });
+
+    if (error) std::rethrow_exception(error);
+}
@@ -1,40 +1,257 @@
 #include "../include/util.h"
-#include <exception>
+#include "../include/mapped_file.h"
+#include "../include/profile.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
 #include <string_view>
 #include <sstream>
 #include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
-#include <fstream>
 #include <stdexcept>
 #include <iostream>
 
 
-// read .csv file
-std::vector<double> read_file(std::string_view file_name) {
-    // open file
-    std::ifstream file(file_name.data());
+// index of the named column in a CSV header row, -1 if the header has no such column
+static int header_column(std::string_view header, std::string_view name) {
+    int column {0};
+
+    while (true) {
+        std::size_t comma = header.find(',');
+        std::string_view field = header.substr(0, comma);
+
+        if (field == name) return column;
+        if (comma == std::string_view::npos) return -1;
+
+        header.remove_prefix(comma + 1);
+        column++;
+    }
+}
+
+// n-th comma-separated field of a CSV row (empty if the row is too short)
+static std::string_view csv_field(std::string_view line, int column) {
+    for (int i = 0; i < column; i++) {
+        std::size_t comma = line.find(',');
 
-    // check if file opened correctly
-    if (!file.is_open()) {
-        std::ostringstream oss;
-        oss << "Failed to open file: '" << file_name << "'";
+        if (comma == std::string_view::npos) return {};
 
-        throw std::runtime_error(oss.str());
+        line.remove_prefix(comma + 1);
     }
 
-    std::string line;
-    std::vector<double> closingPrices;
+    return line.substr(0, line.find(','));
+}
+
+// parse a whole field as a double, allowing surrounding blanks and a leading '+'
+bool parse_price(std::string_view field, double& value) {
+    while (!field.empty() && (field.front() == ' ' || field.front() == '\t')) field.remove_prefix(1);
+    while (!field.empty() && (field.back() == ' ' || field.back() == '\t')) field.remove_suffix(1);
+
+    if (!field.empty() && field.front() == '+') field.remove_prefix(1);
+
+    const char* end = field.data() + field.size();
+    auto [parsed, ec] = std::from_chars(field.data(), end, value);
+
+    return !field.empty() && ec == std::errc() && parsed == end;
+}
+
+
+// parse exactly `digits` decimal digits from the front of text
+static bool take_number(std::string_view& text, int digits, int& value) {
+    if (static_cast<int>(text.size()) < digits) return false;
+
+    auto [end, ec] = std::from_chars(text.data(), text.data() + digits, value);
+
+    if (ec != std::errc() || end != text.data() + digits) return false;
+
+    text.remove_prefix(digits);
+
+    return true;
+}
+
+// days since 1970-01-01 of a proleptic Gregorian date
+static std::int64_t days_from_civil(int y, int m, int d) {
+    y -= m <= 2;
+    std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 719468;
+}
+
+bool parse_timestamp(std::string_view text, std::int64_t& seconds) {
+    int year {}, month {}, day {}, hour {}, minute {}, second {};
+
+    if (!take_number(text, 4, year) || text.empty() || text.front() != '-') return false;
+    text.remove_prefix(1);
+    if (!take_number(text, 2, month) || text.empty() || text.front() != '-') return false;
+    text.remove_prefix(1);
+    if (!take_number(text, 2, day)) return false;
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+
+    int offset {0};
+
+    if (!text.empty()) {
+        if (text.front() != ' ' && text.front() != 'T') return false;
+        text.remove_prefix(1);
+
+        if (!take_number(text, 2, hour) || text.empty() || text.front() != ':') return false;
+        text.remove_prefix(1);
+        if (!take_number(text, 2, minute) || text.empty() || text.front() != ':') return false;
+        text.remove_prefix(1);
+        if (!take_number(text, 2, second)) return false;
+
+        // optional UTC offset: Z, +HH:MM or -HH:MM
+        if (!text.empty() && text.front() == 'Z') {
+            text.remove_prefix(1);
+        } else if (!text.empty() && (text.front() == '+' || text.front() == '-')) {
+            int sign = (text.front() == '-') ? -1 : 1;
+            int offset_hours {}, offset_minutes {};
+
+            text.remove_prefix(1);
+            if (!take_number(text, 2, offset_hours) || text.empty() || text.front() != ':') return false;
+            text.remove_prefix(1);
+            if (!take_number(text, 2, offset_minutes)) return false;
+
+            offset = sign * (offset_hours * 3600 + offset_minutes * 60);
+        }
+
+        if (!text.empty()) return false;
+    }
+
+    seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+
+    return true;
+}
+
+
+// OHLCV + Date columns a loader call wants, in BarData order
+constexpr unsigned WANT_OPEN {1u << 0};
+constexpr unsigned WANT_HIGH {1u << 1};
+constexpr unsigned WANT_LOW {1u << 2};
+constexpr unsigned WANT_CLOSE {1u << 3};
+constexpr unsigned WANT_VOLUME {1u << 4};
+constexpr unsigned WANT_TIME {1u << 5};
+constexpr unsigned WANT_ALL {(1u << 6) - 1};
+
+
+// shared CSV loader: the wanted columns the file has are parsed, the others stay empty
+// the file is memory-mapped and parsed in place with std::from_chars (no per-line string copies)
+static BarData read_csv(std::string_view file_name, unsigned wanted) {
+    PROFILE_SCOPE("parse csv");
+
+    MappedFile file(file_name);
+    std::string_view text {file.view()};
+
+    PROFILE_COUNT(Counter::bytes_parsed, text.size());
+
+    // size the output up front: one value per line
+    std::size_t lines = std::count(text.begin(), text.end(), '\n') + 1;
+
+    BarData bars;
+    std::vector<double>* values[] {&bars.open, &bars.high, &bars.low, &bars.close, &bars.volume};
+    const char* names[] {"Open", "High", "Low", "Close", "Volume"};
+
+    // slot -> file column; without a header the whole line is the close
+    int columns[6] {-1, -1, -1, -1, -1, -1};
+    int slots {0};
+    std::size_t line_number {0};
+
+    bars.close.reserve(lines);
 
     // read data until EOF
-    while (std::getline(file, line)) {
-        try {
-            closingPrices.push_back(std::stod(line));
+    while (!text.empty()) {
+        std::size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+
+        text.remove_prefix((newline == std::string_view::npos) ? text.size() : newline + 1);
+        line_number++;
+
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+        // exported ticker files start with a header row
+        if (line_number == 1 && header_column(line, "Close") >= 0) {
+            for (int k = 0; k < 5; k++) {
+                if (wanted & (1u << k)) columns[k] = header_column(line, names[k]);
+            }
+
+            if (wanted & WANT_TIME) {
+                columns[5] = header_column(line, "Date");
+                if (columns[5] < 0) columns[5] = header_column(line, "Datetime");
+            }
+
+            for (int k = 0; k < 6; k++) {
+                if (columns[k] < 0) continue;
+
+                slots = k + 1;
+
+                if (k < 5) values[k]->reserve(lines);
+                else bars.timestamps.reserve(lines);
+            }
+
+            continue;
         }
-        catch (const std::exception&) {
-            throw std::runtime_error("Error: potentially corrupt data");
+
+        bool ok {true};
+
+        if (slots == 0) {
+            double value {};
+
+            ok = parse_price(line, value);
+            bars.close.push_back(value);
+        } else {
+            for (int k = 0; k < slots && ok; k++) {
+                if (columns[k] < 0) continue;
+
+                std::string_view field {csv_field(line, columns[k])};
+
+                if (k < 5) {
+                    double value {};
+
+                    ok = parse_price(field, value);
+                    values[k]->push_back(value);
+                } else {
+                    std::int64_t seconds {};
+
+                    ok = parse_timestamp(field, seconds);
+                    bars.timestamps.push_back(seconds);
+                }
+            }
+        }
+
+        if (!ok) {
+            std::ostringstream oss;
+            oss << "Error: potentially corrupt data (line " << line_number << ")";
+
+            throw std::runtime_error(oss.str());
         }
     }
-    return closingPrices;
+
+    PROFILE_COUNT(Counter::rows, bars.close.size());
+
+    return bars;
+}
+
+
+// read .csv file
+// accepts either one closing price per line (temp.csv) or an exported ticker file with a header row,
+// in which case the 'Close' column is read
+std::vector<double> read_file(std::string_view file_name) {
+    return read_csv(file_name, WANT_CLOSE).close;
+}
+
+std::vector<double> read_file(std::string_view file_name, std::vector<std::int64_t>& timestamps) {
+    BarData bars {read_csv(file_name, WANT_CLOSE | WANT_TIME)};
+
+    timestamps = std::move(bars.timestamps);
+
+    return std::move(bars.close);
+}
+
+BarData read_bars(std::string_view file_name) {
+    return read_csv(file_name, WANT_ALL);
 }
 
 
@@ -43,7 +260,19 @@ void parser_error(std::string_view argv0) {
     std::cerr << "Usage: " << argv0 << " [--ticker=ticker_symbol] "
               << "[--stocks=N] "
               << "[--mode=backtest | --mode=indicator] " 
-              << "[--strategy=macd | --strategy=sma]\n";
+              << "[--strategy=macd | --strategy=sma] [--indicators=rsi,bollinger,ema,atr] [--config=file] [--timeframe=TF] "
+              << "[--macd-cross=zero | --macd-cross=signal] [--signal=N] "
+              << "[--combine=and|or|majority] [--fill=close|open] "
+              << "[--fee=X] [--slippage=BPS] [--size=P%] [--next-bar] [--long-short] [--metrics] "
+              << "[--sweep [--short=from:to[:step]] [--long=from:to[:step]] [--top=N]] "
+              << "[--walk-forward [--train=N] [--test=N] [--step=N] [--anchored]] "
+              << "[--batch[=dir|glob|list] [--output=file]] [--threads=N] [--no-cache] [--result-cache[=dir]] "
+              << "[--stream[=file] [--follow]] "
+              << "[--serve[=socket]] "
+              << "[--portfolio[=dir|glob|list] [--cash=N]] "
+              << "[--monte-carlo[=dir|glob|list] [--paths=N] [--model=bootstrap|gbm] [--block=N] [--seed=N]] "
+              << "[--precision] [--store=double|float|cents] "
+              << "[--format=text|json|csv] [--profile[=trace.json]]\n";
 }
 
 
@@ -74,6 +303,192 @@ Options:
                                   macd  Use Moving Average Convergence Divergence
                                 Default: both strategies used.
 
+  --indicators=<list>           Also report and backtest these strategies (comma-separated):
+                                  rsi        RSI 14: buy below 30, sell above 70
+                                  bollinger  Bollinger 20, 2 stdev: buy below the lower
+                                             band, sell above the mean
+                                  ema        EMA 12/26 crossover
+                                  atr        20-day breakout, 3 x ATR 14 chandelier stop
+                                They share one cache of window statistics with SMA and MACD.
+                                Single runs only; with --fill=open they trade at the next open.
+
+  --config=<file>               Strategies, parameters, vote weights and thresholds from a file,
+                                one strategy per line, instead of --strategy / --indicators:
+                                  sma short=20 long=50 weight=2
+                                  rsi period=14 oversold=25 overbought=75 name=RSI-25
+                                  sma short=10 long=40 timeframe=weekly
+                                  vote buy=0.2 sell=-0.2
+                                Keys: sma/ema short long; macd short long signal cross=zero|signal;
+                                rsi period oversold overbought; bollinger period width;
+                                atr period multiple breakout; any: weight name timeframe.
+                                A strategy with a timeframe runs on resampled bars (its periods
+                                count them) and acts on each coarse bar once it has closed.
+                                The vote (BUY weight minus SELL weight over the total, -1 to 1)
+                                is BUY above 'buy', SELL below 'sell' (default 0 and 0), and is
+                                also backtested as the strategy "Vote". Single runs, and
+                                --precision (its sma and macd lines).
+
+  --timeframe=<tf>              Resample the loaded bars before the run, in one pass:
+                                  daily, weekly, monthly  calendar days, Monday-to-Sunday
+                                                          weeks and months (UTC)
+                                  <N>min, <N>h            intraday bars, i.e. 15min or 4h
+                                Periods, --train / --test and reports then count these bars.
+                                Needs data with a Date column. Single runs, --sweep and
+                                --walk-forward only.
+
+  --macd-cross=<line>           MACD crossover reference:
+                                  zero    MACD line above/below 0
+                                  signal  MACD line above/below its signal line
+                                Default: zero
+                                Single runs, --stream and --precision (the --sweep, --walk-forward,
+                                --batch, --portfolio and --monte-carlo MACDs are zero-line).
+
+  --signal=<n>                  MACD signal-line (EMA of the MACD line) period. Default: 9
+                                Same modes as --macd-cross.
+
+  --combine=<rule>              Also backtest every strategy combined into one signal:
+                                  and       BUY only when all say BUY
+                                  or        BUY when any says BUY
+                                  majority  BUY when more than half say BUY
+                                Needs at least two strategies.
+
+  --fill=<price>                Price backtest trades are filled at:
+                                  close  The close of the signal day
+                                  open   The open (SMA: same day, MACD: next day,
+                                         since its signal needs the day's close)
+                                Default: close. 'open' needs OHLCV data.
+
+  --fee=<amount>                Flat cost of every buy and every sell. Default: 0
+
+  --slippage=<bps>              Buys fill this many basis points above the price, sells below.
+                                Default: 0
+
+  --size=<percent>%             Invest this percent of current equity in each buy (fractional
+                                shares, starting from --cash) instead of --stocks shares.
+
+  --next-bar                    Fill every trade one day after its signal.
+
+  --long-short                  Sell signals open a short position instead of going flat, so
+                                every signal change reverses between long and short.
+
+                                These apply to single runs, --sweep, --walk-forward, --batch and
+                                --monte-carlo.
+
+  --metrics                     Also report each backtest's equity-curve metrics: win rate,
+                                exposure, max drawdown, Sharpe, Sortino and CAGR (plus the
+                                trade ledger with --format=json). Single runs and --sweep.
+
+  --sweep                       Backtest every (short, long) period pair of the ranges below
+                                in parallel and print a table ranked by profit.
+
+  --short=<from:to[:step]>      Short-term periods for --sweep. Default: 5:50:5
+
+  --long=<from:to[:step]>       Long-term periods for --sweep. Default: 20:200:10
+
+  --top=<n>                     Number of ranked --sweep rows to print. Default: 20
+
+  --walk-forward                Split the data into rolling train/test windows: pick the best
+                                --short/--long pair of each strategy on every train window and
+                                backtest it on the test window that follows (out-of-sample).
+
+  --train=<n>                   Train window of --walk-forward in days. Default: 504
+
+  --test=<n>                    Test window of --walk-forward in days. Default: 126
+
+  --step=<n>                    Days between --walk-forward folds. Default: the test window
+
+  --anchored                    Start every --walk-forward train window at the first day
+                                (expanding instead of rolling windows).
+
+  --batch[=<dir|glob|list>]     Backtest every TICKER_start_to_end.csv file concurrently and
+                                print one combined report. Accepts a directory (default: data/),
+                                a glob (i.e. data/MSFT_*.csv) or a comma-separated file list.
+
+  --output=<file>               Write the --batch report to a file instead of the terminal.
+
+  --portfolio[=<dir|glob|list>] Trade every ticker found (longest file per ticker) from one shared
+                                cash balance, each BUY taking an equal share of equity, and print
+                                the combined equity, drawdown and per-ticker P&L.
+
+  --cash=<n>                    Starting cash for --portfolio and --size. Default: 100000
+
+  --monte-carlo[=<dir|glob|list>]
+                                Backtest the strategies on synthetic price paths of every data
+                                file (same selection as --batch) and print the distribution of
+                                profit and trades next to the real result.
+
+  --paths=<n>                   Synthetic paths per series for --monte-carlo. Default: 1000
+
+  --model=<type>                How --monte-carlo paths are generated:
+                                  bootstrap  Daily returns resampled in blocks of days
+                                  gbm        Geometric Brownian motion with the fitted
+                                             drift and volatility
+                                Default: bootstrap
+
+  --block=<n>                   Bootstrap block length in days. Default: 20
+
+  --seed=<n>                    Random seed of --monte-carlo; the same seed gives the same
+                                paths on any number of threads. Default: 42
+
+  --precision                   Run SMA 50/200 and MACD 12/26 (or the sma and macd lines of
+                                --config) on the prices stored as float (4 bytes) and as
+                                fixed-point cents, and report how often their signals agree
+                                with the double strategies, the largest difference of the
+                                compared series, and the backtest profit of each.
+
+  --store=<type>                How a single run stores its prices:
+                                  double  every strategy (default)
+                                  float   SMA and MACD averages, signals and backtests on
+                                          4-byte floats
+                                  cents   the same on fixed-point whole cents
+                                float and cents run SMA and MACD only (--strategy, --signal,
+                                --macd-cross or --config), frictionless and without
+                                --combine, --fill=open or --metrics. Check them with
+                                --precision first.
+
+  --threads=<n>                 Worker threads for --sweep, --walk-forward, --batch, --portfolio
+                                and --monte-carlo.
+                                Default: all cores
+
+  --stream[=<file>]             Read prices one per line from stdin (default) or a file/pipe,
+                                update the indicators in O(1) per tick and print each BUY/SELL
+                                change the moment it happens, with per-tick latency.
+
+  --follow                      With --stream, keep waiting for data appended to the file.
+
+  --serve[=<socket>]            Run as a service: keep every exported data file in data/ and the
+                                strategies built on it in memory, and answer one JSON request
+                                per line from stdin (default) or a Unix socket, concurrently on
+                                the thread pool. A request names a ticker, optionally a strategy
+                                and its parameters, stocks and mode, i.e.
+                                  {"id":1,"ticker":"MSFT","strategy":"sma","short":20,"long":50,
+                                   "stocks":10,"mode":"backtest"}
+                                and is answered with {"id":1,"ok":true,"result":{...}} (the
+                                --format=json report) or {"id":1,"ok":false,"error":"..."}.
+                                {"stats":true} returns request latency percentiles, which are
+                                also printed to stderr on exit (EOF, or SIGINT for a socket).
+
+  --format=<type>               Output format of a single run or --batch report:
+                                  text  Coloured terminal report
+                                  json  One JSON document
+                                  csv   One row per strategy (per file with --batch)
+                                Default: text
+
+  --profile[=<file>]            Time each stage of the run (argument parsing, loading, indicator
+                                series, backtests, output) and count bytes parsed, rows,
+                                indicator calls, signal days and trades; the breakdown is printed
+                                to stderr. With a file, also write a Chrome trace-event JSON
+                                (open it in chrome://tracing or Perfetto).
+
+  --no-cache                    Always parse the CSV instead of using (and writing) its binary
+                                '<file>.tsc' cache.
+
+  --result-cache[=<dir>]        Reuse the output of an identical earlier single run on the same
+                                data (default directory: data/results). Results are keyed by a
+                                hash of the data and the run's options, so an unchanged file is
+                                answered without loading it; when rows were only appended, the
+                                SMA / MACD indicator signals resume from their saved state.
+
   -h, --help                    Show this help message and exit.
 
 Notes:
@@ -83,6 +498,24 @@ Notes:
 
 Examples:
   trading_sim --ticker=AAPL --stocks=10 --mode=backtest --strategy=sma
-  trading_sim -t=TSLA -sk=5 -m=indicator -s=macd)" << "\n";
+  trading_sim -t=TSLA -sk=5 -m=indicator -s=macd
+  trading_sim -t=MSFT -m=backtest --fee=1 --slippage=5 --size=50% --next-bar
+  trading_sim -t=TSLA -m=backtest --long-short --metrics
+  trading_sim -t=MSFT -m=backtest --metrics --format=json
+  trading_sim -t=MSFT --indicators=rsi,bollinger,atr
+  trading_sim -t=MSFT --config=strategies.conf --metrics
+  trading_sim -t=MSFT --timeframe=weekly -s=macd
+  trading_sim -t=MSFT -m=indicator --result-cache
+  trading_sim -t=MSFT --sweep --short=5:50:5 --long=60:250:10 -s=sma
+  trading_sim -t=MSFT --walk-forward --train=252 --test=63
+  trading_sim --batch=data/TSLA_*.csv -sk=100
+  trading_sim --portfolio --cash=50000 -s=sma
+  trading_sim --serve=/tmp/trading_sim.sock --threads=8
+  trading_sim --monte-carlo=data/MSFT_*.csv --paths=5000 --model=gbm
+  trading_sim -t=MSFT --precision --macd-cross=signal
+  trading_sim -t=MSFT --store=float -sk=10
+  trading_sim --batch --format=csv --output=report.csv
+  trading_sim -t=MSFT --sweep --profile=trace.json
+  tail -f prices.log | trading_sim -t=AAPL --stream)" << "\n";
 }
 
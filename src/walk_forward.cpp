@@ -0,0 +1,181 @@
+#include "../include/walk_forward.h"
+#include "../include/profile.h"
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+std::vector<Fold> walk_forward_folds(int size, const WalkForwardOptions& options) {
+    int step = (options.step > 0) ? options.step : options.test;
+
+    if (options.train <= 0 || options.test <= 0 || options.step < 0) {
+        throw std::invalid_argument("Walk-forward train, test and step lengths must be positive");
+    }
+
+    std::vector<Fold> folds;
+
+    for (int begin = 0; begin + options.train + options.test <= size; begin += step) {
+        int train_end = begin + options.train;
+
+        folds.push_back({(options.anchored) ? 0 : begin, train_end, train_end + options.test});
+    }
+
+    if (folds.empty()) {
+        throw std::invalid_argument("Not enough data for one walk-forward fold (needs train + test = "
+                                    + std::to_string(options.train + options.test) + " days)");
+    }
+
+    return folds;
+}
+
+std::vector<FoldResult> walk_forward(PriceView price, SweepRange short_range, SweepRange long_range,
+                                     int stocks, bool sma_on, bool macd_on,
+                                     const WalkForwardOptions& options, ThreadPool& pool,
+                                     const ExecutionModel& execution) {
+    if (stocks <= 0) throw std::invalid_argument("Error: Invalid number of stocks");
+
+    PROFILE_SCOPE("walk-forward");
+
+    std::vector<Fold> folds {walk_forward_folds(price.size(), options)};
+    SweepGrid grid(price, short_range, long_range, sma_on, macd_on, pool);
+    const std::vector<SweepResult>& configs = grid.configurations();
+
+    int fold_count = folds.size();
+    int last_day = folds.back().test_end;
+    std::vector<BacktestResult> train(configs.size() * fold_count);
+    std::vector<std::uint8_t> trained(configs.size() * fold_count);
+
+    // phase 1: one task per configuration fills its signal mask once and scores every train window
+    // from it (a window is just a different start / end over the same mask)
+    parallel_for(pool, 0, configs.size(), [&](int c) {
+        const SweepResult& config = configs[c];
+        std::vector<std::uint8_t> mask(last_day);
+
+        if (config.long_term >= last_day) return;
+
+        grid.fill(config, config.long_term, last_day, mask.data());
+
+        for (int f = 0; f < fold_count; f++) {
+            const Fold& fold = folds[f];
+
+            // the long-term average has no value before day long_term
+            if (config.long_term >= fold.train_end) continue;
+
+            int start = std::max(fold.train_begin, config.long_term);
+
+            train[c * fold_count + f] = backtest_mask(PriceView(price.data(), fold.train_end), start, stocks, mask.data(), execution);
+            trained[c * fold_count + f] = 1;
+        }
+    });
+
+    // phase 2: one task per fold picks each strategy's best train result and trades it on the test window
+    std::vector<std::vector<FoldResult>> per_fold(fold_count);
+
+    parallel_for(pool, 0, fold_count, [&](int f) {
+        const Fold& fold = folds[f];
+
+        for (const char* strategy : {"SMA", "MACD"}) {
+            int best = -1;
+
+            // highest profit wins; ties keep the earlier configuration, as in the sweep ranking
+            for (int c = 0; c < static_cast<int>(configs.size()); c++) {
+                if (configs[c].strategy != strategy || !trained[c * fold_count + f]) continue;
+
+                if (best < 0 || train[c * fold_count + f].profit > train[best * fold_count + f].profit) best = c;
+            }
+
+            if (best < 0) continue;
+
+            std::vector<std::uint8_t> mask(fold.test_end);
+            FoldResult r {fold, strategy, configs[best].short_term, configs[best].long_term,
+                          train[best * fold_count + f], {}};
+
+            grid.fill(configs[best], fold.train_end, fold.test_end, mask.data());
+            r.test = backtest_mask(PriceView(price.data(), fold.test_end), fold.train_end, stocks, mask.data(), execution);
+
+            per_fold[f].push_back(r);
+        }
+    });
+
+    std::vector<FoldResult> results;
+
+    for (const std::vector<FoldResult>& fold_results : per_fold) {
+        results.insert(results.end(), fold_results.begin(), fold_results.end());
+    }
+
+    return results;
+}
+
+static std::string day_range(int begin, int end) {
+    return std::to_string(begin) + "-" + std::to_string(end - 1);
+}
+
+void print_walk_forward(const std::vector<FoldResult>& results, const WalkForwardOptions& options, std::ostream& out) {
+    int step = (options.step > 0) ? options.step : options.test;
+    int folds {0};
+
+    for (std::size_t i = 0; i < results.size(); i++) {
+        if (i == 0 || results[i].fold.train_end != results[i - 1].fold.train_end) folds++;
+    }
+
+    out << " [ Walk-forward ]" << "\n\n"
+        << " Folds: " << folds << " (train " << options.train << " days, test " << options.test
+        << " days, step " << step << " days, " << ((options.anchored) ? "anchored" : "rolling") << ")\n\n"
+        << std::left
+        << " " << std::setw(6) << "Fold"
+        << std::setw(13) << "Train"
+        << std::setw(13) << "Test"
+        << std::setw(10) << "Strategy"
+        << std::setw(8) << "Short"
+        << std::setw(8) << "Long"
+        << std::setw(16) << "Train profit"
+        << "Test profit" << "\n";
+
+    folds = 0;
+
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const FoldResult& r = results[i];
+
+        if (i == 0 || r.fold.train_end != results[i - 1].fold.train_end) folds++;
+
+        out << " " << std::setw(6) << folds
+            << std::setw(13) << day_range(r.fold.train_begin, r.fold.train_end)
+            << std::setw(13) << day_range(r.fold.train_end, r.fold.test_end)
+            << std::setw(10) << r.strategy
+            << std::setw(8) << r.short_term
+            << std::setw(8) << r.long_term
+            << std::setw(16) << r.train.profit
+            << r.test.profit << "\n";
+    }
+
+    out << std::right << "\n";
+
+    // out-of-sample totals: the figure to compare with a single in-sample backtest
+    for (const char* strategy : {"SMA", "MACD"}) {
+        int transactions {0};
+        double train_profit {0};
+        double test_profit {0};
+        bool found {false};
+
+        for (const FoldResult& r : results) {
+            if (r.strategy != strategy) continue;
+
+            found = true;
+            transactions += r.test.transactions;
+            train_profit += r.train.profit;
+            test_profit += r.test.profit;
+        }
+
+        if (!found) continue;
+
+        out << " Strategy: " << strategy << "\n"
+            << " Out-of-sample transactions: " << transactions << "\n"
+            << " Out-of-sample profit: " << test_profit << "\n"
+            << " In-sample profit (sum of train windows): " << train_profit << "\n"
+            << "------------------------------" << "\n";
+    }
+}
@@ -0,0 +1,56 @@
+#include "../include/ATR.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+
+static std::vector<double> data = {10.0, 10.0, 12.0, 13.0, 11.0, 14.0};
+
+
+TEST(TestATR, ThrowsInvalidArgument) {
+    SeriesCache cache {close_only(data)};
+
+    EXPECT_THROW(ATR(cache, 2, 0), std::invalid_argument);
+    EXPECT_THROW(ATR(cache, 2, 1, 0), std::invalid_argument);
+    EXPECT_THROW(ATR(cache, 2, 1, 6), std::invalid_argument);
+    EXPECT_THROW(ATR(cache, 4, 1, 2), std::invalid_argument);
+
+    ATR atr(cache, 2, 1, 2);
+
+    EXPECT_EQ(atr.first_signal_day(), 2);
+    EXPECT_THROW(atr.indicator(1), std::invalid_argument);
+    EXPECT_THROW(atr.indicator(6), std::invalid_argument);
+}
+
+
+TEST(TestATR, BreakoutEntryAndChandelierExit) {
+    SeriesCache cache {close_only(data)};
+    ATR atr(cache, 2, 1, 2);
+
+    // close-to-close true ranges {0, 0, 2, 1, 2, 3}, span 3 EMA
+    EXPECT_NEAR(atr.value(2), 2.0 / 3, 1e-12);
+    EXPECT_NEAR(atr.value(4), 17.0 / 12, 1e-12);
+
+    // in on the breakouts of days 2 and 5, out on day 4: 11 < 13 - 1.42
+    EXPECT_TRUE(atr.indicator(2));
+    EXPECT_TRUE(atr.indicator(3));
+    EXPECT_FALSE(atr.indicator(4));
+    EXPECT_TRUE(atr.indicator());
+}
+
+
+TEST(TestATR, UsesHighsAndLows) {
+    std::vector<double> high = {10.5, 10.5, 12.5, 13.5, 12.0, 14.5};
+    std::vector<double> low = {9.5, 9.5, 11.5, 12.5, 10.5, 13.5};
+    BarsView bars {data, high, low, data, {}, {}};
+    SeriesCache cache {bars};
+    ATR atr(cache, 2, 1, 2);
+
+    // true ranges {1, 1, 2.5, 1.5, 2.5, 3.5}: gaps from the previous close count
+    EXPECT_NEAR(atr.value(2), 1.5, 1e-12);
+    EXPECT_NEAR(atr.value(4), 2.0, 1e-12);
+
+    // the stop trails the highest high: 11 < 13.5 - 2
+    EXPECT_TRUE(atr.indicator(3));
+    EXPECT_FALSE(atr.indicator(4));
+}
@@ -0,0 +1,287 @@
+#include "../include/backtest.h"
+#include "../include/compose.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+static std::vector<double> random_walk(int n, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 1.0);
+    std::vector<double> p(n);
+    double price {100.0};
+
+    for (int i = 0; i < n; i++) {
+        price = std::max(1.0, price + step(rng));
+        p[i] = price;
+    }
+
+    return p;
+}
+
+static void expect_identical(const BacktestResult& a, const BacktestResult& b) {
+    EXPECT_EQ(a.transactions, b.transactions);
+    EXPECT_EQ(a.profit, b.profit);
+
+    if (std::isnan(a.percent)) EXPECT_TRUE(std::isnan(b.percent));
+    else EXPECT_EQ(a.percent, b.percent);
+}
+
+
+TEST(TestBacktest, GreaterMaskMatchesScalarCompare) {
+    std::vector<double> a {random_walk(101, 1)};
+    std::vector<double> b {random_walk(101, 2)};
+    std::vector<std::uint8_t> mask(a.size(), 7);
+
+    greater_mask(a.data(), b.data(), 3, a.size(), mask.data());
+
+    EXPECT_EQ(mask[2], 7);
+
+    for (std::size_t i = 3; i < a.size(); i++) EXPECT_EQ(mask[i], a[i] > b[i]);
+
+    greater_mask(a.data(), nullptr, 0, 5, mask.data());
+
+    for (int i = 0; i < 5; i++) EXPECT_EQ(mask[i], 1);
+}
+
+
+// random masks of many lengths and densities, including trades open at the end and on the last day
+TEST(TestBacktest, MaskBacktestMatchesDayLoop) {
+    std::mt19937 rng(9);
+
+    for (int n : {1, 2, 15, 16, 17, 33, 200, 1001}) {
+        std::vector<double> p {random_walk(n, n)};
+
+        for (double density : {0.0, 0.05, 0.5, 0.95, 1.0}) {
+            std::bernoulli_distribution coin(density);
+            std::vector<std::uint8_t> mask(n);
+
+            for (auto& m : mask) m = coin(rng);
+
+            for (int start : {0, n / 3, n - 1}) {
+                auto loop = [&](int day) { return mask[day] != 0; };
+
+                expect_identical(backtest_mask(p, start, 7, mask.data()), backtest_signal(p, start, 7, loop));
+            }
+        }
+    }
+}
+
+
+TEST(TestBacktest, TwoPhaseMatchesStrategies) {
+    std::vector<double> p {random_walk(5000, 3)};
+    SMA sma(p, 20, 100);
+    MACD macd(p, 12, 26, 9, MACD::Crossover::signal_line);
+    int start = macd.first_signal_day() > 100 ? macd.first_signal_day() : 100;
+
+    expect_identical(backtest_vectorized(p, start, 10, sma.signal()), backtest_signal(p, start, 10, sma.signal()));
+    expect_identical(backtest_vectorized(p, start, 10, macd.signal()), backtest_signal(p, start, 10, macd.signal()));
+
+    auto majority = majority_of_signals(sma.signal(), macd.signal(), [](int day) { return day % 7 < 3; });
+
+    expect_identical(backtest_vectorized(p, start, 10, majority), backtest_signal(p, start, 10, majority));
+}
+
+
+TEST(TestBacktest, FrictionlessExecutionIsIdentical) {
+    std::vector<double> p {random_walk(5000, 11)};
+    SMA sma(p, 5, 20);
+    std::vector<std::uint8_t> mask(p.size());
+
+    fill_signals(sma.signal(), 20, p.size(), mask.data());
+
+    expect_identical(backtest_mask(p, 20, 3, mask.data()), backtest_mask(p, 20, 3, mask.data(), ExecutionModel {}));
+}
+
+
+// long on mask days of 1 and short on days of 0, reversing at every change and closed on the last day
+static BacktestResult long_short_day_loop(const std::vector<double>& p, int start_day, int stocks, const std::uint8_t* mask) {
+    BacktestResult result;
+    int last = p.size() - 1;
+    int side {0};
+    double entry {0};
+    double first_cost {0};
+
+    for (int day = start_day; day <= last; day++) {
+        int wanted {mask[day] ? 1 : -1};
+
+        if (wanted == side) continue;
+
+        if (side != 0) result.profit += (p[day] - entry) * side * stocks;
+        else first_cost = p[day] * stocks;
+
+        side = wanted;
+        entry = p[day];
+        result.transactions += 2;
+    }
+
+    if (side != 0) result.profit += (p[last] - entry) * side * stocks;
+
+    result.percent = result.profit / first_cost * 100;
+
+    return result;
+}
+
+
+TEST(TestBacktest, LongShortMatchesDayLoop) {
+    std::mt19937 rng(13);
+    ExecutionModel execution;
+
+    execution.shorts = true;
+
+    for (int n : {1, 2, 17, 200, 1001}) {
+        std::vector<double> p {random_walk(n, n + 40)};
+
+        for (double density : {0.0, 0.3, 0.5, 1.0}) {
+            std::bernoulli_distribution coin(density);
+            std::vector<std::uint8_t> mask(n);
+
+            for (auto& m : mask) m = coin(rng);
+
+            for (int start : {0, n / 3, n - 1}) {
+                BacktestResult expected {long_short_day_loop(p, start, 3, mask.data())};
+                BacktestResult result {backtest_mask(p, start, 3, mask.data(), execution)};
+
+                EXPECT_EQ(result.transactions, expected.transactions);
+                EXPECT_NEAR(result.profit, expected.profit, 1e-9 * std::abs(expected.profit) + 1e-9);
+                EXPECT_NEAR(result.percent, expected.percent, 1e-9 * std::abs(expected.percent) + 1e-9);
+            }
+        }
+    }
+}
+
+
+// buy on day 1, sell on day 3, buy again on day 4 (sold on the last day)
+static const std::vector<double> prices {10, 10, 12, 15, 20, 25};
+static const std::vector<std::uint8_t> trades {0, 1, 1, 0, 1, 1};
+
+
+TEST(TestBacktest, ChargesFeesAndSlippage) {
+    ExecutionModel execution;
+
+    execution.fee = 1;
+    execution.slippage_bps = 100;
+
+    BacktestResult result {backtest_mask(prices, 0, 2, trades.data(), execution)};
+
+    // (15 * 0.99 - 10 * 1.01) * 2 - 2 + (25 * 0.99 - 20 * 1.01) * 2 - 2
+    EXPECT_EQ(result.transactions, 4);
+    EXPECT_NEAR(result.profit, 7.5 + 7.1, 1e-9);
+    EXPECT_NEAR(result.percent, (7.5 + 7.1) / 20.2 * 100, 1e-9);
+}
+
+
+TEST(TestBacktest, FillsOnTheNextBar) {
+    ExecutionModel execution;
+
+    execution.delay = 1;
+
+    // bought at 12 and sold at 20, then bought and sold at 25 on the last day
+    BacktestResult result {backtest_mask(prices, 0, 1, trades.data(), execution)};
+
+    EXPECT_EQ(result.transactions, 4);
+    EXPECT_DOUBLE_EQ(result.profit, 8);
+
+    // a buy signalled on the last day has no bar left to fill on
+    std::vector<std::uint8_t> late {0, 0, 0, 0, 0, 1};
+
+    EXPECT_EQ(backtest_mask(prices, 0, 1, late.data(), execution).transactions, 0);
+}
+
+
+TEST(TestBacktest, SizesByPercentOfEquity) {
+    ExecutionModel execution;
+
+    execution.equity_percent = 50;
+    execution.capital = 1000;
+
+    BacktestResult result {backtest_mask(prices, 0, 1, trades.data(), execution)};
+
+    // 500 buys 50 shares at 10 (+250), then 625 buys 31.25 shares at 20 (+156.25)
+    EXPECT_DOUBLE_EQ(result.profit, 406.25);
+    EXPECT_DOUBLE_EQ(result.percent, 40.625);
+}
+
+
+TEST(TestBacktest, ReversesBetweenLongAndShort) {
+    ExecutionModel execution;
+
+    execution.shorts = true;
+
+    // short 10 -> 10, long 10 -> 15, short 15 -> 20, long 20 -> 25
+    BacktestResult result {backtest_mask(prices, 0, 2, trades.data(), execution)};
+
+    EXPECT_EQ(result.transactions, 8);
+    EXPECT_DOUBLE_EQ(result.profit, 0 + 10 - 10 + 10);
+    EXPECT_DOUBLE_EQ(result.percent, 10.0 / 20 * 100);
+
+    // a short sells into the slippage and buys back above the price
+    execution.fee = 1;
+    execution.slippage_bps = 100;
+
+    std::vector<std::uint8_t> falling {0, 0, 0, 0, 0, 0};
+    std::vector<double> down {25, 20, 15, 12, 10, 10};
+
+    result = backtest_mask(down, 0, 2, falling.data(), execution);
+
+    // (25 * 0.99 - 10 * 1.01) * 2 - 2
+    EXPECT_EQ(result.transactions, 2);
+    EXPECT_NEAR(result.profit, 27.3, 1e-9);
+    EXPECT_NEAR(result.percent, 27.3 / 49.5 * 100, 1e-9);
+
+    std::vector<Trade> ledger;
+    std::vector<int> transitions;
+
+    trade_ledger(down, 0, 2, falling.data(), execution, transitions, ledger);
+
+    ASSERT_EQ(ledger.size(), 1u);
+    EXPECT_EQ(ledger[0].shares, -2);
+    EXPECT_NEAR((ledger[0].exit_price - ledger[0].entry_price) * ledger[0].shares - 2, ledger[0].pnl, 1e-9);
+
+    // long only, the same mask never trades
+    execution.shorts = false;
+
+    EXPECT_EQ(backtest_mask(down, 0, 2, falling.data(), execution).transactions, 0);
+}
+
+
+TEST(TestBacktest, BuyAndHoldNeverShorts) {
+    ExecutionModel execution;
+
+    execution.shorts = true;
+
+    expect_identical(backtest_buy_and_hold(prices, 2, execution), backtest_buy_and_hold(prices, 2));
+}
+
+
+TEST(TestBacktest, BuyAndHoldPaysCosts) {
+    ExecutionModel execution;
+
+    execution.fee = 5;
+
+    EXPECT_DOUBLE_EQ(backtest_buy_and_hold(prices, 2, execution).profit, 30 - 10);
+    EXPECT_DOUBLE_EQ(backtest_buy_and_hold(prices, 2, ExecutionModel {}).profit, 30);
+}
+
+
+TEST(TestBacktest, RejectsInvalidExecution) {
+    ExecutionModel execution;
+
+    execution.fee = -1;
+    EXPECT_THROW(check_execution_model(execution), std::invalid_argument);
+
+    execution = {};
+    execution.slippage_bps = 10000;
+    EXPECT_THROW(check_execution_model(execution), std::invalid_argument);
+
+    execution = {};
+    execution.equity_percent = 150;
+    EXPECT_THROW(check_execution_model(execution), std::invalid_argument);
+
+    EXPECT_NO_THROW(check_execution_model(ExecutionModel {}));
+}
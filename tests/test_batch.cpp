@@ -0,0 +1,56 @@
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "../test_data/"
+#endif
+
+
+#include "../include/batch.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+
+static const std::string exported {std::string(TEST_DATA_DIR) + "TEST_2025-01-02_to_2025-01-03.csv"};
+
+
+TEST(TestBatch, ParsesDataFileNames) {
+    std::string ticker;
+    std::string period;
+
+    parse_data_file_name("data/MSFT_2022-11-05_to_2025-11-04.csv", ticker, period);
+    EXPECT_EQ(ticker, "MSFT");
+    EXPECT_EQ(period, "2022-11-05 to 2025-11-04");
+
+    parse_data_file_name("data/temp.csv", ticker, period);
+    EXPECT_EQ(ticker, "temp");
+    EXPECT_EQ(period, "");
+}
+
+
+TEST(TestBatch, FindsExportedFilesInDirectory) {
+    std::vector<std::string> files {find_data_files(TEST_DATA_DIR)};
+
+    ASSERT_EQ(files.size(), 1u);
+    EXPECT_EQ(files[0], exported);
+}
+
+
+TEST(TestBatch, FindsFilesByGlobAndList) {
+    EXPECT_EQ(find_data_files(std::string(TEST_DATA_DIR) + "*_data.csv").size(), 2u);
+    EXPECT_EQ(find_data_files("a.csv,b.csv").size(), 2u);
+}
+
+
+TEST(TestBatch, ReportsFailuresWithoutStopping) {
+    ThreadPool pool(2);
+    std::vector<std::string> files {exported, std::string(TEST_DATA_DIR) + "invalid_data.csv",
+                                    std::string(TEST_DATA_DIR) + "invalid_name.csv"};
+    std::vector<BatchReport> reports {run_batch(files, 10, false, false, false, pool)};
+
+    ASSERT_EQ(reports.size(), 3u);
+    EXPECT_TRUE(reports[0].error.empty());
+    EXPECT_EQ(reports[0].ticker, "TEST");
+    EXPECT_EQ(reports[0].days, 2);
+    EXPECT_DOUBLE_EQ(reports[0].bnh.profit, 12.5);
+    EXPECT_FALSE(reports[1].error.empty());
+    EXPECT_FALSE(reports[2].error.empty());
+}
@@ -0,0 +1,40 @@
+#include "../include/Bollinger.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+
+static std::vector<double> data = {10.0, 10.0, 10.0, 7.0, 8.0, 10.0};
+
+
+TEST(TestBollinger, ThrowsInvalidArgument) {
+    SeriesCache cache {close_only(data)};
+
+    EXPECT_THROW(Bollinger(cache, 1), std::invalid_argument);
+    EXPECT_THROW(Bollinger(cache, 7), std::invalid_argument);
+    EXPECT_THROW(Bollinger(cache, 3, 0), std::invalid_argument);
+
+    Bollinger bollinger(cache, 3, 1);
+
+    EXPECT_EQ(bollinger.first_signal_day(), 2);
+    EXPECT_THROW(bollinger.indicator(1), std::invalid_argument);
+    EXPECT_THROW(bollinger.indicator(6), std::invalid_argument);
+}
+
+
+TEST(TestBollinger, HoldsFromLowerBandToMean) {
+    SeriesCache cache {close_only(data)};
+    Bollinger bollinger(cache, 3, 1);
+
+    // day 3: 7 < 9 - sqrt(2); day 4: 8 between the lower band and the mean; day 5: 10 > 8.33
+    EXPECT_FALSE(bollinger.indicator(2));
+    EXPECT_TRUE(bollinger.indicator(3));
+    EXPECT_TRUE(bollinger.indicator(4));
+    EXPECT_FALSE(bollinger.indicator());
+
+    // a wider band never reaches the dip
+    SeriesCache other {close_only(data)};
+    Bollinger wide(other, 3, 2);
+
+    EXPECT_FALSE(wide.indicator(3));
+}
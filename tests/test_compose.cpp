@@ -0,0 +1,120 @@
+#include "../include/compose.h"
+#include "../include/backtest.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include "../include/simulator.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+
+// deterministic zig-zag so SMA and MACD disagree on some days
+static std::vector<double> wave() {
+    std::vector<double> p;
+
+    for (int i = 0; i < 120; i++) p.push_back(100 + 10 * std::sin(i * 0.3) + i * 0.05);
+
+    return p;
+}
+
+
+TEST(TestCompose, SignalsMatchIndicator) {
+    std::vector<double> p {wave()};
+    SMA sma(p, 5, 20);
+    MACD macd(p, 5, 20, 9, MACD::Crossover::signal_line);
+
+    for (int day = macd.first_signal_day(); day < static_cast<int>(p.size()); day++) {
+        EXPECT_EQ(sma.signal()(day), sma.indicator(day));
+        EXPECT_EQ(macd.signal()(day), macd.indicator(day));
+    }
+}
+
+
+TEST(TestCompose, CombinatorsFoldSignals) {
+    auto yes = [](int) { return true; };
+    auto no = [](int) { return false; };
+
+    EXPECT_TRUE(all_of_signals(yes, yes)(0));
+    EXPECT_FALSE(all_of_signals(yes, no)(0));
+    EXPECT_TRUE(any_of_signals(no, yes)(0));
+    EXPECT_FALSE(any_of_signals(no, no)(0));
+    EXPECT_TRUE(majority_of_signals(yes, no, yes)(0));
+    EXPECT_FALSE(majority_of_signals(yes, no, no)(0));
+    EXPECT_FALSE(majority_of_signals(yes, no)(0));
+}
+
+
+TEST(TestCompose, ComposedBacktestMatchesRuntimePath) {
+    std::vector<double> p {wave()};
+    SMA sma(p, 5, 20);
+    MACD macd(p, 5, 20);
+    const Strategy& a = sma;
+    const Strategy& b = macd;
+    int start = 20;
+
+    BacktestResult composed {backtest_signal(p, start, 3, any_of_signals(sma.signal(), macd.signal()))};
+    BacktestResult runtime {backtest_signal(p, start, 3, [&](int day) { return a.indicator(day) || b.indicator(day); })};
+
+    EXPECT_EQ(composed.transactions, runtime.transactions);
+    EXPECT_DOUBLE_EQ(composed.profit, runtime.profit);
+}
+
+
+TEST(TestCompose, ParsesCombinations) {
+    EXPECT_EQ(parse_combine("and"), Combine::all);
+    EXPECT_EQ(parse_combine("or"), Combine::any);
+    EXPECT_EQ(parse_combine("majority"), Combine::majority);
+    EXPECT_THROW(parse_combine("xor"), std::invalid_argument);
+}
+
+
+TEST(TestCompose, SimulatorAddsCombinedRow) {
+    std::vector<double> p {wave()};
+    SMA sma(p, 5, 20);
+    MACD macd(p, 5, 20);
+    Simulator single(sma, p);
+    Simulator both(sma, macd, p);
+
+    EXPECT_THROW(single.set_combination(Combine::all), std::invalid_argument);
+
+    both.set_combination(Combine::all);
+    BacktestReport report {both.backtest_report(1)};
+
+    ASSERT_EQ(report.strategies.size(), 3u);
+    EXPECT_EQ(report.strategies[2].strategy, "SMA AND MACD");
+}
+
+
+TEST(TestCompose, CompiledCombinationMatchesDecisionFold) {
+    std::vector<double> p {wave()};
+    std::vector<double> open {p.front()};
+
+    open.insert(open.end(), p.begin(), p.end() - 1);
+
+    auto sma = std::make_shared<SMA>(p, 5, 20);
+    auto macd = std::make_shared<MACD>(p, 5, 20, 9, MACD::Crossover::signal_line);
+
+    for (Combine mode : {Combine::all, Combine::any, Combine::majority}) {
+        for (bool at_open : {false, true}) {
+            // SMA then MACD combine at compile time, the other order through the decision masks
+            Simulator compiled({{"SMA", sma}, {"MACD", macd}}, p);
+            Simulator folded({{"MACD", macd}, {"SMA", sma}}, p);
+
+            compiled.set_combination(mode);
+            folded.set_combination(mode);
+
+            if (at_open) {
+                compiled.set_open_fill(open);
+                folded.set_open_fill(open);
+            }
+
+            BacktestResult a {compiled.backtest_report(1).strategies[2].result};
+            BacktestResult b {folded.backtest_report(1).strategies[2].result};
+
+            EXPECT_EQ(a.transactions, b.transactions);
+            EXPECT_DOUBLE_EQ(a.profit, b.profit);
+        }
+    }
+}
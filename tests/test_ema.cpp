@@ -0,0 +1,49 @@
+#include "../include/ema.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+
+static std::vector<double> wave() {
+    std::vector<double> p;
+
+    for (int i = 0; i < 120; i++) p.push_back(50 + 5 * std::sin(i / 3.0) + i * 0.1);
+
+    return p;
+}
+
+
+TEST(TestEMA, SeedsWithSimpleAverage) {
+    std::vector<double> data = {1.0, 2.0, 3.0, 4.0};
+    std::vector<double> ema {ema_series(data, 3)};
+
+    ASSERT_EQ(ema.size(), data.size());
+    EXPECT_DOUBLE_EQ(ema[1], 0.0);
+    EXPECT_DOUBLE_EQ(ema[2], 2.0);
+    EXPECT_DOUBLE_EQ(ema[3], 4.0 * 0.5 + 2.0 * 0.5);
+}
+
+
+TEST(TestEMA, ThrowsInvalidArgument) {
+    std::vector<double> data = {1.0, 2.0, 3.0};
+
+    EXPECT_THROW(ema_series(data, 0), std::invalid_argument);
+    EXPECT_THROW(ema_series(data, 4), std::invalid_argument);
+    EXPECT_THROW(batch_ema(data, {2, 5}), std::invalid_argument);
+}
+
+
+TEST(TestEMA, BatchMatchesSingleSpanExactly) {
+    std::vector<double> p {wave()};
+    std::vector<int> spans = {26, 3, 12, 12, 50, 9, 100};
+    std::vector<double> batch {batch_ema(p, spans)};
+
+    ASSERT_EQ(batch.size(), spans.size() * p.size());
+
+    for (std::size_t j = 0; j < spans.size(); j++) {
+        std::vector<double> single {ema_series(p, spans[j])};
+
+        for (std::size_t i = 0; i < p.size(); i++) EXPECT_EQ(batch[j * p.size() + i], single[i]);
+    }
+}
@@ -0,0 +1,37 @@
+#include "../include/EMACross.h"
+#include "../include/MACD.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+
+TEST(TestEMACross, ThrowsInvalidArgument) {
+    std::vector<double> data(10, 1.0);
+    SeriesCache cache {close_only(data)};
+
+    EXPECT_THROW(EMACross(cache, 3, 3), std::invalid_argument);
+    EXPECT_THROW(EMACross(cache, 3, 11), std::invalid_argument);
+
+    EMACross cross(cache, 2, 4);
+
+    EXPECT_THROW(cross.indicator(3), std::invalid_argument);
+    EXPECT_THROW(cross.indicator(10), std::invalid_argument);
+}
+
+
+TEST(TestEMACross, MatchesMACDZeroLineWithSharedEMAs) {
+    std::vector<double> data = {1.0, 2.0, 3.0, 2.0, 1.0, 2.0, 3.0, 4.0, 3.0, 1.0};
+    SeriesCache cache {close_only(data)};
+    MACD macd(cache, 2, 3);
+    EMACross cross(cache, 2, 3);
+
+    // the crossover reused MACD's two EMAs
+    EXPECT_EQ(cache.computed(), 2);
+
+    for (int day = 3; day < 10; day++) EXPECT_EQ(cross.indicator(day), macd.indicator(day));
+
+    std::vector<std::uint8_t> mask(data.size());
+    cross.fill(3, 10, mask.data());
+
+    for (int day = 3; day < 10; day++) EXPECT_EQ(mask[day], cross.signal()(day));
+}
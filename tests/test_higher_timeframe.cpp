@@ -0,0 +1,103 @@
+#include "../include/HigherTimeframe.h"
+#include "../include/SMA.h"
+#include "../include/util.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+// weekly decisions given up front, from bar `from` on
+class WeeklyStub : public Strategy {
+private:
+    std::vector<std::uint8_t> decisions;
+    int from;
+    bool at_close;
+
+public:
+    WeeklyStub(const BarsView& b, std::vector<std::uint8_t> d, int f, bool c)
+        : Strategy(b, 1, 2), decisions(std::move(d)), from(f), at_close(c) {}
+
+    int first_signal_day() const { return from; }
+    bool indicator(int day=-1) const { return decisions[(day == -1) ? size - 1 : day]; }
+    bool needs_day_close() const { return at_close; }
+};
+
+
+// three weeks of Monday to Friday closes
+class TestHigherTimeframe : public ::testing::Test {
+protected:
+    std::vector<double> close;
+    std::vector<std::int64_t> timestamps;
+
+    void SetUp() override {
+        std::int64_t monday {0};
+
+        ASSERT_TRUE(parse_timestamp("2025-01-06", monday));
+
+        for (int week = 0; week < 3; week++) {
+            for (int day = 0; day < 5; day++) {
+                close.push_back(100 + 5 * week + day);
+                timestamps.push_back(monday + (7 * week + day) * 86400);
+            }
+        }
+    }
+
+    BarsView bars() const { return {{}, {}, {}, close, {}, timestamps}; }
+};
+
+
+TEST_F(TestHigherTimeframe, WeeklyCloseActsFromTheLastDayOfItsWeek) {
+    SeriesCache cache {bars()};
+    Timeframe weekly {parse_timeframe("weekly")};
+    TimeframeSeries& series = cache.timeframe(weekly);
+    HigherTimeframe tf(cache, weekly, std::make_shared<WeeklyStub>(series.cache.get_bars(), std::vector<std::uint8_t> {0, 1, 0}, 1, true));
+
+    // week 1 is known at its Friday close (day 9), week 2 at day 14
+    EXPECT_EQ(tf.first_signal_day(), 9);
+    EXPECT_TRUE(tf.needs_day_close());
+    EXPECT_TRUE(tf.indicator(9));
+    EXPECT_TRUE(tf.indicator(13));
+    EXPECT_FALSE(tf.indicator(14));
+    EXPECT_FALSE(tf.indicator());
+    EXPECT_THROW(tf.indicator(8), std::invalid_argument);
+    EXPECT_THROW(tf.indicator(15), std::invalid_argument);
+}
+
+
+TEST_F(TestHigherTimeframe, EarlierBarDecisionsHoldAllWeek) {
+    SeriesCache cache {bars()};
+    Timeframe weekly {parse_timeframe("weekly")};
+    TimeframeSeries& series = cache.timeframe(weekly);
+    HigherTimeframe tf(cache, weekly, std::make_shared<WeeklyStub>(series.cache.get_bars(), std::vector<std::uint8_t> {0, 1, 0}, 1, false));
+    std::vector<std::uint8_t> out(15);
+
+    tf.fill(tf.first_signal_day(), 15, out.data());
+
+    EXPECT_EQ(tf.first_signal_day(), 5);
+    EXPECT_FALSE(tf.needs_day_close());
+    EXPECT_EQ(out, (std::vector<std::uint8_t> {0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0}));
+
+    // a weekly SMA(1, 2) on the weekly cache: last week's close above the one before, known on Monday
+    HigherTimeframe sma(cache, weekly, std::make_shared<SMA>(series.cache, 1, 2));
+
+    EXPECT_EQ(sma.first_signal_day(), 10);
+    EXPECT_EQ(sma.get_short_term(), 1);
+    EXPECT_EQ(sma.get_long_term(), 2);
+    EXPECT_TRUE(sma.indicator(10));
+}
+
+
+TEST_F(TestHigherTimeframe, ThrowsInvalidArgument) {
+    SeriesCache cache {bars()};
+    SeriesCache other {bars()};
+    Timeframe weekly {parse_timeframe("weekly")};
+    BarsView weekly_bars {cache.timeframe(weekly).cache.get_bars()};
+
+    // not enough weeks, or a strategy on bars other than the cache's weekly ones
+    EXPECT_THROW(HigherTimeframe(cache, weekly, std::make_shared<WeeklyStub>(weekly_bars, std::vector<std::uint8_t>(3), 3, true)), std::invalid_argument);
+    EXPECT_THROW(HigherTimeframe(other, weekly, std::make_shared<WeeklyStub>(weekly_bars, std::vector<std::uint8_t>(3), 1, true)), std::invalid_argument);
+    EXPECT_THROW(HigherTimeframe(cache, weekly, std::make_shared<WeeklyStub>(bars(), std::vector<std::uint8_t>(15), 1, true)), std::invalid_argument);
+}
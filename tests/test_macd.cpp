@@ -34,3 +34,41 @@ TEST(TestMACD, IndicatorReturnsABool) {
     EXPECT_FALSE(macd.indicator(4));
 }
 
+
+
+TEST(TestMACD, BuildsSignalLineAndHistogram) {
+    std::vector<double> data = {1.0, 2.0, 3.0, 2.0, 1.0, 2.0, 3.0, 4.0};
+    MACD macd(data, 2, 3, 2);
+    PriceView line {macd.get_macd_line()};
+    PriceView signal {macd.get_signal_line()};
+    PriceView histogram {macd.get_histogram()};
+
+    // signal seeded with the mean of the first two MACD values (days 2 and 3)
+    EXPECT_DOUBLE_EQ(signal[3], (line[2] + line[3]) / 2);
+
+    for (int i = 3; i < 8; i++) EXPECT_DOUBLE_EQ(histogram[i], line[i] - signal[i]);
+}
+
+
+TEST(TestMACD, SignalLineCrossover) {
+    std::vector<double> data = {1.0, 2.0, 3.0, 2.0, 1.0, 2.0, 3.0, 4.0};
+    MACD macd(data, 2, 3, 2, MACD::Crossover::signal_line);
+    PriceView histogram {macd.get_histogram()};
+
+    EXPECT_EQ(macd.first_signal_day(), 3);
+    EXPECT_THROW(macd.indicator(2), std::invalid_argument);
+
+    for (int i = 3; i < 8; i++) EXPECT_EQ(macd.indicator(i), histogram[i] > 0);
+
+    // the MACD line starts below its signal and crosses above it on day 5
+    EXPECT_EQ(macd.crossover(3), 0);
+    EXPECT_EQ(macd.crossover(4), 0);
+    EXPECT_EQ(macd.crossover(5), 1);
+    EXPECT_EQ(macd.crossover(6), 0);
+}
+
+
+TEST(TestMACD, SignalLineNeedsEnoughData) {
+    EXPECT_THROW(MACD(data, 1, 2, 9, MACD::Crossover::signal_line), std::invalid_argument);
+    EXPECT_NO_THROW(MACD(data, 1, 2, 9));
+}
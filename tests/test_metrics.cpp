@@ -0,0 +1,155 @@
+#include "../include/metrics.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+static std::vector<double> random_walk(int n, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 1.0);
+    std::vector<double> p(n);
+    double price {100.0};
+
+    for (int i = 0; i < n; i++) {
+        price = std::max(1.0, price + step(rng));
+        p[i] = price;
+    }
+
+    return p;
+}
+
+
+// two trades: bought at 11, sold at 9 (-2), bought at 10, sold at the end at 14 (+4)
+TEST(TestMetrics, BuildsEquityCurveAndLedger) {
+    std::vector<double> p {10, 11, 12, 9, 10, 14};
+    std::vector<std::uint8_t> mask {0, 1, 1, 0, 1, 1};
+    MetricsArena arena;
+
+    Metrics m {compute_metrics(p, 0, 1, mask.data(), {}, arena)};
+
+    ASSERT_EQ(arena.ledger.size(), 2u);
+    EXPECT_EQ(arena.ledger[0].entry_day, 1);
+    EXPECT_EQ(arena.ledger[0].exit_day, 3);
+    EXPECT_DOUBLE_EQ(arena.ledger[0].pnl, -2);
+    EXPECT_EQ(arena.ledger[1].exit_day, 5);
+    EXPECT_DOUBLE_EQ(arena.ledger[1].pnl, 4);
+
+    // starting equity is the first buy's cost (11)
+    std::vector<double> expected {11, 11, 12, 9, 9, 13};
+    ASSERT_EQ(arena.equity.size(), expected.size());
+
+    for (std::size_t i = 0; i < expected.size(); i++) EXPECT_DOUBLE_EQ(arena.equity[i], expected[i]);
+
+    EXPECT_EQ(m.trades, 2);
+    EXPECT_DOUBLE_EQ(m.win_rate, 50);
+    EXPECT_DOUBLE_EQ(m.exposure, 50);
+    EXPECT_DOUBLE_EQ(m.max_drawdown, 25);
+    EXPECT_DOUBLE_EQ(m.final_equity, 13);
+    EXPECT_DOUBLE_EQ(m.total_return, (13.0 / 11 - 1) * 100);
+}
+
+
+TEST(TestMetrics, AnnualizesDailyReturns) {
+    // buy and hold of one share: the equity curve is the price, returns +10%, -10%, +10%
+    std::vector<double> p {100, 110, 99, 108.9};
+    MetricsArena arena;
+
+    Metrics m {buy_and_hold_metrics(p, 1, {}, arena)};
+
+    double mean = 0.1 / 3;
+    double stdev = std::sqrt(((0.1 - mean) * (0.1 - mean) * 2 + (-0.1 - mean) * (-0.1 - mean)) / 2);
+    double downside = std::sqrt(0.01 / 3);
+
+    EXPECT_NEAR(m.sharpe, mean / stdev * std::sqrt(TRADING_DAYS), 1e-9);
+    EXPECT_NEAR(m.sortino, mean / downside * std::sqrt(TRADING_DAYS), 1e-9);
+    EXPECT_NEAR(m.max_drawdown, 10, 1e-9);
+    EXPECT_NEAR(m.cagr, (std::pow(1.089, TRADING_DAYS / 3) - 1) * 100, 1e-6);
+}
+
+
+TEST(TestMetrics, SteadyGrowthHasNoRisk) {
+    std::vector<double> p {100};
+
+    for (int i = 0; i < 252; i++) p.push_back(p.back() * 1.001);
+
+    MetricsArena arena;
+    Metrics m {buy_and_hold_metrics(p, 1, {}, arena)};
+
+    EXPECT_DOUBLE_EQ(m.max_drawdown, 0);
+    EXPECT_EQ(m.sharpe, 0);
+    EXPECT_EQ(m.sortino, 0);
+    EXPECT_NEAR(m.cagr, (std::pow(1.001, 252) - 1) * 100, 1e-9);
+    EXPECT_NEAR(m.exposure, 100.0 * 252 / 253, 1e-9);
+}
+
+
+TEST(TestMetrics, LedgerAddsUpToTheBacktest) {
+    std::vector<double> p {random_walk(2000, 3)};
+    std::vector<std::uint8_t> mask(p.size());
+    std::mt19937 rng(5);
+    ExecutionModel execution;
+    MetricsArena arena;
+
+    execution.fee = 1;
+    execution.slippage_bps = 10;
+    execution.equity_percent = 50;
+    execution.delay = 1;
+
+    for (std::uint8_t& day : mask) day = (rng() % 10 < 6);
+
+    ExecutionModel long_short {execution};
+    long_short.shorts = true;
+
+    for (const ExecutionModel& model : {ExecutionModel {}, execution, long_short}) {
+        BacktestResult result {backtest_mask(p, 30, 5, mask.data(), model)};
+        Metrics m {compute_metrics(p, 30, 5, mask.data(), model, arena)};
+        double profit {0};
+
+        for (const Trade& t : arena.ledger) profit += t.pnl;
+
+        EXPECT_EQ(2 * m.trades, result.transactions);
+        EXPECT_NEAR(profit, result.profit, 1e-6);
+        EXPECT_NEAR(m.total_return, result.percent, 1e-9);
+        EXPECT_NEAR(arena.equity.back(), m.final_equity, 1e-9);
+    }
+}
+
+
+TEST(TestMetrics, ArenaIsReusedAcrossRuns) {
+    std::vector<double> p {random_walk(1000, 4)};
+    std::vector<std::uint8_t> mask(p.size());
+    MetricsArena arena;
+
+    for (std::size_t i = 0; i < mask.size(); i++) mask[i] = (i / 7) % 2;
+
+    Metrics first {compute_metrics(p, 0, 1, mask.data(), {}, arena)};
+    const double* equity = arena.equity.data();
+    const Trade* ledger = arena.ledger.data();
+
+    // a shorter run afterwards fits in the same buffers
+    compute_metrics(PriceView(p.data(), 500), 0, 1, mask.data(), {}, arena);
+    Metrics again {compute_metrics(p, 0, 1, mask.data(), {}, arena)};
+
+    EXPECT_EQ(arena.equity.data(), equity);
+    EXPECT_EQ(arena.ledger.data(), ledger);
+    EXPECT_EQ(again.sharpe, first.sharpe);
+    EXPECT_EQ(again.max_drawdown, first.max_drawdown);
+    EXPECT_EQ(again.final_equity, first.final_equity);
+}
+
+
+TEST(TestMetrics, NoTradesIsFlat) {
+    std::vector<double> p {random_walk(100, 6)};
+    std::vector<std::uint8_t> mask(p.size(), 0);
+    MetricsArena arena;
+
+    Metrics m {compute_metrics(p, 10, 1, mask.data(), {}, arena)};
+
+    EXPECT_EQ(m.trades, 0);
+    EXPECT_EQ(m.exposure, 0);
+    EXPECT_EQ(m.max_drawdown, 0);
+    EXPECT_EQ(m.total_return, 0);
+    EXPECT_EQ(m.sharpe, 0);
+}
@@ -0,0 +1,159 @@
+#include "../include/monte_carlo.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+static std::vector<double> wave() {
+    std::vector<double> p;
+
+    for (int i = 0; i < 300; i++) p.push_back(100 + 10 * std::sin(i / 7.0) + i * 0.05);
+
+    return p;
+}
+
+
+TEST(TestMonteCarlo, ParsesModels) {
+    EXPECT_EQ(parse_model("bootstrap"), PathModel::bootstrap);
+    EXPECT_EQ(parse_model("gbm"), PathModel::gbm);
+    EXPECT_THROW(parse_model("garch"), std::invalid_argument);
+}
+
+
+TEST(TestMonteCarlo, WholeSeriesBlockReproducesPrices) {
+    std::vector<double> p {wave()};
+    std::vector<double> path(p.size());
+    std::mt19937_64 rng(1);
+
+    // only one block of that length fits, so the resampled returns are the original ones in order
+    PathGenerator generator(p, PathModel::bootstrap, p.size());
+    generator.generate(rng, path.data());
+
+    for (std::size_t i = 0; i < p.size(); i++) EXPECT_NEAR(path[i], p[i], 1e-9);
+}
+
+
+TEST(TestMonteCarlo, FitsGbmToConstantGrowth) {
+    std::vector<double> p {100};
+
+    for (int i = 0; i < 50; i++) p.push_back(p.back() * 1.01);
+
+    PathGenerator generator(p, PathModel::gbm);
+    std::vector<double> path(p.size());
+    std::mt19937_64 rng(1);
+
+    EXPECT_NEAR(generator.get_drift(), std::log(1.01), 1e-12);
+    EXPECT_NEAR(generator.get_volatility(), 0, 1e-12);
+
+    generator.generate(rng, path.data());
+    EXPECT_NEAR(path.back(), p.back(), 1e-9);
+}
+
+
+TEST(TestMonteCarlo, RejectsInvalidSeries) {
+    std::vector<double> one {1};
+    std::vector<double> negative {1, -1, 2};
+
+    EXPECT_THROW(PathGenerator(one, PathModel::gbm), std::invalid_argument);
+    EXPECT_THROW(PathGenerator(negative, PathModel::gbm), std::invalid_argument);
+    EXPECT_THROW(PathGenerator(wave(), PathModel::bootstrap, 0), std::invalid_argument);
+}
+
+
+TEST(TestMonteCarlo, SummarizesSamples) {
+    std::vector<double> values {5, 1, 3, 2, 4};
+    Distribution d {summarize(values)};
+
+    EXPECT_DOUBLE_EQ(d.mean, 3);
+    EXPECT_DOUBLE_EQ(d.median, 3);
+    EXPECT_DOUBLE_EQ(d.min, 1);
+    EXPECT_DOUBLE_EQ(d.max, 5);
+    EXPECT_DOUBLE_EQ(d.p5, 1.2);
+    EXPECT_DOUBLE_EQ(d.stdev, std::sqrt(2.5));
+}
+
+
+TEST(TestMonteCarlo, StreamSummaryMatchesSortedSample) {
+    std::vector<double> values;
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> normal(10, 4);
+    SampleSummary summary(-10, 30);
+
+    for (int i = 0; i < 5000; i++) {
+        values.push_back(normal(rng));
+        summary.add(values.back());
+    }
+
+    Distribution exact {summarize(values)};
+    Distribution streamed {summary.distribution()};
+    double bin {40.0 / SampleSummary::SUMMARY_BINS};
+
+    EXPECT_EQ(summary.count(), 5000u);
+    EXPECT_NEAR(streamed.mean, exact.mean, 1e-9);
+    EXPECT_NEAR(streamed.stdev, exact.stdev, 1e-9);
+    EXPECT_DOUBLE_EQ(streamed.min, exact.min);
+    EXPECT_DOUBLE_EQ(streamed.max, exact.max);
+    EXPECT_NEAR(streamed.p5, exact.p5, bin);
+    EXPECT_NEAR(streamed.median, exact.median, bin);
+    EXPECT_NEAR(streamed.p95, exact.p95, bin);
+}
+
+
+TEST(TestMonteCarlo, StreamSummaryMergesAndKeepsOutliers) {
+    SampleSummary whole(0, 1);
+    SampleSummary left(0, 1);
+    SampleSummary right(0, 1);
+
+    // most values repeat, and a few fall far outside the range
+    for (int i = 0; i < 100; i++) {
+        double x = (i % 10 == 0) ? -50.0 + i : 0.5;
+
+        whole.add(x);
+        (i < 40 ? left : right).add(x);
+    }
+
+    left.merge(right);
+
+    Distribution merged {left.distribution()};
+    Distribution sequential {whole.distribution()};
+
+    EXPECT_EQ(left.count(), whole.count());
+    EXPECT_NEAR(merged.mean, sequential.mean, 1e-9);
+    EXPECT_NEAR(merged.stdev, sequential.stdev, 1e-9);
+    EXPECT_DOUBLE_EQ(merged.median, 0.5);
+    EXPECT_DOUBLE_EQ(merged.p95, sequential.p95);
+    EXPECT_DOUBLE_EQ(merged.min, -50);
+    EXPECT_DOUBLE_EQ(merged.max, 40);
+
+    EXPECT_THROW(SampleSummary(1, 1), std::invalid_argument);
+}
+
+
+TEST(TestMonteCarlo, SameSeedOnAnyNumberOfThreads) {
+    std::vector<double> p {wave()};
+    MonteCarloOptions options;
+    ThreadPool one(1);
+    ThreadPool three(3);
+
+    options.paths = 50;
+    options.batch = 8;
+
+    MonteCarloReport a {monte_carlo(p, 1, true, true, options, one)};
+    MonteCarloReport b {monte_carlo(p, 1, true, true, options, three)};
+
+    ASSERT_EQ(a.strategies.size(), 3u);
+    EXPECT_EQ(a.strategies[2].strategy, "Buy and hold");
+
+    for (std::size_t k = 0; k < a.strategies.size(); k++) {
+        EXPECT_EQ(a.strategies[k].profit.mean, b.strategies[k].profit.mean);
+        EXPECT_EQ(a.strategies[k].profit.p95, b.strategies[k].profit.p95);
+        EXPECT_EQ(a.strategies[k].transactions.mean, b.strategies[k].transactions.mean);
+    }
+
+    options.seed = 7;
+    MonteCarloReport c {monte_carlo(p, 1, true, true, options, one)};
+
+    EXPECT_NE(a.strategies[0].profit.mean, c.strategies[0].profit.mean);
+}
@@ -0,0 +1,111 @@
+#include "../include/portfolio.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+TEST(TestPortfolio, SingleSymbolMatchesPlainBacktest) {
+    std::vector<double> price {10, 12, 15, 9, 11};
+    std::vector<PortfolioInput> inputs(1);
+
+    inputs[0].ticker = "A";
+    inputs[0].price = price;
+    inputs[0].signal = {0, 1, 1, 0, 0};
+
+    PortfolioResult result {Portfolio(inputs, 1200).run()};
+
+    // 100 shares bought at 12 and sold at 9
+    EXPECT_EQ(result.trades, 2);
+    EXPECT_DOUBLE_EQ(result.final_equity, 900);
+    EXPECT_DOUBLE_EQ(result.pnl[0], -300);
+    EXPECT_DOUBLE_EQ(result.return_percent, -25);
+    EXPECT_DOUBLE_EQ(result.max_drawdown_percent, 40);
+}
+
+
+TEST(TestPortfolio, SharesCashEquallyAcrossSymbols) {
+    std::vector<double> a {10, 10, 20};
+    std::vector<double> b {5, 5, 5};
+    std::vector<PortfolioInput> inputs(2);
+
+    inputs[0] = {"A", a, {}, {1, 1, 1}};
+    inputs[1] = {"B", b, {}, {1, 1, 1}};
+
+    PortfolioResult result {Portfolio(inputs, 1000).run()};
+
+    // 500 in each: A doubles, B stays flat, open positions are marked to market
+    EXPECT_EQ(result.trades, 2);
+    EXPECT_DOUBLE_EQ(result.final_equity, 1500);
+    EXPECT_DOUBLE_EQ(result.pnl[0], 500);
+    EXPECT_DOUBLE_EQ(result.pnl[1], 0);
+}
+
+
+TEST(TestPortfolio, AlignsSymbolsByDate) {
+    std::vector<double> a {1, 2, 3};
+    std::vector<std::int64_t> a_dates {100, 200, 300};
+    std::vector<double> b {7, 8};
+    std::vector<std::int64_t> b_dates {200, 400};
+    std::vector<PortfolioInput> inputs(2);
+
+    inputs[0] = {"A", a, a_dates, {0, 0, 0}};
+    inputs[1] = {"B", b, b_dates, {0, 0}};
+
+    Portfolio portfolio(inputs, 100);
+
+    EXPECT_EQ(portfolio.get_symbols(), 2);
+    EXPECT_EQ(portfolio.get_days(), 4);
+}
+
+
+TEST(TestPortfolio, ClosesSymbolsWhoseDataEndsEarly) {
+    std::vector<double> a {10, 20, 30, 40};
+    std::vector<std::int64_t> a_dates {100, 200, 300, 400};
+    std::vector<double> b {10, 20};
+    std::vector<std::int64_t> b_dates {100, 200};
+    std::vector<PortfolioInput> inputs(2);
+
+    inputs[0] = {"A", a, a_dates, {0, 0, 1, 1}};
+    inputs[1] = {"B", b, b_dates, {1, 1}};
+
+    PortfolioResult result {Portfolio(inputs, 100).run()};
+
+    // B buys 50 at 10 and is sold at its last real bar (20); A then gets half of 150 at 30
+    EXPECT_EQ(result.trades, 3);
+    EXPECT_DOUBLE_EQ(result.pnl[1], 50);
+    EXPECT_DOUBLE_EQ(result.pnl[0], 25);
+    EXPECT_DOUBLE_EQ(result.equity[1], 150);
+    EXPECT_DOUBLE_EQ(result.final_equity, 175);
+}
+
+
+TEST(TestPortfolio, AlignsUndatedSymbolsAtTheEnd) {
+    std::vector<double> a {10, 10, 10, 20};
+    std::vector<double> b {10, 20};
+    std::vector<PortfolioInput> inputs(2);
+
+    inputs[0] = {"A", a, {}, {0, 0, 1, 1}};
+    inputs[1] = {"B", b, {}, {1, 1}};
+
+    PortfolioResult result {Portfolio(inputs, 100).run()};
+
+    // both buy on day 2 (B's first day) with 50 each
+    EXPECT_EQ(result.days, 4);
+    EXPECT_DOUBLE_EQ(result.pnl[0], 50);
+    EXPECT_DOUBLE_EQ(result.pnl[1], 50);
+}
+
+
+TEST(TestPortfolio, RejectsInvalidInput) {
+    std::vector<double> a {1, 2};
+    std::vector<PortfolioInput> inputs(1);
+
+    EXPECT_THROW(Portfolio({}, 100), std::invalid_argument);
+
+    inputs[0] = {"A", a, {}, {1}};
+    EXPECT_THROW(Portfolio(inputs, 100), std::invalid_argument);
+
+    inputs[0].signal = {1, 1};
+    EXPECT_THROW(Portfolio(inputs, 0), std::invalid_argument);
+}
@@ -0,0 +1,262 @@
+#include "../include/precision.h"
+#include "../include/RSI.h"
+#include "../include/SMA.h"
+#include "../include/series_cache.h"
+#include "../include/rolling.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+// a random walk on whole cents, so every precision stores exactly the same prices
+static std::vector<double> cent_walk(int n, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 1.0);
+    std::vector<double> p(n);
+    double price {100.0};
+
+    for (int i = 0; i < n; i++) {
+        price = std::max(1.0, price + step(rng));
+        p[i] = std::round(price * 100) / 100;
+    }
+
+    return p;
+}
+
+
+TEST(TestPrecision, ConvertsPrices) {
+    std::vector<double> p {12.34, 0.005, -1.5, 99.999};
+
+    EXPECT_EQ(to_precision<Cents>(p), (std::vector<Cents> {1234, 1, -150, 10000}));
+    EXPECT_EQ(to_precision<float>(p), (std::vector<float> {12.34f, 0.005f, -1.5f, 99.999f}));
+    EXPECT_DOUBLE_EQ(to_double<Cents>(1234), 12.34);
+
+    for (double bad : {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity()}) {
+        std::vector<double> invalid {1.0, bad};
+
+        EXPECT_THROW(to_precision<float>(invalid), std::invalid_argument);
+        EXPECT_THROW(to_precision<Cents>(invalid), std::invalid_argument);
+    }
+
+    std::vector<double> huge {2 * MAX_CENTS_PRICE};
+
+    EXPECT_THROW(to_precision<Cents>(huge), std::invalid_argument);
+    EXPECT_NO_THROW(to_precision<float>(huge));
+}
+
+
+TEST(TestPrecision, GreaterMaskMatchesScalarCompare) {
+    std::vector<double> a {cent_walk(101, 1)};
+    std::vector<double> b {cent_walk(101, 2)};
+    std::vector<float> fa {to_precision<float>(a)};
+    std::vector<float> fb {to_precision<float>(b)};
+    std::vector<Cents> ca {to_precision<Cents>(a)};
+    std::vector<Cents> cb {to_precision<Cents>(b)};
+    std::vector<std::uint8_t> floats(a.size(), 7);
+    std::vector<std::uint8_t> cents(a.size(), 7);
+
+    greater_mask(fa.data(), fb.data(), 3, a.size(), floats.data());
+    greater_mask(ca.data(), cb.data(), 3, a.size(), cents.data());
+
+    EXPECT_EQ(floats[2], 7);
+    EXPECT_EQ(cents[2], 7);
+
+    for (std::size_t i = 3; i < a.size(); i++) {
+        EXPECT_EQ(floats[i], fa[i] > fb[i]);
+        EXPECT_EQ(cents[i], ca[i] > cb[i]);
+    }
+
+    std::vector<float> signs {-1, 2, 0, 3, -4, 5, 6, -7, 8, 0.5f};
+
+    greater_mask(signs.data(), nullptr, 0, signs.size(), floats.data());
+
+    for (std::size_t i = 0; i < signs.size(); i++) EXPECT_EQ(floats[i], signs[i] > 0);
+}
+
+
+TEST(TestPrecision, MeansAndEmasTrackDouble) {
+    std::vector<double> p {cent_walk(3000, 3)};
+    std::vector<float> floats {to_precision<float>(p)};
+    std::vector<Cents> cents {to_precision<Cents>(p)};
+    std::vector<double> mean {rolling_mean(p, 20)};
+    std::vector<float> float_mean {precision_mean<float>(floats, 20)};
+    std::vector<Cents> cent_mean {precision_mean<Cents>(cents, 20)};
+
+    ASSERT_EQ(float_mean.size(), mean.size());
+    EXPECT_EQ(float_mean[19], 0.0f);
+
+    for (std::size_t day = 20; day < mean.size(); day++) {
+        EXPECT_NEAR(float_mean[day], mean[day], 1e-4 * mean[day]);
+
+        // exact window sums of whole cents, rounded once
+        Cents sum {0};
+
+        for (std::size_t i = day - 20; i < day; i++) sum += cents[i];
+
+        EXPECT_EQ(cent_mean[day], (sum + 10) / 20);
+    }
+
+    std::vector<double> ema {ema_series(p, 26)};
+    std::vector<float> float_ema {precision_ema<float>(floats, 26)};
+    std::vector<Cents> cent_ema {precision_ema<Cents>(cents, 26)};
+
+    for (std::size_t day = 25; day < p.size(); day++) {
+        EXPECT_NEAR(float_ema[day], ema[day], 1e-4 * ema[day]);
+        EXPECT_NEAR(to_double(cent_ema[day]), ema[day], 0.1);
+    }
+
+    EXPECT_THROW(precision_ema<float>(floats, 0), std::invalid_argument);
+    EXPECT_THROW(precision_mean<Cents>(cents, 0), std::invalid_argument);
+}
+
+
+TEST(TestPrecision, MacdLinesTrackDouble) {
+    std::vector<double> p {cent_walk(2000, 4)};
+    std::vector<float> floats {to_precision<float>(p)};
+    std::vector<Cents> cents {to_precision<Cents>(p)};
+
+    for (MACD::Crossover mode : {MACD::Crossover::zero_line, MACD::Crossover::signal_line}) {
+        MACD macd(p, 12, 26, 9, mode);
+        std::vector<float> float_line {precision_macd<float>(floats, 12, 26, 9, mode)};
+        std::vector<Cents> cent_line {precision_macd<Cents>(cents, 12, 26, 9, mode)};
+
+        for (int day = macd.first_signal_day(); day < static_cast<int>(p.size()); day++) {
+            EXPECT_NEAR(float_line[day], macd.signal().line[day], 1e-3);
+            EXPECT_NEAR(to_double(cent_line[day]), macd.signal().line[day], 0.2);
+        }
+    }
+
+    std::vector<float> short_series(floats.begin(), floats.begin() + 30);
+
+    EXPECT_THROW(precision_macd<float>(short_series, 12, 26, 9, MACD::Crossover::signal_line), std::invalid_argument);
+    EXPECT_NO_THROW(precision_macd<float>(short_series, 12, 26, 9, MACD::Crossover::zero_line));
+}
+
+
+TEST(TestPrecision, BacktestMatchesDoubleOnTheSameTrades) {
+    std::vector<double> p {cent_walk(1500, 5)};
+    std::vector<float> floats {to_precision<float>(p)};
+    std::vector<Cents> cents {to_precision<Cents>(p)};
+    std::mt19937 rng(6);
+    std::vector<std::uint8_t> mask(p.size());
+
+    for (auto& m : mask) m = (rng() % 10 < 5);
+
+    for (int start : {0, 200, 1499}) {
+        BacktestResult expected {backtest_mask(p, start, 3, mask.data())};
+        BacktestResult exact {precision_backtest<Cents>(cents, start, 3, mask.data())};
+        BacktestResult single {precision_backtest<float>(floats, start, 3, mask.data())};
+
+        EXPECT_EQ(exact.transactions, expected.transactions);
+        EXPECT_EQ(single.transactions, expected.transactions);
+        EXPECT_NEAR(exact.profit, expected.profit, 1e-6);
+        EXPECT_NEAR(single.profit, expected.profit, 0.01);
+    }
+
+    // exact whole cents, where a double sum of 0.1s is not
+    std::vector<double> dimes {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8};
+    std::vector<std::uint8_t> alternate {1, 0, 1, 0, 1, 0, 1, 0};
+
+    EXPECT_EQ(precision_backtest<Cents>(to_precision<Cents>(dimes), 0, 1, alternate.data()).profit, 0.4);
+    EXPECT_NE(backtest_mask(dimes, 0, 1, alternate.data()).profit, 0.4);
+}
+
+
+TEST(TestPrecision, ValidatesAgainstDouble) {
+    std::vector<double> p {cent_walk(3000, 7)};
+    auto sma = std::make_shared<SMA>(p, 50, 200);
+    auto macd = std::make_shared<MACD>(p, 12, 26, 9, MACD::Crossover::signal_line);
+    std::vector<PrecisionCheck> checks {validate_precision(p, 2, {{"SMA", sma, 1}, {"MACD", macd, 1}})};
+
+    ASSERT_EQ(checks.size(), 4u);
+    EXPECT_EQ(checks[0].strategy, "SMA 50/200");
+    EXPECT_EQ(checks[0].precision, "float");
+    EXPECT_EQ(checks[1].precision, "cents");
+    EXPECT_EQ(checks[2].strategy, "MACD 12/26/9");
+    EXPECT_EQ(checks[0].bytes, 4);
+    EXPECT_EQ(checks[1].bytes, 8);
+
+    BacktestResult baseline {backtest_vectorized(p, sma->first_signal_day(), 2, sma->signal())};
+
+    EXPECT_EQ(checks[0].days, 3000 - 200);
+    EXPECT_EQ(checks[0].baseline.profit, baseline.profit);
+    EXPECT_EQ(checks[1].baseline.profit, baseline.profit);
+
+    for (const PrecisionCheck& c : checks) {
+        EXPECT_GE(c.agreement(), 99.0) << c.strategy << " " << c.precision;
+        EXPECT_LT(c.max_error, 0.2) << c.strategy << " " << c.precision;
+        EXPECT_EQ(c.first_mismatch < 0, c.mismatches == 0);
+
+        // the same decisions trade the same (whole-cent) prices
+        if (c.mismatches == 0) {
+            EXPECT_NEAR(c.result.profit, c.baseline.profit, 0.01);
+        }
+    }
+
+    // the periods of the strategies given
+    std::vector<PrecisionCheck> custom {validate_precision(p, 2, {{"SMA", std::make_shared<SMA>(p, 20, 60), 1}})};
+
+    ASSERT_EQ(custom.size(), 2u);
+    EXPECT_EQ(custom[0].strategy, "SMA 20/60");
+    EXPECT_EQ(custom[0].days, 3000 - 60);
+
+    std::vector<double> other {cent_walk(3000, 8)};
+    SeriesCache cache {close_only(p)};
+
+    EXPECT_THROW(validate_precision(p, 2, {{"RSI", std::make_shared<RSI>(cache), 1}}), std::invalid_argument);
+    EXPECT_THROW(validate_precision(p, 2, {{"SMA", std::make_shared<SMA>(other, 20, 60), 1}}), std::invalid_argument);
+}
+
+
+TEST(TestPrecision, RunsOnReducedStores) {
+    std::vector<double> p {cent_walk(3000, 9)};
+    std::vector<StrategyEntry> strategies {{"SMA", std::make_shared<SMA>(p, 20, 60), 2},
+                                           {"MACD", std::make_shared<MACD>(p, 12, 26, 9, MACD::Crossover::signal_line), 1}};
+    Simulator sim(strategies, p);
+    PrecisionRun<Cents> cents(strategies, p);
+    PrecisionRun<float> floats(strategies, p);
+
+    sim.set_vote({0.5, -0.5});
+    cents.set_vote({0.5, -0.5});
+    floats.set_vote({0.5, -0.5});
+
+    IndicatorReport expected {sim.indicator_report()};
+
+    for (const IndicatorReport& report : {cents.indicator_report(), floats.indicator_report()}) {
+        ASSERT_EQ(report.signals.size(), 2u);
+        EXPECT_EQ(report.signals[0].short_term, 20);
+        EXPECT_EQ(report.signals[1].signal_term, 9);
+        EXPECT_EQ(report.signals[1].crossover, "signal");
+        EXPECT_EQ(report.signals[0].buy, expected.signals[0].buy);
+        EXPECT_EQ(report.signals[1].buy, expected.signals[1].buy);
+        EXPECT_EQ(report.recommendation, expected.recommendation);
+    }
+
+    BacktestReport baseline {sim.backtest_report(3)};
+    BacktestReport exact {cents.backtest_report(3)};
+    BacktestReport single {floats.backtest_report(3)};
+
+    // SMA, MACD and the vote, then buy and hold, all trading the whole-cent prices of the store
+    ASSERT_EQ(exact.strategies.size(), 3u);
+    ASSERT_EQ(single.strategies.size(), 3u);
+    EXPECT_EQ(exact.strategies[2].strategy, "Vote");
+    EXPECT_NEAR(exact.buy_and_hold.profit, baseline.buy_and_hold.profit, 1e-6);
+    EXPECT_DOUBLE_EQ(exact.first_price, p.front());
+    EXPECT_DOUBLE_EQ(exact.last_price, p.back());
+
+    for (std::size_t k = 0; k < 3; k++) {
+        // cents averages round, so an SMA or MACD can flip on the closest days
+        EXPECT_NEAR(exact.strategies[k].result.transactions, baseline.strategies[k].result.transactions, 4);
+        EXPECT_NEAR(single.strategies[k].result.transactions, baseline.strategies[k].result.transactions, 4);
+    }
+
+    SeriesCache cache {close_only(p)};
+
+    EXPECT_THROW(PrecisionRun<float>({{"RSI", std::make_shared<RSI>(cache), 1}}, p), std::invalid_argument);
+    EXPECT_THROW(PrecisionRun<float>({}, p), std::invalid_argument);
+}
@@ -0,0 +1,90 @@
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "../test_data/"
+#endif
+
+
+#include "../include/price_cache.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+
+static const std::string csv_file {std::string(TEST_DATA_DIR) + "cache_data.csv"};
+
+
+static void write_csv(int rows) {
+    std::ofstream out(csv_file, std::ios::trunc);
+
+    out << "Date,Open,High,Low,Close,Volume\n";
+
+    for (int i = 0; i < rows; i++) out << "2025-01-0" << i + 1 << " 00:00:00-05:00," << 9 + i << ",11,8," << 10 + i << ",5\n";
+}
+
+
+TEST(TestPriceCache, WritesCacheOnFirstRead) {
+    write_csv(3);
+    std::remove(cache_path(csv_file).c_str());
+
+    PriceSeries parsed {load_prices(csv_file)};
+    PriceSeries cached {load_prices(csv_file)};
+
+    EXPECT_FALSE(parsed.is_cached());
+    EXPECT_TRUE(cached.is_cached());
+    ASSERT_EQ(cached.prices().size(), 3u);
+    EXPECT_DOUBLE_EQ(cached.prices()[2], 12.0);
+
+    // 2025-01-01 00:00:00-05:00 == 2025-01-01 05:00:00 UTC
+    ASSERT_TRUE(cached.has_timestamps());
+    EXPECT_EQ(cached.timestamps()[0], 1735707600);
+    EXPECT_EQ(cached.timestamps()[1] - cached.timestamps()[0], 86400);
+}
+
+
+TEST(TestPriceCache, CachesBarColumns) {
+    write_csv(3);
+    std::remove(cache_path(csv_file).c_str());
+    load_prices(csv_file);
+
+    PriceSeries cached {load_prices(csv_file)};
+    const BarsView& bars = cached.bars();
+
+    ASSERT_TRUE(cached.is_cached());
+    ASSERT_TRUE(bars.has_ohlc());
+    ASSERT_TRUE(bars.has_volume());
+    EXPECT_DOUBLE_EQ(bars.open[2], 11.0);
+    EXPECT_DOUBLE_EQ(bars.high[0], 11.0);
+    EXPECT_DOUBLE_EQ(bars.low[1], 8.0);
+    EXPECT_DOUBLE_EQ(bars.close[2], 12.0);
+    EXPECT_DOUBLE_EQ(bars.volume[0], 5.0);
+}
+
+
+TEST(TestPriceCache, InvalidatesWhenSourceChanges) {
+    write_csv(3);
+    load_prices(csv_file);
+
+    write_csv(5);
+
+    PriceSeries reloaded {load_prices(csv_file)};
+
+    EXPECT_FALSE(reloaded.is_cached());
+    EXPECT_EQ(reloaded.prices().size(), 5u);
+    EXPECT_TRUE(load_prices(csv_file).is_cached());
+}
+
+
+TEST(TestPriceCache, CanBeDisabled) {
+    write_csv(2);
+    std::remove(cache_path(csv_file).c_str());
+
+    EXPECT_FALSE(load_prices(csv_file, false).is_cached());
+    EXPECT_FALSE(load_prices(csv_file, false).is_cached());
+
+    std::remove(csv_file.c_str());
+}
+
+
+TEST(TestPriceCache, MissingSourceStillFails) {
+    EXPECT_THROW(load_prices(std::string(TEST_DATA_DIR) + "invalid_name.csv"), std::runtime_error);
+}
@@ -0,0 +1,93 @@
+#include "../include/profile.h"
+#include "../include/util.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "../test_data/"
+#endif
+
+
+TEST(TestProfile, SummarizesStagesInStartOrder) {
+    Profiler& profiler = Profiler::instance();
+
+    profiler.enable();
+    profiler.record("load", 0, 2000000);
+    profiler.record("inner", 500000, 1000000);
+    profiler.record("load", 3000000, 7000000);
+    profiler.disable();
+
+    std::vector<StageSummary> stages {profiler.summary()};
+
+    ASSERT_EQ(stages.size(), 2u);
+    EXPECT_EQ(stages[0].stage, "load");
+    EXPECT_EQ(stages[0].calls, 2);
+    EXPECT_DOUBLE_EQ(stages[0].total_ms, 6);
+    EXPECT_DOUBLE_EQ(stages[0].max_ms, 4);
+    EXPECT_EQ(stages[1].stage, "inner");
+    EXPECT_DOUBLE_EQ(stages[1].total_ms, 0.5);
+}
+
+
+TEST(TestProfile, TimesOnlyWhileEnabled) {
+    Profiler& profiler = Profiler::instance();
+
+    profiler.enable();
+    profiler.disable();
+
+    { ScopedTimer timer("ignored"); }
+
+    EXPECT_TRUE(profiler.get_events().empty());
+
+    profiler.enable();
+
+    {
+        ScopedTimer timer("stage");
+        timer.stop();
+    }
+
+    profiler.disable();
+
+    ASSERT_EQ(profiler.get_events().size(), 1u);
+    EXPECT_GE(profiler.get_events()[0].duration_ns, 0);
+}
+
+
+// the library is built with the instrumentation in or out, like the tests
+TEST(TestProfile, CountsParsedBytesAndRows) {
+    Profiler& profiler = Profiler::instance();
+    std::string file {std::string(TEST_DATA_DIR) + "valid_data.csv"};
+
+    if (!PROFILING_BUILT_IN) GTEST_SKIP() << "built with PROFILE=0";
+
+    profiler.enable();
+    std::vector<double> prices {read_file(file)};
+    profiler.disable();
+
+    EXPECT_EQ(profiler.count(Counter::bytes_parsed), std::filesystem::file_size(file));
+    EXPECT_EQ(profiler.count(Counter::rows), prices.size());
+    EXPECT_EQ(profiler.summary().at(0).stage, "parse csv");
+}
+
+
+TEST(TestProfile, WritesChromeTrace) {
+    Profiler& profiler = Profiler::instance();
+    std::ostringstream trace;
+    std::ostringstream report;
+
+    profiler.enable();
+    profiler.record("backtest", 1000, 5000);
+    profiler.add(Counter::trades, 3);
+    profiler.disable();
+
+    profiler.write_trace(trace);
+    profiler.write_report(report);
+
+    EXPECT_NE(trace.str().find("{\"traceEvents\":["), std::string::npos);
+    EXPECT_NE(trace.str().find("{\"name\":\"backtest\",\"cat\":\"stage\",\"ph\":\"X\",\"ts\":1,\"dur\":4,"), std::string::npos);
+    EXPECT_NE(trace.str().find("\"trades\":3"), std::string::npos);
+    EXPECT_NE(report.str().find(" trades: 3"), std::string::npos);
+}
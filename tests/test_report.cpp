@@ -0,0 +1,154 @@
+#include "../include/report.h"
+#include "../include/simulator.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+static std::vector<double> data = {1.0, 1.0, 1.0, 100.0, 1.0};
+
+
+static RunReport sample_run() {
+    SMA sma(data, 1, 2);
+    MACD macd(data, 1, 2);
+    Simulator sim(sma, macd, data);
+    RunReport report;
+
+    report.ticker = "TEST";
+    report.current_price = 1;
+    report.days = data.size();
+    report.stocks = 2;
+    report.indicator = sim.indicator_report();
+    report.backtest = sim.backtest_report(2);
+
+    return report;
+}
+
+
+TEST(TestReport, ParsesFormats) {
+    EXPECT_EQ(parse_format("text"), OutputFormat::text);
+    EXPECT_EQ(parse_format("json"), OutputFormat::json);
+    EXPECT_EQ(parse_format("csv"), OutputFormat::csv);
+    EXPECT_THROW(parse_format("xml"), std::invalid_argument);
+}
+
+
+TEST(TestReport, SimulatorFillsReports) {
+    RunReport report {sample_run()};
+
+    ASSERT_EQ(report.indicator->signals.size(), 2u);
+    EXPECT_EQ(report.indicator->signals[0].strategy, "SMA");
+    EXPECT_EQ(report.indicator->signals[1].crossover, "zero");
+
+    ASSERT_EQ(report.backtest->strategies.size(), 2u);
+    EXPECT_EQ(report.backtest->stocks, 2);
+    EXPECT_DOUBLE_EQ(report.backtest->first_price, 1.0);
+    EXPECT_EQ(report.backtest->buy_and_hold.transactions, 2);
+}
+
+
+TEST(TestReport, RecommendationLabels) {
+    // unanimous among several strategies
+    EXPECT_EQ(recommendation_label(1, 0, 0, 2), "STRONG BUY");
+    EXPECT_EQ(recommendation_label(-1, 0, 0, 3), "STRONG SELL");
+    EXPECT_EQ(recommendation_label(0, 0, 0, 2), "MIXED SIGNAL");
+
+    // a single strategy's signal is still a recommendation
+    EXPECT_EQ(recommendation_label(1, 0, 0, 1), "BUY");
+    EXPECT_EQ(recommendation_label(-1, 0, 0, 1), "SELL");
+
+    // weighted scores against the thresholds
+    EXPECT_EQ(recommendation_label(0.5, 0.25, -0.25, 3), "BUY");
+    EXPECT_EQ(recommendation_label(0.2, 0.25, -0.25, 3), "MIXED SIGNAL");
+    EXPECT_EQ(recommendation_label(-0.5, 0.25, -0.25, 3), "SELL");
+}
+
+
+TEST(TestReport, FormatsRunAsJson) {
+    std::string json {format_run(sample_run(), OutputFormat::json)};
+
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '\n');
+    EXPECT_NE(json.find("\"ticker\":\"TEST\""), std::string::npos);
+    EXPECT_NE(json.find("\"strategy\":\"MACD\""), std::string::npos);
+    EXPECT_NE(json.find("\"buy_and_hold\":{\"first_price\":1,\"last_price\":1,"), std::string::npos);
+    EXPECT_EQ(json.find("\033"), std::string::npos);
+}
+
+
+TEST(TestReport, FormatsRunAsCsv) {
+    std::string csv {format_run(sample_run(), OutputFormat::csv)};
+
+    EXPECT_EQ(csv.rfind("ticker,strategy,short_term,long_term,signal,transactions,profit,percent\n", 0), 0u);
+    EXPECT_NE(csv.find("\nTEST,SMA,1,2,"), std::string::npos);
+    EXPECT_NE(csv.find("\nTEST,Buy and hold,,,,2,0,0\n"), std::string::npos);
+}
+
+
+TEST(TestReport, PairsCsvRowsBySignalOrder) {
+    SMA fast(data, 1, 2);
+    SMA slow(data, 2, 3);
+    Simulator sim({{"SMA", std::make_shared<SMA>(fast)}, {"SMA", std::make_shared<SMA>(slow)}}, data);
+    RunReport report;
+
+    report.ticker = "TEST";
+    report.indicator = sim.indicator_report();
+    report.backtest = sim.backtest_report(2);
+
+    std::string csv {format_run(report, OutputFormat::csv)};
+    std::size_t first {csv.find("\nTEST,SMA,1,2,")};
+
+    ASSERT_NE(first, std::string::npos);
+    EXPECT_NE(csv.find("\nTEST,SMA,2,3,", first), std::string::npos);
+}
+
+
+TEST(TestReport, FormatsBatchWithErrors) {
+    std::vector<BatchReport> reports(2);
+
+    reports[0].ticker = "A";
+    reports[0].sma_on = true;
+    reports[0].sma = {2, 5, 50};
+    reports[0].bnh = {2, 1, std::nan("")};
+    reports[1].ticker = "B";
+    reports[1].path = "b,c.csv";
+    reports[1].error = "no \"data\"";
+
+    std::string json {format_batch(reports, OutputFormat::json)};
+    std::string csv {format_batch(reports, OutputFormat::csv)};
+
+    EXPECT_NE(json.find("\"sma\":{\"transactions\":2,\"profit\":5,\"percent\":50}"), std::string::npos);
+    EXPECT_NE(json.find("\"macd\":null"), std::string::npos);
+    EXPECT_NE(json.find("\"percent\":null"), std::string::npos);
+    EXPECT_NE(json.find("\"error\":\"no \\\"data\\\"\""), std::string::npos);
+
+    EXPECT_NE(csv.find("\nA,,,0,2,5,50,,,,2,1,,\n"), std::string::npos);
+    EXPECT_NE(csv.find("\nB,,\"b,c.csv\",0,,,,,,,,,,\"no \"\"data\"\"\"\n"), std::string::npos);
+}
+
+
+TEST(TestReport, DescribesExecutionModel) {
+    ExecutionModel execution;
+
+    EXPECT_EQ(describe_execution(execution), "frictionless");
+
+    execution.fee = 1;
+    execution.slippage_bps = 5;
+    execution.delay = 1;
+    EXPECT_EQ(describe_execution(execution), "$1 fee, 5 bps slippage, next-bar fills");
+
+    ExecutionModel long_short;
+    long_short.shorts = true;
+    EXPECT_EQ(describe_execution(long_short), "long / short");
+
+    RunReport report {sample_run()};
+    report.backtest->execution = execution;
+
+    EXPECT_NE(format_run(report, OutputFormat::json).find("\"execution\":{\"fee\":1,\"slippage_bps\":5,"), std::string::npos);
+    EXPECT_NE(format_run(report, OutputFormat::text).find("Note: dividends have not"), std::string::npos);
+    EXPECT_NE(format_run(report, OutputFormat::json).find("\"delay\":1,\"shorts\":false}"), std::string::npos);
+    EXPECT_EQ(format_run(sample_run(), OutputFormat::json).find("\"execution\""), std::string::npos);
+}
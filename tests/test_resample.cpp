@@ -0,0 +1,123 @@
+#include "../include/resample.h"
+#include "../include/series_cache.h"
+#include "../include/util.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+static std::int64_t at(const std::string& text) {
+    std::int64_t seconds {0};
+
+    EXPECT_TRUE(parse_timestamp(text, seconds)) << text;
+
+    return seconds;
+}
+
+
+TEST(TestResample, ParsesTimeframes) {
+    EXPECT_EQ(parse_timeframe("weekly").unit, Timeframe::Unit::week);
+    EXPECT_EQ(parse_timeframe("monthly").unit, Timeframe::Unit::month);
+    EXPECT_EQ(parse_timeframe("15min").count, 15);
+    EXPECT_EQ(parse_timeframe("4h").count, 240);
+
+    for (const char* name : {"daily", "weekly", "monthly", "15min", "4h", "90min"}) {
+        EXPECT_EQ(timeframe_name(parse_timeframe(name)), name);
+    }
+
+    for (const char* name : {"", "week", "0min", "-5min", "15", "15m", "weekly2"}) {
+        EXPECT_THROW(parse_timeframe(name), std::invalid_argument) << name;
+    }
+}
+
+
+TEST(TestResample, BucketsByCalendar) {
+    Timeframe week {parse_timeframe("weekly")};
+    Timeframe month {parse_timeframe("monthly")};
+    Timeframe quarter_hour {parse_timeframe("15min")};
+
+    // weeks run Monday to Sunday
+    EXPECT_EQ(timeframe_bucket(at("2025-01-06"), week), timeframe_bucket(at("2025-01-12 23:59:59"), week));
+    EXPECT_EQ(timeframe_bucket(at("2025-01-13"), week), timeframe_bucket(at("2025-01-12"), week) + 1);
+
+    EXPECT_EQ(timeframe_bucket(at("1970-01-31"), month), 0);
+    EXPECT_EQ(timeframe_bucket(at("2024-02-29"), month), 54 * 12 + 1);
+    EXPECT_EQ(timeframe_bucket(at("2025-03-01"), month), timeframe_bucket(at("2025-02-28"), month) + 1);
+    EXPECT_EQ(timeframe_bucket(at("1969-12-31 23:00:00"), month), -1);
+
+    EXPECT_EQ(timeframe_bucket(at("2025-01-02 14:44:59"), quarter_hour), timeframe_bucket(at("2025-01-02 14:30:00"), quarter_hour));
+    EXPECT_NE(timeframe_bucket(at("2025-01-02 14:45:00"), quarter_hour), timeframe_bucket(at("2025-01-02 14:44:59"), quarter_hour));
+}
+
+
+TEST(TestResample, AggregatesBarsInOnePass) {
+    std::vector<double> open = {10, 11, 12, 13, 14, 15, 16};
+    std::vector<double> high = {12, 14, 13, 15, 16, 17, 18};
+    std::vector<double> low = {9, 10, 8, 12, 13, 14, 15};
+    std::vector<double> close = {11, 12, 13, 14, 15, 16, 17};
+    std::vector<double> volume = {100, 200, 300, 400, 500, 600, 700};
+    std::vector<std::int64_t> timestamps;
+
+    // Thursday to Tuesday, over a weekend and a month end
+    for (const char* day : {"2025-01-30", "2025-01-31", "2025-02-03", "2025-02-04", "2025-02-05", "2025-02-10", "2025-02-11"}) {
+        timestamps.push_back(at(day));
+    }
+
+    BarsView bars {open, high, low, close, volume, timestamps};
+    ResampledBars weekly {resample(bars, parse_timeframe("weekly"))};
+
+    EXPECT_EQ(weekly.ends, (std::vector<int> {2, 5, 7}));
+    EXPECT_EQ(weekly.bars.open, (std::vector<double> {10, 12, 15}));
+    EXPECT_EQ(weekly.bars.high, (std::vector<double> {14, 16, 18}));
+    EXPECT_EQ(weekly.bars.low, (std::vector<double> {9, 8, 14}));
+    EXPECT_EQ(weekly.bars.close, (std::vector<double> {12, 15, 17}));
+    EXPECT_EQ(weekly.bars.volume, (std::vector<double> {300, 1200, 1300}));
+    EXPECT_EQ(weekly.bars.timestamps, (std::vector<std::int64_t> {timestamps[0], timestamps[2], timestamps[5]}));
+}
+
+
+TEST(TestResample, CloseOnlyAndInvalidSources) {
+    std::vector<double> close = {1, 2, 3, 4};
+    std::vector<std::int64_t> timestamps = {at("2025-01-30"), at("2025-01-31"), at("2025-02-03"), at("2025-02-04")};
+    BarsView bars {{}, {}, {}, close, {}, timestamps};
+    ResampledBars monthly {resample(bars, parse_timeframe("monthly"))};
+
+    EXPECT_EQ(monthly.bars.close, (std::vector<double> {2, 4}));
+    EXPECT_EQ(monthly.ends, (std::vector<int> {2, 4}));
+    EXPECT_TRUE(monthly.bars.open.empty());
+    EXPECT_TRUE(monthly.bars.volume.empty());
+
+    // no Date column, or dates going back
+    EXPECT_THROW(resample(close_only(close), parse_timeframe("weekly")), std::invalid_argument);
+
+    std::swap(timestamps[1], timestamps[2]);
+
+    EXPECT_THROW(resample(bars, parse_timeframe("weekly")), std::invalid_argument);
+    EXPECT_TRUE(resample(BarsView {}, parse_timeframe("weekly")).ends.empty());
+}
+
+
+TEST(TestResample, SeriesCacheSharesTimeframes) {
+    std::vector<double> close;
+    std::vector<std::int64_t> timestamps;
+
+    for (int i = 0; i < 30; i++) {
+        close.push_back(100 + i);
+        timestamps.push_back(at("2025-01-06") + i * 86400);
+    }
+
+    SeriesCache cache {{{}, {}, {}, close, {}, timestamps}};
+    TimeframeSeries& weekly = cache.timeframe(parse_timeframe("weekly"));
+
+    EXPECT_EQ(&weekly, &cache.timeframe(parse_timeframe("weekly")));
+    EXPECT_NE(&weekly, &cache.timeframe(parse_timeframe("monthly")));
+    EXPECT_EQ(weekly.cache.size(), 5);
+
+    // weekly closes are every Sunday's close (the last day of each week), then the partial week
+    EXPECT_EQ(weekly.cache.mean(Source::close, 2)[2], (106 + 113) / 2.0);
+    EXPECT_EQ(weekly.cache.computed(), 1);
+    EXPECT_EQ(cache.computed(), 0);
+}
@@ -0,0 +1,188 @@
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "../test_data/"
+#endif
+
+
+#include "../include/result_cache.h"
+#include "../include/resample.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+static const std::string cache_dir {std::string(TEST_DATA_DIR) + "results"};
+
+
+static std::vector<double> wave(int n) {
+    std::vector<double> p;
+
+    for (int i = 0; i < n; i++) p.push_back(100 + 8 * std::sin(i / 9.0) + i * 0.05);
+
+    return p;
+}
+
+static ResultCache fresh_cache() {
+    std::filesystem::remove_all(cache_dir);
+
+    return ResultCache {cache_dir};
+}
+
+
+TEST(TestResultCache, HashesContent) {
+    std::vector<double> p {wave(100)};
+    std::vector<double> q {p};
+
+    EXPECT_EQ(hash_bars(close_only(p)), hash_bars(close_only(q)));
+    EXPECT_EQ(hash_bars(close_only(p), 60), hash_bars(close_only(std::vector<double>(p.begin(), p.begin() + 60))));
+    EXPECT_NE(hash_bars(close_only(p), 60), hash_bars(close_only(p)));
+
+    q[37] += 0.01;
+
+    EXPECT_NE(hash_bars(close_only(p)), hash_bars(close_only(q)));
+}
+
+
+TEST(TestResultCache, StoresAndFindsResults) {
+    ResultCache cache {fresh_cache()};
+
+    EXPECT_FALSE(cache.find(1, "run\n-t=MSFT").has_value());
+
+    cache.store(1, "run\n-t=MSFT", "answer");
+
+    EXPECT_EQ(cache.find(1, "run\n-t=MSFT"), std::optional<std::string> {"answer"});
+    EXPECT_FALSE(cache.find(2, "run\n-t=MSFT").has_value());
+    EXPECT_FALSE(cache.find(1, "run\n-t=AAPL").has_value());
+
+    // a new cache on the same directory sees the same entries
+    EXPECT_EQ(ResultCache {cache_dir}.find(1, "run\n-t=MSFT"), std::optional<std::string> {"answer"});
+}
+
+
+TEST(TestResultCache, RecordsSourceStamps) {
+    ResultCache cache {fresh_cache()};
+    std::string csv {std::string(TEST_DATA_DIR) + "valid_data.csv"};
+    std::optional<SourceStamp> now {stat_source(csv)};
+
+    ASSERT_TRUE(now.has_value());
+    EXPECT_GT(now->size, 0u);
+    EXPECT_FALSE(cache.source(csv).has_value());
+    EXPECT_FALSE(stat_source(cache_dir + "/missing.csv").has_value());
+
+    now->rows = 5;
+    now->hash = 42;
+    cache.record(csv, *now);
+
+    std::optional<SourceStamp> known {cache.source(csv)};
+
+    ASSERT_TRUE(known.has_value());
+    EXPECT_TRUE(known->same_file(*stat_source(csv)));
+    EXPECT_EQ(known->rows, 5u);
+    EXPECT_EQ(known->hash, 42u);
+}
+
+
+TEST(TestResultCache, SavesAndRestoresIndicatorState) {
+    std::vector<double> p {wave(300)};
+    StreamingSMA sma(5, 20);
+    StreamingMACD macd(6, 13, 5, MACD::Crossover::signal_line);
+
+    for (int i = 0; i < 150; i++) {
+        sma.push(p[i]);
+        macd.push(p[i]);
+    }
+
+    StreamingSMA sma_copy(5, 20);
+    StreamingMACD macd_copy(6, 13, 5, MACD::Crossover::signal_line);
+
+    ASSERT_TRUE(restore_state(save_state(sma), sma_copy));
+    ASSERT_TRUE(restore_state(save_state(macd), macd_copy));
+
+    for (int i = 150; i < 300; i++) {
+        sma.push(p[i]);
+        sma_copy.push(p[i]);
+        macd.push(p[i]);
+        macd_copy.push(p[i]);
+
+        EXPECT_EQ(sma.signal(), sma_copy.signal());
+        EXPECT_EQ(macd.get_macd(), macd_copy.get_macd());
+        EXPECT_EQ(macd.signal(), macd_copy.signal());
+    }
+
+    // other periods, truncated bytes
+    StreamingSMA other(5, 30);
+    StreamingMACD zero_line(6, 13, 5, MACD::Crossover::zero_line);
+    std::string bytes {save_state(sma)};
+
+    EXPECT_FALSE(restore_state(bytes, other));
+    EXPECT_FALSE(restore_state(save_state(macd), zero_line));
+    EXPECT_FALSE(restore_state(bytes.substr(0, bytes.size() - 1), sma_copy));
+    EXPECT_FALSE(restore_state(bytes, macd_copy));
+}
+
+
+TEST(TestResultCache, ResumesSignalsAfterAppendedRows) {
+    ResultCache cache {fresh_cache()};
+    std::vector<double> p {wave(400)};
+
+    for (MACD::Crossover cross : {MACD::Crossover::zero_line, MACD::Crossover::signal_line}) {
+        std::optional<SourceStamp> known;
+
+        for (int rows : {250, 251, 320, 400}) {
+            std::vector<double> prefix(p.begin(), p.begin() + rows);
+            BarsView bars {close_only(prefix)};
+            std::uint64_t hash {hash_bars(bars)};
+            std::optional<IndicatorReport> report {incremental_signals(cache, bars, known, true, true, 9, cross)};
+
+            ASSERT_TRUE(report.has_value());
+            ASSERT_EQ(report->signals.size(), 2u);
+            EXPECT_EQ(report->signals[0].buy, SMA(prefix, 50, 200).indicator());
+            EXPECT_EQ(report->signals[1].buy, MACD(prefix, 12, 26, 9, cross).indicator());
+
+            known = SourceStamp {0, 0, static_cast<std::uint64_t>(rows), hash};
+        }
+    }
+
+    // too short for the 200-day SMA
+    std::vector<double> short_series(p.begin(), p.begin() + 150);
+    BarsView bars {close_only(short_series)};
+
+    EXPECT_FALSE(incremental_signals(cache, bars, std::nullopt, true, false, 9, MACD::Crossover::zero_line));
+    EXPECT_TRUE(incremental_signals(cache, bars, std::nullopt, false, true, 9, MACD::Crossover::zero_line));
+
+    std::filesystem::remove_all(cache_dir);
+}
+
+
+TEST(TestResultCache, KeepsResampledStateApart) {
+    ResultCache cache {fresh_cache()};
+    std::vector<double> p;
+    std::vector<std::int64_t> timestamps;
+
+    // a long rise, then a fall the daily averages see and the weekly ones do not
+    for (int day = 0; day < 1500; day++) {
+        p.push_back((day < 1400) ? 100 + day * 0.1 : 240 - (day - 1400) * 1.2);
+        timestamps.push_back(day * 86400);
+    }
+
+    BarsView daily {{}, {}, {}, p, {}, timestamps};
+    BarData weekly {resample(daily, parse_timeframe("weekly")).bars};
+    SourceStamp file {0, 0, p.size(), hash_bars(daily)};
+
+    // a weekly run of the file, then a daily one that knows the file from it
+    ASSERT_TRUE(incremental_signals(cache, close_only(weekly.close), file, true, true, 9, MACD::Crossover::zero_line));
+
+    std::optional<IndicatorReport> report {incremental_signals(cache, daily, file, true, true, 9, MACD::Crossover::zero_line)};
+
+    ASSERT_TRUE(report.has_value());
+    EXPECT_NE(SMA(weekly.close, 50, 200).indicator(), SMA(p, 50, 200).indicator());
+    EXPECT_EQ(report->signals[0].buy, SMA(p, 50, 200).indicator());
+    EXPECT_EQ(report->signals[1].buy, MACD(p, 12, 26, 9, MACD::Crossover::zero_line).indicator());
+
+    std::filesystem::remove_all(cache_dir);
+}
@@ -0,0 +1,89 @@
+#include "../include/rolling.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+
+TEST(TestRolling, ThrowsInvalidArgument) {
+    EXPECT_THROW(RollingWindow(0), std::invalid_argument);
+    EXPECT_THROW(RollingWindow(-3), std::invalid_argument);
+    EXPECT_THROW(RollingWindow(2).mean(), std::logic_error);
+}
+
+
+TEST(TestRolling, WindowSlidesOverValues) {
+    RollingWindow rolling(3);
+
+    rolling.push(1.0);
+    rolling.push(2.0);
+    EXPECT_FALSE(rolling.full());
+    EXPECT_DOUBLE_EQ(rolling.mean(), 1.5);
+
+    rolling.push(3.0);
+    rolling.push(10.0);
+    EXPECT_TRUE(rolling.full());
+    EXPECT_DOUBLE_EQ(rolling.get_sum(), 15.0);
+    EXPECT_DOUBLE_EQ(rolling.mean(), 5.0);
+}
+
+
+TEST(TestRolling, RollingMeanMatchesDayConvention) {
+    std::vector<double> data = {10.0, 20.0, 30.0, 20.0, 10.0};
+    std::vector<double> avg = rolling_mean(data, 2);
+
+    ASSERT_EQ(avg.size(), data.size() + 1);
+    EXPECT_DOUBLE_EQ(avg[2], 15.0);
+    EXPECT_DOUBLE_EQ(avg[3], 25.0);
+    EXPECT_DOUBLE_EQ(avg[5], 15.0);
+}
+
+
+TEST(TestRolling, CompensatedSumDoesNotDrift) {
+    // a large value passing through the window leaves rounding error behind
+    RollingWindow compensated(2, true);
+    RollingWindow plain(2, false);
+    std::vector<double> values = {1e16, 1.0, 1.0, 1.0, 1.0};
+
+    for (double v : values) {
+        compensated.push(v);
+        plain.push(v);
+    }
+
+    EXPECT_DOUBLE_EQ(compensated.get_sum(), 2.0);
+    EXPECT_NE(plain.get_sum(), 2.0);
+}
+
+
+TEST(TestRolling, RollingStdevMatchesTwoPass) {
+    std::vector<double> p = {1e6 + 1, 1e6 + 4, 1e6 + 2, 1e6 + 8, 1e6 + 5};
+    std::vector<double> result {rolling_stdev(p, 3)};
+
+    ASSERT_EQ(result.size(), 6u);
+    EXPECT_DOUBLE_EQ(result[2], 0.0);
+
+    // prices far from 0 keep their small variance (sums are taken around p[0])
+    for (int day = 3; day <= 5; day++) {
+        double mean {(p[day - 3] + p[day - 2] + p[day - 1]) / 3};
+        double squares {0};
+
+        for (int i = day - 3; i < day; i++) squares += (p[i] - mean) * (p[i] - mean);
+
+        EXPECT_NEAR(result[day], std::sqrt(squares / 3), 1e-9);
+    }
+}
+
+
+TEST(TestRolling, RollingMinMaxFollowWindow) {
+    std::vector<double> p = {3, 1, 4, 1, 5, 9, 2, 6};
+    std::vector<double> low {rolling_min(p, 3)};
+    std::vector<double> high {rolling_max(p, 3)};
+
+    // window of day d is p[d - 3, d)
+    std::vector<double> expected_low = {0, 0, 0, 1, 1, 1, 1, 2, 2};
+    std::vector<double> expected_high = {0, 0, 0, 4, 4, 5, 9, 9, 9};
+
+    EXPECT_EQ(low, expected_low);
+    EXPECT_EQ(high, expected_high);
+    EXPECT_THROW(rolling_max(p, 0), std::invalid_argument);
+}
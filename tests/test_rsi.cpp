@@ -0,0 +1,49 @@
+#include "../include/RSI.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+
+static std::vector<double> data = {10.0, 9.0, 8.0, 7.0, 8.0, 9.0};
+
+
+TEST(TestRSI, ThrowsInvalidArgument) {
+    SeriesCache cache {close_only(data)};
+
+    EXPECT_THROW(RSI(cache, 1), std::invalid_argument);
+    EXPECT_THROW(RSI(cache, 4), std::invalid_argument);
+    EXPECT_THROW(RSI(cache, 2, 70, 30), std::invalid_argument);
+
+    RSI rsi(cache, 2);
+
+    EXPECT_EQ(rsi.first_signal_day(), 2);
+    EXPECT_THROW(rsi.indicator(1), std::invalid_argument);
+    EXPECT_THROW(rsi.indicator(6), std::invalid_argument);
+}
+
+
+TEST(TestRSI, WilderAverages) {
+    SeriesCache cache {close_only(data)};
+    RSI rsi(cache, 2);
+
+    // span 3 EMAs (alpha 1/2) of gains {0, 0, 0, 0, 1, 1} and losses {0, 1, 1, 1, 0, 0}
+    EXPECT_DOUBLE_EQ(rsi.value(2), 0.0);
+    EXPECT_NEAR(rsi.value(4), 100 - 100 / (1 + 0.5 / (5.0 / 12)), 1e-9);
+    EXPECT_NEAR(rsi.value(), 100 - 100 / (1 + 0.75 / (5.0 / 24)), 1e-9);
+}
+
+
+TEST(TestRSI, HoldsFromOversoldToOverbought) {
+    SeriesCache cache {close_only(data)};
+    RSI rsi(cache, 2);
+
+    // bought at RSI 0, still held at 54.5, sold at 78.3
+    EXPECT_TRUE(rsi.indicator(2));
+    EXPECT_TRUE(rsi.indicator(4));
+    EXPECT_FALSE(rsi.indicator());
+
+    std::vector<std::uint8_t> mask(data.size());
+    rsi.fill(2, 6, mask.data());
+
+    EXPECT_EQ(mask, (std::vector<std::uint8_t> {0, 0, 1, 1, 1, 0}));
+}
@@ -0,0 +1,84 @@
+#include "../include/series_cache.h"
+#include "../include/rolling.h"
+#include "../include/ema.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+
+TEST(TestSeriesCache, ComputesEachStatisticOnce) {
+    std::vector<double> data = {1, 3, 2, 5, 4, 6, 8, 7, 9, 10};
+    SeriesCache cache {close_only(data)};
+
+    const std::vector<double>& first = cache.mean(Source::close, 3);
+    const std::vector<double>& again = cache.mean(Source::close, 3);
+
+    EXPECT_EQ(&first, &again);
+    EXPECT_EQ(first, rolling_mean(data, 3));
+    EXPECT_EQ(cache.computed(), 1);
+
+    // a different window or statistic is a new entry; the earlier reference stays valid
+    cache.stdev(Source::close, 3);
+    cache.ema(Source::close, 3);
+    cache.mean(Source::close, 4);
+
+    EXPECT_EQ(cache.computed(), 4);
+    EXPECT_EQ(first, rolling_mean(data, 3));
+    EXPECT_EQ(cache.ema(Source::close, 3), ema_series(data, 3));
+}
+
+
+TEST(TestSeriesCache, StrategiesShareStatistics) {
+    std::vector<double> data;
+    for (int i = 0; i < 60; i++) data.push_back(100 + (i % 7) * 1.5 - (i % 5));
+
+    SeriesCache cache {close_only(data)};
+    SMA sma(cache, 5, 20);
+    MACD macd(cache, 12, 26);
+
+    EXPECT_EQ(cache.computed(), 4);
+
+    // a second SMA and MACD on the same periods reuse every window
+    SMA same_sma(cache, 5, 20);
+    MACD same_macd(cache, 12, 26);
+
+    EXPECT_EQ(cache.computed(), 4);
+
+    // and match the strategies computing their own
+    SMA own_sma(data, 5, 20);
+    MACD own_macd(data, 12, 26);
+
+    for (int day = 26; day < 60; day++) {
+        EXPECT_EQ(sma.indicator(day), own_sma.indicator(day));
+        EXPECT_EQ(macd.indicator(day), own_macd.indicator(day));
+    }
+}
+
+
+TEST(TestSeriesCache, DerivedSources) {
+    std::vector<double> close = {10, 12, 11, 11};
+    std::vector<double> high = {11, 13, 12, 14};
+    std::vector<double> low = {9, 10, 10, 9};
+    std::vector<double> open = {10, 11, 12, 11};
+    BarsView bars {open, high, low, close, {}, {}};
+    SeriesCache cache {bars};
+    SeriesCache closes {close_only(close)};
+
+    PriceView gain {cache.source(Source::gain)};
+    PriceView loss {cache.source(Source::loss)};
+    PriceView range {cache.source(Source::true_range)};
+
+    EXPECT_DOUBLE_EQ(gain[1], 2.0);
+    EXPECT_DOUBLE_EQ(loss[2], 1.0);
+    EXPECT_DOUBLE_EQ(gain[0] + loss[0], 0.0);
+
+    // high - low, or the gap from the previous close when larger
+    EXPECT_DOUBLE_EQ(range[0], 2.0);
+    EXPECT_DOUBLE_EQ(range[1], 3.0);
+    EXPECT_DOUBLE_EQ(range[3], 5.0);
+
+    // without OHLC: highs are closes and the range is the close-to-close change
+    EXPECT_EQ(closes.max(Source::high, 2), rolling_max(close, 2));
+    EXPECT_DOUBLE_EQ(closes.source(Source::true_range)[1], 2.0);
+}
@@ -0,0 +1,313 @@
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "../test_data/"
+#endif
+
+
+#include "../include/service.h"
+#include "../include/SMA.h"
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+static const std::string exported {std::string(TEST_DATA_DIR) + "SVC_2024-01-01_to_2024-12-31.csv"};
+
+
+static std::vector<double> write_export() {
+    std::ofstream out(exported, std::ios::trunc);
+    std::vector<double> prices;
+
+    out << "Close\n";
+
+    for (int i = 0; i < 120; i++) {
+        prices.push_back(100 + 10 * std::sin(i / 7.0) + i * 0.1);
+        out << prices.back() << "\n";
+    }
+
+    out.close();
+
+    // the service reads the same digits back
+    std::ifstream in(exported);
+    std::string line;
+
+    prices.clear();
+    std::getline(in, line);
+
+    while (std::getline(in, line)) prices.push_back(std::stod(line));
+
+    return prices;
+}
+
+
+// a client of the socket at `path`, -1 if the server does not listen within two seconds
+static int connect_to(const std::string& path) {
+    int fd {-1};
+    sockaddr_un address {};
+
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+
+    // wait for the server to listen
+    for (int attempt = 0; attempt < 100 && fd < 0; attempt++) {
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            fd = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    return fd;
+}
+
+
+TEST(TestService, ParsesRequests) {
+    ServiceRequest request;
+
+    parse_request(R"( {"id":"a\"b", "ticker":"MSFT", "strategy":"sma", "short":20, "long":"50", "stocks":5, "mode":"backtest"} )", request);
+
+    EXPECT_EQ(request.id, R"("a\"b")");
+    EXPECT_EQ(request.ticker, "MSFT");
+    EXPECT_EQ(request.strategy, "sma");
+    EXPECT_EQ(request.params, (std::vector<std::pair<std::string, std::string>> {{"short", "20"}, {"long", "50"}}));
+    EXPECT_EQ(request.stocks, 5);
+    EXPECT_FALSE(request.indicator);
+    EXPECT_TRUE(request.backtest);
+
+    ServiceRequest defaults;
+
+    parse_request(R"({"ticker":"TSLA"})", defaults);
+
+    EXPECT_EQ(defaults.id, "null");
+    EXPECT_EQ(defaults.strategy, "both");
+    EXPECT_TRUE(defaults.indicator && defaults.backtest);
+
+    for (const char* line : {"", "[]", "{", R"({"ticker":"X",})", R"({"ticker":"X"} x)", R"({"ticker":"X","ticker":"Y"})",
+                             R"({"ticker":{"a":1}})", R"({"ticker":X})", R"({"id":1})", R"({"ticker":"X","stocks":0})",
+                             R"({"ticker":"X","strategy":"foo"})", R"({"ticker":"X","short":20})", R"({"ticker":"X","mode":"all"})"}) {
+        ServiceRequest invalid;
+
+        EXPECT_THROW(parse_request(line, invalid), std::invalid_argument) << line;
+    }
+
+    // the id is known even when a later field is wrong
+    ServiceRequest invalid;
+
+    EXPECT_THROW(parse_request(R"({"stocks":-1,"id":7,"ticker":"X"})", invalid), std::invalid_argument);
+    EXPECT_EQ(invalid.id, "7");
+}
+
+
+TEST(TestService, AnswersFromMemory) {
+    std::vector<double> prices {write_export()};
+    BacktestService service({exported}, false);
+
+    EXPECT_EQ(service.get_tickers(), std::vector<std::string> {"SVC"});
+
+    std::string response {service.handle(R"({"id":1,"ticker":"SVC","strategy":"sma","short":10,"long":30,"stocks":3})")};
+
+    // the same report as a single run of SMA 10/30
+    SMA sma(prices, 10, 30);
+    Simulator sim(sma, prices);
+    RunReport report;
+    report.ticker = "SVC";
+    report.current_price = prices.back();
+    report.days = prices.size();
+    report.stocks = 3;
+    report.indicator = sim.indicator_report();
+    report.backtest = sim.backtest_report(3);
+
+    std::string json {format_run(report, OutputFormat::json)};
+    json.pop_back();
+
+    EXPECT_EQ(response, R"({"id":1,"ok":true,"result":)" + json + "}\n");
+
+    // the file is not read again
+    std::remove(exported.c_str());
+
+    EXPECT_EQ(service.handle(R"({"id":1,"ticker":"SVC","strategy":"sma","short":10,"long":30,"stocks":3})"), response);
+    EXPECT_NE(service.handle(R"({"id":2,"ticker":"SVC","strategy":"macd","signal":5})").find(R"("ok":true)"), std::string::npos);
+
+    EXPECT_EQ(service.handle(R"({"id":3,"ticker":"AAPL"})"), "{\"id\":3,\"ok\":false,\"error\":\"unknown ticker 'AAPL'\"}\n");
+    EXPECT_EQ(service.handle(R"({"id":4,"ticker":"SVC","strategy":"sma","long":500})").find(R"({"id":4,"ok":false,)"), 0u);
+
+    service.record(1000);
+    service.record(3000);
+
+    ServiceSummary summary {service.get_summary()};
+
+    EXPECT_EQ(summary.requests, 2u);
+    EXPECT_EQ(summary.errors, 2u);
+    EXPECT_DOUBLE_EQ(summary.latency.mean_us(), 2.0);
+}
+
+
+TEST(TestService, KeepsOnlyRecentStrategies) {
+    write_export();
+
+    BacktestService service({exported}, false);
+    BacktestService fresh({exported}, false);
+    std::string first {R"({"id":1,"ticker":"SVC","strategy":"sma","short":2,"long":30})"};
+    std::string expected {fresh.handle(first)};
+
+    // three times as many parameter sets as are kept, so the cache is replaced twice on the way
+    for (int i = 0; i < 200; i++) {
+        std::string line {R"({"id":1,"ticker":"SVC","strategy":"sma","short":)" + std::to_string(2 + i % 20)
+                          + R"(,"long":)" + std::to_string(30 + i / 20) + "}"};
+
+        ASSERT_NE(service.handle(line).find(R"("ok":true)"), std::string::npos);
+        EXPECT_LE(service.cached_strategies("SVC"), BacktestService::MAX_STRATEGIES);
+    }
+
+    std::remove(exported.c_str());
+
+    EXPECT_EQ(service.cached_strategies("SVC"), BacktestService::MAX_STRATEGIES);
+    EXPECT_EQ(service.cached_strategies("AAPL"), 0u);
+
+    // an evicted set is built again, on the current cache, with the same result
+    EXPECT_EQ(service.handle(first), expected);
+}
+
+
+TEST(TestService, ServesStreamConcurrently) {
+    write_export();
+
+    BacktestService service({exported}, false);
+    ThreadPool pool(4);
+    std::ostringstream requests;
+    std::ostringstream responses;
+
+    for (int i = 0; i < 40; i++) requests << R"({"id":)" << i << R"(,"ticker":"SVC","strategy":"sma","short":)" << 5 + i % 4 << R"(,"long":40})" << "\n\n";
+
+    std::istringstream in(requests.str());
+
+    serve_stream(service, in, responses, pool);
+    std::remove(exported.c_str());
+
+    std::istringstream out(responses.str());
+    std::vector<bool> answered(40);
+    std::string line;
+
+    while (std::getline(out, line)) {
+        int id {std::stoi(line.substr(6))};
+
+        ASSERT_NE(line.find(R"("ok":true)"), std::string::npos) << line;
+        answered.at(id) = true;
+    }
+
+    EXPECT_EQ(answered, std::vector<bool>(40, true));
+    EXPECT_EQ(service.get_summary().requests, 40u);
+    EXPECT_EQ(service.get_summary().latency.count(), 40u);
+}
+
+
+TEST(TestService, ServesUnixSocket) {
+    write_export();
+
+    std::string path {std::string(TEST_DATA_DIR) + "service.sock"};
+    BacktestService service({exported}, false);
+    ThreadPool pool(2);
+    std::atomic<bool> stop {false};
+    std::thread server([&]() { serve_socket(service, path, pool, stop); });
+
+    int fd {connect_to(path)};
+
+    if (fd < 0) {
+        stop = true;
+        server.join();
+    }
+
+    ASSERT_GE(fd, 0);
+
+    std::string requests {"{\"id\":1,\"ticker\":\"SVC\",\"mode\":\"indicator\",\"strategy\":\"sma\",\"long\":60}\n{\"id\":2,\"stats\":true}"};
+
+    ASSERT_EQ(::write(fd, requests.data(), requests.size()), static_cast<ssize_t>(requests.size()));
+    ::shutdown(fd, SHUT_WR);
+
+    // the connection closes once both are answered
+    std::string received;
+    char chunk[4096];
+
+    for (ssize_t n; (n = ::read(fd, chunk, sizeof(chunk))) > 0;) received.append(chunk, n);
+
+    ::close(fd);
+    stop = true;
+    server.join();
+    std::remove(exported.c_str());
+
+    EXPECT_NE(received.find(R"({"id":1,"ok":true,"result":{"ticker":"SVC")"), std::string::npos) << received;
+    EXPECT_NE(received.find(R"({"id":2,"ok":true,"stats":)"), std::string::npos) << received;
+    EXPECT_EQ(std::count(received.begin(), received.end(), '\n'), 2);
+    EXPECT_NE(::access(path.c_str(), F_OK), 0);
+}
+
+
+TEST(TestService, ClientThatDoesNotReadStallsOnlyItself) {
+    write_export();
+
+    std::string path {std::string(TEST_DATA_DIR) + "service_slow.sock"};
+    BacktestService service({exported}, false);
+    ThreadPool pool(2);
+    std::atomic<bool> stop {false};
+    std::thread server([&]() { serve_socket(service, path, pool, stop); });
+
+    int slow {connect_to(path)};
+    int fast {connect_to(path)};
+
+    if (slow < 0 || fast < 0) {
+        stop = true;
+        server.join();
+    }
+
+    ASSERT_GE(slow, 0);
+    ASSERT_GE(fast, 0);
+
+    // far more requests than fit in flight, whose responses fill the socket, and none of them read
+    std::string request {R"({"id":1,"ticker":"SVC","strategy":"sma","short":5,"long":40})" "\n"};
+    std::string requests;
+
+    for (int i = 0; i < 4000; i++) requests += request;
+
+    ::send(slow, requests.data(), requests.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    std::string stats {"{\"id\":2,\"stats\":true}\n"};
+
+    ASSERT_EQ(::write(fast, stats.data(), stats.size()), static_cast<ssize_t>(stats.size()));
+
+    // the other client is still answered
+    std::string received;
+    char chunk[4096];
+    pollfd waiting {fast, POLLIN, 0};
+
+    while (received.find('\n') == std::string::npos && ::poll(&waiting, 1, 5000) > 0) {
+        ssize_t n = ::read(fast, chunk, sizeof(chunk));
+
+        if (n <= 0) break;
+
+        received.append(chunk, n);
+    }
+
+    ::close(fast);
+    stop = true;
+    server.join();
+    ::close(slow);
+    std::remove(exported.c_str());
+
+    EXPECT_EQ(received.find(R"({"id":2,"ok":true,"stats":)"), 0u) << received;
+}
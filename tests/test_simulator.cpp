@@ -1,4 +1,8 @@
 #include "../include/simulator.h"
+#include "../include/RSI.h"
+#include <cstdint>
+#include <memory>
+#include <utility>
 #include <gtest/gtest.h>
 #include <stdexcept>
 #include <vector>
@@ -23,3 +27,121 @@ TEST(TestSimulator, ThrowsInvalidArgument) {
     EXPECT_THROW(sim.backtest(-1), std::invalid_argument);
 }
 
+
+
+TEST(TestSimulator, FillsAtTheOpen) {
+    std::vector<double> close {10, 10, 10, 20, 30, 30, 5, 5};
+    std::vector<double> open {10, 10, 10, 12, 25, 31, 8, 5};
+    SMA fast(close, 1, 2);
+    Simulator sim(fast, close);
+
+    EXPECT_THROW(sim.set_open_fill(PriceView(open.data(), 3)), std::invalid_argument);
+
+    BacktestResult at_close {sim.backtest_report(1).strategies[0].result};
+    sim.set_open_fill(open);
+    BacktestReport report {sim.backtest_report(1)};
+
+    // same decisions, priced at the open column
+    EXPECT_EQ(report.strategies[0].result.transactions, at_close.transactions);
+    EXPECT_NE(report.strategies[0].result.profit, at_close.profit);
+    EXPECT_DOUBLE_EQ(report.last_price, 5);
+}
+
+
+TEST(TestSimulator, ReportsMetricsOnRequest) {
+    std::vector<double> close {10, 10, 10, 20, 30, 30, 5, 5};
+    SMA fast(close, 1, 2);
+    Simulator sim(fast, close);
+
+    EXPECT_FALSE(sim.backtest_report(1).strategies[0].metrics);
+
+    sim.set_metrics(true);
+    BacktestReport report {sim.backtest_report(1)};
+    const StrategyReport& s = report.strategies[0];
+
+    ASSERT_TRUE(s.metrics);
+    ASSERT_TRUE(report.buy_and_hold_metrics);
+    EXPECT_EQ(2 * s.metrics->trades, s.result.transactions);
+    EXPECT_EQ(s.trades.size(), static_cast<std::size_t>(s.metrics->trades));
+}
+
+
+TEST(TestSimulator, ReportsAddedStrategies) {
+    std::vector<double> close {10, 9, 8, 7, 8, 9, 8, 6, 5, 7, 9, 11};
+    SeriesCache cache {close_only(close)};
+    SMA fast(cache, 1, 2);
+    auto rsi = std::make_shared<RSI>(cache, 2);
+    Simulator sim(fast, close);
+
+    EXPECT_THROW(sim.add_strategy("RSI", nullptr), std::invalid_argument);
+
+    sim.add_strategy("RSI", rsi);
+
+    IndicatorReport signals {sim.indicator_report()};
+    BacktestReport report {sim.backtest_report(1)};
+
+    ASSERT_EQ(signals.signals.size(), 2u);
+    EXPECT_EQ(signals.signals[1].strategy, "RSI");
+    EXPECT_EQ(signals.signals[1].buy, rsi->indicator());
+
+    // same trades as backtesting the strategy's own signal from the common start day
+    ASSERT_EQ(report.strategies.size(), 2u);
+    EXPECT_EQ(report.strategies[1].strategy, "RSI");
+
+    BacktestResult direct {backtest_vectorized(PriceView(close), rsi->first_signal_day(), 1, rsi->signal())};
+
+    EXPECT_EQ(report.strategies[1].result.transactions, direct.transactions);
+    EXPECT_DOUBLE_EQ(report.strategies[1].result.profit, direct.profit);
+}
+
+
+// a strategy with fixed decisions, to check the vote day by day
+class FixedStrategy : public Strategy {
+private:
+    std::vector<std::uint8_t> decisions;
+
+public:
+    FixedStrategy(PriceView p, std::vector<std::uint8_t> d) : Strategy(p, 1, 2), decisions(std::move(d)) {}
+
+    bool indicator(int day=-1) const { return decisions[(day == -1) ? size - 1 : day]; }
+};
+
+
+TEST(TestSimulator, BacktestsWeightedVote) {
+    std::vector<double> close {10, 11, 12, 14, 13, 12, 15, 16};
+    std::vector<StrategyEntry> entries {
+        {"A", std::make_shared<FixedStrategy>(close, std::vector<std::uint8_t> {0, 0, 1, 1, 0, 0, 1, 1}), 2},
+        {"B", std::make_shared<FixedStrategy>(close, std::vector<std::uint8_t> {0, 0, 1, 0, 0, 1, 1, 0}), 1},
+        {"C", std::make_shared<FixedStrategy>(close, std::vector<std::uint8_t> {0, 0, 0, 1, 1, 0, 1, 0}), 1},
+    };
+    Simulator sim(entries, close);
+
+    EXPECT_THROW(sim.set_vote({-0.5, 0.5}), std::invalid_argument);
+    EXPECT_THROW(Simulator({}, close), std::invalid_argument);
+
+    sim.set_vote({0.25, -0.25});
+    sim.set_combination(Combine::majority);
+
+    // last day: A (2) against B and C (1 + 1)
+    IndicatorReport signals {sim.indicator_report()};
+
+    EXPECT_DOUBLE_EQ(signals.score, 0);
+    EXPECT_EQ(signals.recommendation, "MIXED SIGNAL");
+
+    BacktestReport report {sim.backtest_report(1)};
+
+    ASSERT_EQ(report.strategies.size(), 5u);
+    EXPECT_EQ(report.strategies[3].strategy, "A MAJORITY B MAJORITY C");
+    EXPECT_EQ(report.strategies[4].strategy, "Vote");
+
+    // scores 0.5, 0.5, -0.5, -0.5, 1, 0: the tie on the last day keeps the position
+    std::vector<std::uint8_t> voted {0, 0, 1, 1, 0, 0, 1, 1};
+    std::vector<std::uint8_t> majority {0, 0, 1, 1, 0, 0, 1, 0};
+    BacktestResult expected_vote {backtest_vectorized(PriceView(close), 2, 1, StateSignal {voted.data()})};
+    BacktestResult expected_majority {backtest_vectorized(PriceView(close), 2, 1, StateSignal {majority.data()})};
+
+    EXPECT_EQ(report.strategies[4].result.transactions, expected_vote.transactions);
+    EXPECT_DOUBLE_EQ(report.strategies[4].result.profit, expected_vote.profit);
+    EXPECT_EQ(report.strategies[3].result.transactions, expected_majority.transactions);
+    EXPECT_DOUBLE_EQ(report.strategies[3].result.profit, expected_majority.profit);
+}
@@ -0,0 +1,168 @@
+#include "../include/strategy_config.h"
+#include "../include/util.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+static SimulationConfig parse(const std::string& text) {
+    std::istringstream in(text);
+    return parse_config(in);
+}
+
+// the message of the std::invalid_argument `text` throws, empty if it parses
+static std::string parse_error(const std::string& text) {
+    try {
+        parse(text);
+    }
+    catch (const std::invalid_argument& e) {
+        return e.what();
+    }
+
+    return "";
+}
+
+
+TEST(TestStrategyConfig, ParsesStrategiesAndVote) {
+    SimulationConfig config {parse("# trend and mean reversion\n"
+                                   "sma short=20 long=50 weight=2\n"
+                                   "\n"
+                                   "rsi period=10 name=Fast-RSI   # oversold default\n"
+                                   "vote buy=0.25 sell=-0.5\n")};
+
+    ASSERT_EQ(config.strategies.size(), 2u);
+    EXPECT_EQ(config.strategies[0].kind, "sma");
+    EXPECT_DOUBLE_EQ(config.strategies[0].weight, 2);
+    ASSERT_EQ(config.strategies[0].params.size(), 2u);
+    EXPECT_EQ(config.strategies[0].params[1].first, "long");
+    EXPECT_EQ(config.strategies[1].name, "Fast-RSI");
+    EXPECT_DOUBLE_EQ(config.strategies[1].weight, 1);
+    EXPECT_DOUBLE_EQ(config.vote.buy, 0.25);
+    EXPECT_DOUBLE_EQ(config.vote.sell, -0.5);
+}
+
+
+TEST(TestStrategyConfig, ReportsErrorsWithTheirLine) {
+    EXPECT_EQ(parse_error("sma\nstochastic\n"), "line 2: unknown strategy 'stochastic' (expected sma, macd, rsi, bollinger, ema or atr)");
+    EXPECT_EQ(parse_error("sma short\n"), "line 1: expected key=value, got 'short'");
+    EXPECT_EQ(parse_error("sma weight=0\n"), "line 1: weight must be positive");
+    EXPECT_EQ(parse_error("sma weight=x\n"), "line 1: 'weight=x' is not a valid number");
+    EXPECT_EQ(parse_error("sma\nvote buy=-0.5 sell=0.5\n"), "line 2: Vote thresholds must satisfy -1 <= sell <= buy <= 1");
+    EXPECT_EQ(parse_error("sma\nvote buy=0.5\nvote sell=-0.5\n"), "line 3: only one vote line is allowed");
+    EXPECT_EQ(parse_error("# nothing\n"), "the config has no strategies");
+    EXPECT_THROW(load_config("/nonexistent/strategies.conf"), std::runtime_error);
+}
+
+
+TEST(TestStrategyConfig, BuildsStrategiesOnOneCache) {
+    std::vector<double> data;
+    for (int i = 0; i < 80; i++) data.push_back(100 + (i % 9) - (i % 4) * 1.5);
+
+    SeriesCache cache {close_only(data)};
+    SimulationConfig config {parse("macd short=5 long=20 signal=4 cross=signal\n"
+                                   "ema short=5 long=20 weight=0.5\n"
+                                   "bollinger period=20 width=1.5\n"
+                                   "atr period=5 multiple=2 breakout=10 name=Stops\n")};
+    std::vector<StrategyEntry> entries;
+
+    for (const StrategySpec& spec : config.strategies) entries.push_back(make_strategy(spec, cache));
+
+    EXPECT_EQ(entries[0].name, "MACD");
+    EXPECT_EQ(entries[0].strategy->get_long_term(), 20);
+    EXPECT_EQ(entries[1].name, "EMA cross");
+    EXPECT_DOUBLE_EQ(entries[1].weight, 0.5);
+    EXPECT_EQ(entries[3].name, "Stops");
+
+    // MACD and the crossover share both EMAs; Bollinger adds a mean and stdev, ATR the true range,
+    // its average and two maxima
+    EXPECT_EQ(cache.computed(), 2 + 2 + 4);
+}
+
+
+TEST(TestStrategyConfig, NamesRepeatedKindsByTheirParameters) {
+    std::vector<double> data;
+    for (int i = 0; i < 80; i++) data.push_back(100 + (i % 9) - (i % 4) * 1.5);
+
+    SeriesCache cache {close_only(data)};
+    std::vector<StrategyEntry> entries {make_strategies(parse("sma short=5 long=20\n"
+                                                             "sma short=10 long=40\n"
+                                                             "macd cross=signal\n"
+                                                             "rsi oversold=25.5\n"
+                                                             "rsi name=Slow-RSI\n"), cache)};
+
+    ASSERT_EQ(entries.size(), 5u);
+    EXPECT_EQ(entries[0].name, "SMA 5/20");
+    EXPECT_EQ(entries[1].name, "SMA 10/40");
+    EXPECT_EQ(entries[2].name, "MACD");
+    EXPECT_EQ(entries[3].name, "RSI");
+    EXPECT_EQ(entries[4].name, "Slow-RSI");
+
+    try {
+        make_strategies(parse("ema\nrsi name=Fast\nmacd name=Fast\n"), cache);
+        FAIL() << "expected a repeated name to throw";
+    }
+    catch (const std::invalid_argument& e) {
+        EXPECT_STREQ(e.what(), "line 3: strategy name 'Fast' is already used on line 2 (set a different name=)");
+    }
+
+    EXPECT_THROW(make_strategies(parse("sma short=5 long=20\nsma short=5 long=20\n"), cache), std::invalid_argument);
+}
+
+
+TEST(TestStrategyConfig, BuildsStrategiesOnCoarserTimeframes) {
+    std::vector<double> close;
+    std::vector<std::int64_t> timestamps;
+    std::int64_t monday {0};
+
+    ASSERT_TRUE(parse_timestamp("2025-01-06", monday));
+
+    // ten weeks of daily closes
+    for (int i = 0; i < 70; i++) {
+        close.push_back(100 + (i % 9) - (i % 4) * 1.5);
+        timestamps.push_back(monday + i * 86400);
+    }
+
+    SeriesCache cache {{{}, {}, {}, close, {}, timestamps}};
+    SimulationConfig config {parse("sma short=2 long=4 timeframe=weekly\n"
+                                   "ema short=2 long=4 timeframe=weekly\n"
+                                   "macd short=3 long=6 signal=3\n")};
+    std::vector<StrategyEntry> entries;
+
+    for (const StrategySpec& spec : config.strategies) entries.push_back(make_strategy(spec, cache));
+
+    EXPECT_EQ(entries[0].name, "Weekly SMA");
+    EXPECT_EQ(entries[1].name, "Weekly EMA cross");
+    EXPECT_EQ(entries[2].name, "MACD");
+
+    // both weekly strategies read the one resampled series; only MACD's EMAs are daily
+    EXPECT_EQ(cache.timeframe(parse_timeframe("weekly")).cache.size(), 10);
+    EXPECT_EQ(cache.timeframe(parse_timeframe("weekly")).cache.computed(), 4);
+    EXPECT_EQ(cache.computed(), 2);
+
+    EXPECT_THROW(make_strategy(parse("sma timeframe=fortnightly\n").strategies[0], cache), std::invalid_argument);
+}
+
+
+TEST(TestStrategyConfig, RejectsUnknownParameters) {
+    std::vector<double> data(40, 10.0);
+    SeriesCache cache {close_only(data)};
+
+    EXPECT_THROW(make_strategy(parse("rsi periods=10\n").strategies[0], cache), std::invalid_argument);
+    EXPECT_THROW(make_strategy(parse("sma short=2.5\n").strategies[0], cache), std::invalid_argument);
+    EXPECT_THROW(make_strategy(parse("macd cross=line\n").strategies[0], cache), std::invalid_argument);
+
+    // valid parameters, but more data than there is
+    EXPECT_THROW(make_strategy(parse("sma\n").strategies[0], cache), std::invalid_argument);
+
+    // errors of strategies from a config name their line
+    try {
+        make_strategy(parse("# comment\nrsi periods=10\n").strategies[0], cache);
+        ADD_FAILURE() << "expected std::invalid_argument";
+    }
+    catch (const std::invalid_argument& e) {
+        EXPECT_EQ(std::string(e.what()), "line 2: unknown parameter 'periods' for rsi");
+    }
+}
@@ -0,0 +1,83 @@
+#include "../include/stream.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+static std::vector<double> wave() {
+    std::vector<double> p;
+
+    for (int i = 0; i < 200; i++) p.push_back(100 + 8 * std::sin(i / 6.0) + i * 0.03);
+
+    return p;
+}
+
+
+TEST(TestStream, SMAMatchesBatchIndicator) {
+    std::vector<double> p {wave()};
+    SMA sma(p, 5, 20);
+    StreamingSMA live(5, 20);
+
+    for (int n = 1; n <= static_cast<int>(p.size()); n++) {
+        live.push(p[n - 1]);
+
+        EXPECT_EQ(live.ready(), n >= 20);
+        if (live.ready()) {
+            EXPECT_EQ(live.signal(), sma.indicator(n));
+        }
+    }
+}
+
+
+TEST(TestStream, MACDMatchesBatchIndicator) {
+    std::vector<double> p {wave()};
+
+    for (MACD::Crossover mode : {MACD::Crossover::zero_line, MACD::Crossover::signal_line}) {
+        MACD macd(p, 6, 13, 5, mode);
+        StreamingMACD live(6, 13, 5, mode);
+
+        for (int n = 1; n <= static_cast<int>(p.size()); n++) {
+            live.push(p[n - 1]);
+
+            EXPECT_EQ(live.ready(), n - 1 >= macd.first_signal_day());
+
+            if (live.ready()) {
+                EXPECT_EQ(live.signal(), macd.indicator(n - 1));
+                EXPECT_EQ(live.get_macd(), macd.get_macd_line()[n - 1]);
+            }
+        }
+    }
+}
+
+
+TEST(TestStream, ThrowsInvalidArgument) {
+    EXPECT_THROW(StreamingSMA(5, 5), std::invalid_argument);
+    EXPECT_THROW(StreamingMACD(12, 26, 0), std::invalid_argument);
+}
+
+
+TEST(TestStream, EmitsTransitionsAndSkipsBadLines) {
+    std::ostringstream input;
+
+    for (double v : wave()) input << v << "\n";
+    input << "oops\n";
+
+    std::istringstream in(input.str());
+    std::ostringstream out;
+    std::ostringstream err;
+    StreamOptions options;
+    options.macd_on = false;
+
+    StreamSummary summary {run_stream(in, out, err, options)};
+
+    EXPECT_EQ(summary.ticks, 200);
+    EXPECT_EQ(summary.rejected, 1);
+    EXPECT_EQ(summary.latency.count(), 200u);
+    EXPECT_GE(summary.transitions, 1);
+    EXPECT_NE(out.str().find("SMA (50/200)"), std::string::npos);
+    EXPECT_NE(err.str().find("oops"), std::string::npos);
+}
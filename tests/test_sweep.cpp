@@ -0,0 +1,86 @@
+#include "../include/sweep.h"
+#include "../include/SMA.h"
+#include "../include/MACD.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+
+static std::vector<double> wave() {
+    std::vector<double> p;
+
+    for (int i = 0; i < 300; i++) p.push_back(100 + 10 * std::sin(i / 7.0) + i * 0.05);
+
+    return p;
+}
+
+
+TEST(TestSweep, ParsesRanges) {
+    SweepRange range {parse_range("5:50:5")};
+
+    EXPECT_EQ(range.from, 5);
+    EXPECT_EQ(range.to, 50);
+    EXPECT_EQ(range.step, 5);
+    EXPECT_EQ(parse_range("3:9").step, 1);
+
+    EXPECT_THROW(parse_range("5"), std::invalid_argument);
+    EXPECT_THROW(parse_range("9:3"), std::invalid_argument);
+    EXPECT_THROW(parse_range("0:3"), std::invalid_argument);
+    EXPECT_THROW(parse_range("a:3"), std::invalid_argument);
+}
+
+
+TEST(TestSweep, CoversEveryValidPair) {
+    std::vector<double> p {wave()};
+    ThreadPool pool(2);
+
+    // short 5..20 x long 10..40: pairs with short < long
+    std::vector<SweepResult> results {sweep(p, {5, 20, 5}, {10, 40, 10}, 1, true, true, pool)};
+
+    EXPECT_EQ(results.size(), 2u * 12u);
+
+    for (std::size_t i = 1; i < results.size(); i++) {
+        EXPECT_GE(results[i - 1].result.profit, results[i].result.profit);
+    }
+}
+
+
+TEST(TestSweep, MatchesSingleStrategyBacktest) {
+    std::vector<double> p {wave()};
+    ThreadPool pool(2);
+    std::vector<SweepResult> results {sweep(p, {10, 10}, {30, 30}, 3, true, true, pool)};
+
+    SMA sma(p, 10, 30);
+    MACD macd(p, 10, 30);
+    BacktestResult sma_result {backtest_signal(p, 30, 3, [&](int day) { return sma.indicator(day); })};
+    BacktestResult macd_result {backtest_signal(p, 30, 3, [&](int day) { return macd.indicator(day); })};
+
+    ASSERT_EQ(results.size(), 2u);
+
+    for (const SweepResult& r : results) {
+        const BacktestResult& expected = (r.strategy == "SMA") ? sma_result : macd_result;
+
+        EXPECT_EQ(r.result.transactions, expected.transactions);
+        EXPECT_DOUBLE_EQ(r.result.profit, expected.profit);
+    }
+}
+
+
+TEST(TestSweep, MetricsLeaveTheRankingUnchanged) {
+    std::vector<double> p {wave()};
+    ThreadPool pool(2);
+    std::vector<SweepResult> plain {sweep(p, {5, 20, 5}, {10, 40, 10}, 1, true, true, pool)};
+    std::vector<SweepResult> measured {sweep(p, {5, 20, 5}, {10, 40, 10}, 1, true, true, pool, {}, true)};
+
+    ASSERT_EQ(plain.size(), measured.size());
+
+    for (std::size_t i = 0; i < plain.size(); i++) {
+        EXPECT_FALSE(plain[i].metrics);
+        ASSERT_TRUE(measured[i].metrics);
+        EXPECT_EQ(measured[i].strategy, plain[i].strategy);
+        EXPECT_EQ(measured[i].short_term, plain[i].short_term);
+        EXPECT_EQ(measured[i].result.profit, plain[i].result.profit);
+        EXPECT_EQ(2 * measured[i].metrics->trades, measured[i].result.transactions);
+    }
+}
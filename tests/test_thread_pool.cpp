@@ -0,0 +1,78 @@
+#include "../include/thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+TEST(TestThreadPool, RunsEveryTask) {
+    ThreadPool pool(4);
+    std::vector<int> hits(1000, 0);
+
+    parallel_for(pool, 0, hits.size(), [&](int i) { hits[i]++; });
+
+    for (int h : hits) EXPECT_EQ(h, 1);
+}
+
+
+TEST(TestThreadPool, TasksCanSpawnTasks) {
+    ThreadPool pool(3);
+    std::atomic<int> count {0};
+
+    for (int i = 0; i < 10; i++) {
+        pool.submit([&]() {
+            for (int j = 0; j < 10; j++) pool.submit([&]() { count++; });
+        });
+    }
+
+    pool.wait();
+
+    EXPECT_EQ(count, 100);
+}
+
+
+TEST(TestThreadPool, RethrowsTaskFailure) {
+    ThreadPool pool(2);
+
+    pool.submit([]() { throw std::runtime_error("task failed"); });
+
+    EXPECT_THROW(pool.wait(), std::runtime_error);
+    EXPECT_NO_THROW(pool.wait());
+}
+
+
+TEST(TestThreadPool, ParallelForWaitsForItsOwnBatch) {
+    ThreadPool pool(2);
+    std::atomic<bool> release {false};
+    std::atomic<int> inner {0};
+
+    // a task of another caller that outlives the batch below
+    pool.submit([&]() {
+        while (!release) std::this_thread::yield();
+    });
+
+    parallel_for(pool, 0, 50, [&](int) { inner++; });
+
+    EXPECT_EQ(inner, 50);
+
+    release = true;
+    pool.wait();
+}
+
+
+TEST(TestThreadPool, NestedParallelForDoesNotDeadlock) {
+    ThreadPool pool(2);
+    std::vector<std::atomic<int>> hits(8 * 100);
+
+    // every worker is busy with an outer task while the inner batches run
+    parallel_for(pool, 0, 8, [&](int i) {
+        parallel_for(pool, 0, 100, [&](int j) { hits[i * 100 + j]++; });
+    });
+
+    for (const auto& h : hits) EXPECT_EQ(h, 1);
+
+    EXPECT_THROW(parallel_for(pool, 0, 4, [](int i) { if (i == 2) throw std::runtime_error("task failed"); }),
+                 std::runtime_error);
+    EXPECT_NO_THROW(pool.wait());
+}
@@ -7,6 +7,8 @@
 #include <gtest/gtest.h>
 #include <string>
 #include <stdexcept>
+#include <vector>
+#include <cstdint>
 
 
 TEST(TestUtil, FailToOpenFile) {
@@ -23,3 +25,69 @@ TEST(TestUtil, ValidFileWithNoErrors) {
     EXPECT_NO_THROW(read_file(std::string(TEST_DATA_DIR) + "valid_data.csv"));
 }
 
+
+
+TEST(TestUtil, ReadsCloseColumnOfExportedFile) {
+    std::vector<double> data {read_file(std::string(TEST_DATA_DIR) + "TEST_2025-01-02_to_2025-01-03.csv")};
+
+    ASSERT_EQ(data.size(), 2u);
+    EXPECT_DOUBLE_EQ(data[0], 10.5);
+    EXPECT_DOUBLE_EQ(data[1], 11.75);
+}
+
+
+TEST(TestUtil, CorruptDataReportsLineNumber) {
+    try {
+        read_file(std::string(TEST_DATA_DIR) + "invalid_data.csv");
+        FAIL() << "expected std::runtime_error";
+    }
+    catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("potentially corrupt data (line 1)"), std::string::npos);
+    }
+}
+
+
+TEST(TestUtil, ReadsAllValuesWithoutTrailingNewline) {
+    std::vector<double> data {read_file(std::string(TEST_DATA_DIR) + "valid_data.csv")};
+
+    ASSERT_EQ(data.size(), 3u);
+    EXPECT_DOUBLE_EQ(data[0], 10.2);
+    EXPECT_DOUBLE_EQ(data[2], 3.887);
+}
+
+
+TEST(TestUtil, ParsesTimestamps) {
+    std::int64_t seconds {};
+
+    EXPECT_TRUE(parse_timestamp("1970-01-02", seconds));
+    EXPECT_EQ(seconds, 86400);
+
+    EXPECT_TRUE(parse_timestamp("2020-11-05 00:00:00-05:00", seconds));
+    EXPECT_EQ(seconds, 1604552400);
+
+    EXPECT_FALSE(parse_timestamp("2020-13-05", seconds));
+    EXPECT_FALSE(parse_timestamp("05/11/2020", seconds));
+}
+
+
+TEST(TestUtil, ReadsEveryBarColumn) {
+    BarData bars {read_bars(std::string(TEST_DATA_DIR) + "TEST_2025-01-02_to_2025-01-03.csv")};
+
+    ASSERT_EQ(bars.close.size(), 2u);
+    ASSERT_EQ(bars.open.size(), 2u);
+    EXPECT_DOUBLE_EQ(bars.open[1], 10.5);
+    EXPECT_DOUBLE_EQ(bars.high[1], 12);
+    EXPECT_DOUBLE_EQ(bars.low[0], 9);
+    EXPECT_DOUBLE_EQ(bars.close[0], 10.5);
+    EXPECT_DOUBLE_EQ(bars.volume[1], 200);
+    EXPECT_EQ(bars.timestamps.size(), 2u);
+}
+
+
+TEST(TestUtil, CloseOnlyFileHasNoBarColumns) {
+    BarData bars {read_bars(std::string(TEST_DATA_DIR) + "valid_data.csv")};
+
+    EXPECT_EQ(bars.close.size(), 3u);
+    EXPECT_TRUE(bars.open.empty());
+    EXPECT_TRUE(bars.volume.empty());
+}
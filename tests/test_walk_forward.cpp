@@ -0,0 +1,94 @@
+#include "../include/walk_forward.h"
+#include "../include/rolling.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+
+static std::vector<double> wave() {
+    std::vector<double> p;
+
+    for (int i = 0; i < 400; i++) p.push_back(100 + 10 * std::sin(i / 7.0) + i * 0.05);
+
+    return p;
+}
+
+
+TEST(TestWalkForward, SplitsRollingFolds) {
+    std::vector<Fold> folds {walk_forward_folds(400, {200, 50, 0, false})};
+
+    // test windows back to back: 200-249, 250-299, 300-349, 350-399
+    ASSERT_EQ(folds.size(), 4u);
+    EXPECT_EQ(folds[1].train_begin, 50);
+    EXPECT_EQ(folds[1].train_end, 250);
+    EXPECT_EQ(folds[3].test_end, 400);
+}
+
+
+TEST(TestWalkForward, SplitsAnchoredFolds) {
+    std::vector<Fold> folds {walk_forward_folds(400, {200, 50, 100, true})};
+
+    ASSERT_EQ(folds.size(), 2u);
+    EXPECT_EQ(folds[1].train_begin, 0);
+    EXPECT_EQ(folds[1].train_end, 300);
+}
+
+
+TEST(TestWalkForward, RejectsInvalidWindows) {
+    EXPECT_THROW(walk_forward_folds(400, {0, 50, 0, false}), std::invalid_argument);
+    EXPECT_THROW(walk_forward_folds(400, {200, 0, 0, false}), std::invalid_argument);
+    EXPECT_THROW(walk_forward_folds(400, {350, 100, 0, false}), std::invalid_argument);
+}
+
+
+TEST(TestWalkForward, FirstFoldMatchesSweepOfTrainWindow) {
+    std::vector<double> p {wave()};
+    ThreadPool pool(2);
+    WalkForwardOptions options {200, 50, 0, false};
+
+    std::vector<FoldResult> results {walk_forward(p, {5, 20, 5}, {30, 60, 10}, 1, true, true, options, pool)};
+    std::vector<SweepResult> ranked {sweep(PriceView(p.data(), 200), {5, 20, 5}, {30, 60, 10}, 1, true, true, pool)};
+
+    // the first train window starts at day 0, so it is an ordinary sweep over the first 200 days
+    ASSERT_EQ(results.size(), 2u * 4u);
+
+    for (int k = 0; k < 2; k++) {
+        const SweepResult* best {nullptr};
+
+        for (const SweepResult& r : ranked) {
+            if (r.strategy == results[k].strategy) {
+                best = &r;
+                break;
+            }
+        }
+
+        ASSERT_NE(best, nullptr);
+        EXPECT_EQ(results[k].short_term, best->short_term);
+        EXPECT_EQ(results[k].long_term, best->long_term);
+        EXPECT_DOUBLE_EQ(results[k].train.profit, best->result.profit);
+    }
+}
+
+
+TEST(TestWalkForward, TestWindowTradesChosenPeriods) {
+    std::vector<double> p {wave()};
+    ThreadPool pool(2);
+    WalkForwardOptions options {200, 50, 0, false};
+
+    std::vector<FoldResult> results {walk_forward(p, {5, 20, 5}, {30, 60, 10}, 3, true, false, options, pool)};
+
+    ASSERT_EQ(results.size(), 4u);
+
+    for (const FoldResult& r : results) {
+        // the averages carry their history from before the window, only trades are limited to it
+        std::vector<double> short_avg {rolling_mean(p, r.short_term)};
+        std::vector<double> long_avg {rolling_mean(p, r.long_term)};
+        BacktestResult expected {backtest_signal(PriceView(p.data(), r.fold.test_end), r.fold.train_end, 3,
+                                                 [&](int day) { return short_avg[day] > long_avg[day]; })};
+
+        EXPECT_EQ(r.strategy, "SMA");
+        EXPECT_EQ(r.test.transactions, expected.transactions);
+        EXPECT_DOUBLE_EQ(r.test.profit, expected.profit);
+    }
+}